@@ -103,6 +103,13 @@ enum class AsmJSOption : uint8_t {
    */                                                                          \
   _(ConcurrentLargeFirst)                                                      \
                                                                                \
+  /*                                                                           \
+   * Delazify only the functions recorded as executed by previous runs of the  \
+   * same source, in the order in which they were first executed. See          \
+   * js::DelazificationProfile.                                                \
+   */                                                                          \
+  _(ConcurrentProfileGuided)                                                   \
+                                                                               \
   /*                                                                           \
    * Parse everything eagerly, from the first parse.                           \
    *                                                                           \
@@ -376,13 +383,15 @@ class JS_PUBLIC_API TransitiveCompileOptions {
   bool consumeDelazificationCache() const {
     return eagerDelazificationIsOneOf<
         DelazificationOption::ConcurrentDepthFirst,
-        DelazificationOption::ConcurrentLargeFirst>();
+        DelazificationOption::ConcurrentLargeFirst,
+        DelazificationOption::ConcurrentProfileGuided>();
   }
   bool populateDelazificationCache() const {
     return eagerDelazificationIsOneOf<
         DelazificationOption::CheckConcurrentWithOnDemand,
         DelazificationOption::ConcurrentDepthFirst,
-        DelazificationOption::ConcurrentLargeFirst>();
+        DelazificationOption::ConcurrentLargeFirst,
+        DelazificationOption::ConcurrentProfileGuided>();
   }
   bool waitForDelazificationCache() const {
     return eagerDelazificationIsOneOf<
@@ -890,6 +899,12 @@ class MOZ_STACK_CLASS JS_PUBLIC_API DecodeOptions final
 
     introducerFilename_ = options.introducerFilename();
   }
+
+  explicit DecodeOptions(const ReadOnlyDecodeOptions& options) {
+    copyPODOptionsFrom(options);
+
+    introducerFilename_ = options.introducerFilename();
+  }
 };
 
 class JS_PUBLIC_API OwningDecodeOptions final : public ReadOnlyDecodeOptions {
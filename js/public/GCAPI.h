@@ -524,6 +524,28 @@ typedef enum JSGCParamKey {
    */
   JSGC_STORE_BUFFER_ENTRIES = 58,
   JSGC_STORE_BUFFER_SCALING = 59,
+
+  /*
+   * Whether to limit nursery growth to the size of the largest CPU cache.
+   *
+   * When enabled the nursery will not grow beyond the size of the last level
+   * cache unless the fraction of the nursery promoted is above the target
+   * promotion rate. Minor GCs are much more expensive once the nursery no
+   * longer fits in cache.
+   *
+   * This has no effect if the cache size could not be determined.
+   *
+   * Default: true
+   */
+  JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED = 60,
+
+  /*
+   * Get the size of the largest CPU cache in KB, as reported by the operating
+   * system, or zero if this could not be determined.
+   *
+   * This parameter is read-only.
+   */
+  JSGC_LAST_LEVEL_CACHE_SIZE_KB = 61,
 } JSGCParamKey;
 
 /*
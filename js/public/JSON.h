@@ -10,6 +10,7 @@
 #ifndef js_JSON_h
 #define js_JSON_h
 
+#include <stddef.h>  // size_t
 #include <stdint.h>  // uint32_t
 
 #include "jstypes.h"  // JS_PUBLIC_API
@@ -190,6 +191,38 @@ extern JS_PUBLIC_API bool ParseJSONWithHandler(const char16_t* chars,
                                                uint32_t len,
                                                JSONParseHandler* handler);
 
+/**
+ * Performs the JSON.parse operation as specified by ECMAScript, on input which
+ * arrives in chunks, e.g. from the network.
+ *
+ * Each chunk is parsed as soon as it is passed to JSONStreamParserFeed, such
+ * that the resulting values are built while the rest of the input is still
+ * being received. Chunks can be split at any code unit; only a token cut off
+ * by the end of a chunk is buffered until the next one.
+ *
+ * The object returned by NewJSONStreamParser holds the state of the parse, and
+ * has to be kept alive by the caller. Once JSONStreamParserFeed or
+ * JSONStreamParserFinish fail, the parser must not be used anymore.
+ */
+extern JS_PUBLIC_API JSObject* NewJSONStreamParser(JSContext* cx);
+
+/**
+ * Parses the next |len| characters of the input. Syntax errors are thrown as
+ * soon as they are found, as with JSON.parse.
+ */
+extern JS_PUBLIC_API bool JSONStreamParserFeed(JSContext* cx,
+                                               Handle<JSObject*> parser,
+                                               const char16_t* chars,
+                                               size_t len);
+
+/**
+ * Ends the input, and stores the parsed value in |vp|. Throws a SyntaxError
+ * if the input isn't a complete JSON text.
+ */
+extern JS_PUBLIC_API bool JSONStreamParserFinish(JSContext* cx,
+                                                 Handle<JSObject*> parser,
+                                                 MutableHandle<Value> vp);
+
 }  // namespace JS
 
 #endif /* js_JSON_h */
@@ -503,6 +503,8 @@ struct RuntimeSizes {
   MACRO(_, MallocHeap, sharedImmutableStringsCache) \
   MACRO(_, MallocHeap, sharedIntlData)              \
   MACRO(_, MallocHeap, uncompressedSourceCache)     \
+  MACRO(_, MallocHeap, regExpBytecodeCache)         \
+  MACRO(_, MallocHeap, lifoChunkCache)              \
   MACRO(_, MallocHeap, scriptData)                  \
   MACRO(_, MallocHeap, wasmRuntime)                 \
   MACRO(_, Ignore, wasmGuardPages)                  \
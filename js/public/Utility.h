@@ -69,6 +69,8 @@ enum ThreadType {
   THREAD_TYPE_WORKER,                         // 12
   THREAD_TYPE_DELAZIFY,                       // 13
   THREAD_TYPE_DELAZIFY_FREE,                  // 14
+  THREAD_TYPE_STENCIL_DECODE,                 // 15
+  THREAD_TYPE_ARRAY_BUFFER_COPY,              // 16
   THREAD_TYPE_MAX  // Used to check shell function arguments
 };
 
@@ -29,6 +29,23 @@
  *   - Iterator objects remain valid even when entries are added or removed or
  *     the table is resized.
  *
+ * Entries are stored in insertion order in a data array, and iterators refer
+ * to entries by their index in this array. The hash table that indexes the
+ * data array has one of two layouts, depending on its size:
+ *
+ *   - Small tables use hash chains. Each bucket points to the most recently
+ *     added entry with that hash and entries point to the next entry in the
+ *     chain.
+ *
+ *   - Large tables use open addressing (see OrderedHashProbeTable below).
+ *     Following hash chains through a large data array is dominated by cache
+ *     misses, so instead a group of control bytes holding a few bits of each
+ *     entry's hash is compared at once and the data array is only accessed for
+ *     likely matches.
+ *
+ * The layout is determined by the number of hash buckets and changes when the
+ * table is rehashed. The data array and iteration order are the same for both.
+ *
  * Hash policies
  *
  * See the comment about "Hash policy" in HashTable.h for general features that
@@ -46,10 +63,15 @@
 
 #include "mozilla/HashFunctions.h"
 #include "mozilla/Likely.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/MemoryReporting.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
 #include <memory>
+#include <string.h>
 #include <tuple>
 #include <utility>
 
@@ -115,6 +137,224 @@ class OrderedHashTableObject : public NativeObject {
   static constexpr size_t offsetOfHashCodeScrambler() {
     return getFixedSlotOffset(HashCodeScramblerSlot);
   }
+
+  // Tables with at least this many hash buckets use OrderedHashProbeTable
+  // instead of hash chains. JIT code checks the hash shift to tell which
+  // layout is in use.
+  static constexpr uint32_t ProbedLayoutMinBucketsLog2 = 12;
+  static constexpr uint32_t ProbedLayoutMaxHashShift =
+      js::kHashNumberBits - ProbedLayoutMinBucketsLog2;
+};
+
+/*
+ * OrderedHashProbeTable is the hash table used by large ordered hash tables.
+ * It maps hash codes to indices into the data array using open addressing.
+ *
+ * Each slot has a control byte that is either Empty, Deleted or, for full
+ * slots, the low seven bits of the entry's hash code. Lookups compare a group
+ * of GroupWidth control bytes at a time (using SSE2 where available) and only
+ * compare keys for slots whose control byte matches. Probing stops at the
+ * first group containing an Empty slot. Groups are visited using triangular
+ * probing, which visits every group because the table size is a power of two.
+ *
+ * The memory for the table is part of the ordered hash table's buffer and is
+ * laid out as follows:
+ *
+ *   uint32_t usedSlots;   // The number of full or deleted slots.
+ *   uint32_t padding;
+ *   uint8_t control[slotCount + GroupWidth];
+ *
+ * The final GroupWidth control bytes duplicate the first ones so that groups
+ * starting near the end of the table can be loaded without wrapping around.
+ *
+ * The data array indices for the slots are not stored here. The chain words of
+ * data array entries are unused in the probed layout, so each one holds the
+ * indices for two consecutive slots. There are enough entries for this because
+ * the data capacity is more than half the slot count. The indices are stored in
+ * entries past the data length too, so the table must preserve them when it
+ * constructs or moves entries.
+ *
+ * This class does not own its memory.
+ */
+class OrderedHashProbeTable {
+ public:
+  static constexpr uint32_t GroupWidth = 16;
+  static constexpr uint8_t Empty = 0x80;
+  static constexpr uint8_t Deleted = 0xfe;
+
+  // The number of slots per hash bucket of the equivalent chained table. This
+  // keeps the maximum load factor at 2/3 (see FillFactor).
+  static constexpr uint32_t SlotsPerBucketLog2 = 2;
+
+  static constexpr uint32_t slotCountForHashShift(uint32_t hashShift) {
+    return uint32_t(1)
+           << (js::kHashNumberBits - hashShift + SlotsPerBucketLog2);
+  }
+
+  static constexpr size_t allocSize(uint32_t hashShift) {
+    return 2 * sizeof(uint32_t) + slotCountForHashShift(hashShift) + GroupWidth;
+  }
+
+  // The number of bytes used to store the indices for two slots in a data
+  // array entry.
+  static constexpr size_t IndexPairSize = 2 * sizeof(uint32_t);
+
+ private:
+  // A group of control bytes, and bit masks with bit |i| set if control byte
+  // |i| matches a condition.
+  class Group {
+#ifdef __SSE2__
+    __m128i bytes;
+
+   public:
+    explicit Group(const uint8_t* control)
+        : bytes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control))) {}
+
+    uint32_t match(uint8_t tag) const {
+      __m128i tags = _mm_set1_epi8(char(tag));
+      return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(tags, bytes)));
+    }
+    uint32_t matchEmptyOrDeleted() const {
+      // Empty and Deleted are the only control bytes with the top bit set.
+      return uint32_t(_mm_movemask_epi8(bytes));
+    }
+#else
+    uint8_t bytes[GroupWidth];
+
+   public:
+    explicit Group(const uint8_t* control) {
+      memcpy(bytes, control, GroupWidth);
+    }
+
+    uint32_t match(uint8_t tag) const {
+      uint32_t result = 0;
+      for (uint32_t i = 0; i < GroupWidth; i++) {
+        result |= uint32_t(bytes[i] == tag) << i;
+      }
+      return result;
+    }
+    uint32_t matchEmptyOrDeleted() const {
+      uint32_t result = 0;
+      for (uint32_t i = 0; i < GroupWidth; i++) {
+        result |= uint32_t(bytes[i] >> 7) << i;
+      }
+      return result;
+    }
+#endif
+    uint32_t matchEmpty() const { return match(Empty); }
+  };
+
+  uint32_t* const header;
+  uint8_t* const control;
+  uint8_t* const indexPairs;
+  const size_t indexPairStride;
+  const uint32_t mask;
+  const uint32_t slotShift;
+
+  uint32_t* indexAddress(uint32_t slot) const {
+    uint8_t* pair = indexPairs + size_t(slot >> 1) * indexPairStride;
+    return reinterpret_cast<uint32_t*>(pair) + (slot & 1);
+  }
+
+  static uint8_t tagFor(HashNumber hash) { return hash & 0x7f; }
+
+  void setControl(uint32_t slot, uint8_t value) {
+    control[slot] = value;
+    if (slot < GroupWidth) {
+      control[slotCount() + slot] = value;
+    }
+  }
+
+ public:
+  // |hashShift| is the hash shift of the ordered hash table. The table has
+  // 2^SlotsPerBucketLog2 slots for each of the buckets this implies.
+  //
+  // |indexPairs| points to the index pair storage of the first data array
+  // entry and |indexPairStride| is the size of a data array entry.
+  OrderedHashProbeTable(void* mem, uint32_t hashShift, void* indexPairs,
+                        size_t indexPairStride)
+      : header(static_cast<uint32_t*>(mem)),
+        control(reinterpret_cast<uint8_t*>(header + 2)),
+        indexPairs(static_cast<uint8_t*>(indexPairs)),
+        indexPairStride(indexPairStride),
+        mask(slotCountForHashShift(hashShift) - 1),
+        slotShift(hashShift - SlotsPerBucketLog2) {
+    MOZ_ASSERT(hashShift > SlotsPerBucketLog2);
+    MOZ_ASSERT(slotCount() >= GroupWidth);
+  }
+
+  uint32_t slotCount() const { return mask + 1; }
+  uint32_t usedSlots() const { return header[0]; }
+  uint32_t indexAt(uint32_t slot) const {
+    MOZ_ASSERT(control[slot] < Empty);
+    return *indexAddress(slot);
+  }
+
+  // Whether there's no room to insert another entry without rebuilding the
+  // table to remove deleted slots. Keeping the load below 7/8 bounds the
+  // length of probe sequences and guarantees they terminate.
+  bool isFull() const { return usedSlots() >= slotCount() - slotCount() / 8; }
+
+  void clear() {
+    header[0] = 0;
+    memset(control, Empty, slotCount() + GroupWidth);
+  }
+
+  // Find a full slot with a matching hash for which |matchIndex| returns true
+  // when passed the slot's data array index.
+  template <typename F>
+  MOZ_ALWAYS_INLINE bool find(HashNumber hash, F&& matchIndex,
+                              uint32_t* slotOut) const {
+    uint8_t tag = tagFor(hash);
+    uint32_t pos = (hash >> slotShift) & mask;
+    uint32_t stride = 0;
+    while (true) {
+      Group group(control + pos);
+      for (uint32_t bits = group.match(tag); bits; bits &= bits - 1) {
+        uint32_t slot = (pos + mozilla::CountTrailingZeroes32(bits)) & mask;
+        if (matchIndex(*indexAddress(slot))) {
+          *slotOut = slot;
+          return true;
+        }
+      }
+      if (group.matchEmpty()) {
+        return false;
+      }
+      stride += GroupWidth;
+      MOZ_ASSERT(stride <= slotCount(), "probe sequence must terminate");
+      pos = (pos + stride) & mask;
+    }
+  }
+
+  // Add a slot for the data array entry |index|, reusing a deleted slot if
+  // possible.
+  void insert(HashNumber hash, uint32_t index) {
+    MOZ_ASSERT(!isFull());
+    uint32_t pos = (hash >> slotShift) & mask;
+    uint32_t stride = 0;
+    while (true) {
+      uint32_t bits = Group(control + pos).matchEmptyOrDeleted();
+      if (bits) {
+        uint32_t slot = (pos + mozilla::CountTrailingZeroes32(bits)) & mask;
+        if (control[slot] == Empty) {
+          header[0]++;
+        }
+        setControl(slot, tagFor(hash));
+        *indexAddress(slot) = index;
+        return;
+      }
+      stride += GroupWidth;
+      MOZ_ASSERT(stride <= slotCount(), "probe sequence must terminate");
+      pos = (pos + stride) & mask;
+    }
+  }
+
+  // Remove a full slot. The slot is marked as deleted rather than empty so
+  // that probe sequences passing through it continue past it.
+  void erase(uint32_t slot) {
+    MOZ_ASSERT(control[slot] < Empty);
+    setControl(slot, Deleted);
+  }
 };
 
 }  // namespace detail
@@ -313,17 +553,22 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
   using UnbarrieredKey = typename RemoveBarrier<MutableKey>::Type;
   using Lookup = typename Ops::Lookup;
   using HashCodeScrambler = mozilla::HashCodeScrambler;
+  using ProbeTable = OrderedHashProbeTable;
   static constexpr size_t SlotCount = OrderedHashTableObject::SlotCount;
 
   // Note: use alignas(8) to simplify JIT code generation because
   // alignof(JS::Value) can be either 4 or 8 on 32-bit platforms.
   struct alignas(8) Data {
     T element;
-    Data* chain;
+    union {
+      Data* chain;  // Only used by the chained layout.
+      uint32_t probeIndices[2];  // Only used by the probed layout.
+    };
 
     Data(const T& e, Data* c) : element(e), chain(c) {}
     Data(T&& e, Data* c) : element(std::move(e)), chain(c) {}
   };
+  static_assert(sizeof(Data::probeIndices) == ProbeTable::IndexPairSize);
 
  private:
   using Slots = OrderedHashTableObject::Slots;
@@ -337,16 +582,26 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     return obj->getReservedSlot(Slots::DataSlot).toPrivate() != nullptr;
   }
 
-  // Hash table. Has hashBuckets() elements.
-  // Note: a single malloc buffer is used for the data and hashTable arrays and
+  // Hash table. For the chained layout this has hashBuckets() elements. For
+  // the probed layout it is an OrderedHashProbeTable.
+  // Note: a single malloc buffer is used for the data array, the hash table and
   // the HashCodeScrambler. The pointer in DataSlot points to the start of this
   // buffer.
   Data** getHashTable() const {
     MOZ_ASSERT(hasAllocatedBuffer());
+    MOZ_ASSERT(!isProbed());
     Value v = obj->getReservedSlot(Slots::HashTableSlot);
     return static_cast<Data**>(v.toPrivate());
   }
-  void setHashTable(Data** table) {
+  ProbeTable getProbeTable() const {
+    MOZ_ASSERT(isProbed());
+    MOZ_ASSERT(ProbeTable::slotCountForHashShift(getHashShift()) / 2 <=
+               getDataCapacity());
+    Value v = obj->getReservedSlot(Slots::HashTableSlot);
+    return ProbeTable(v.toPrivate(), getHashShift(),
+                      getData()->probeIndices, sizeof(Data));
+  }
+  void setHashTable(void* table) {
     obj->setReservedSlotPrivateUnbarriered(Slots::HashTableSlot, table);
   }
 
@@ -486,6 +741,13 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
   static constexpr uint32_t MaxDataCapacity =
       numHashBucketsToDataCapacity(MaxHashBuckets);  // 44739242
 
+  // Whether a table with this hash shift uses OrderedHashProbeTable rather
+  // than hash chains.
+  static constexpr bool usesProbedLayout(uint32_t hashShift) {
+    return hashShift <= OrderedHashTableObject::ProbedLayoutMaxHashShift;
+  }
+  bool isProbed() const { return usesProbedLayout(getHashShift()); }
+
   template <typename F>
   void forEachIterator(F&& f) {
     TableIteratorObject* next;
@@ -503,47 +765,56 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     return !obj->getReservedSlot(Slots::DataSlot).isUndefined();
   }
 
-  static constexpr size_t calcAllocSize(size_t dataCapacity, size_t buckets) {
+  static constexpr size_t calcHashTableSize(uint32_t hashShift) {
+    return usesProbedLayout(hashShift)
+               ? ProbeTable::allocSize(hashShift)
+               : hashShiftToNumHashBuckets(hashShift) * sizeof(Data*);
+  }
+
+  static constexpr size_t calcAllocSize(size_t dataCapacity,
+                                        uint32_t hashShift) {
     return dataCapacity * sizeof(Data) + sizeof(HashCodeScrambler) +
-           buckets * sizeof(Data*);
+           calcHashTableSize(hashShift);
   }
 
   // Allocate a single buffer that stores the data array followed by the hash
-  // code scrambler and the hash table entries.
-  using AllocationResult =
-      std::tuple<Data*, Data**, HashCodeScrambler*, size_t>;
+  // code scrambler and the hash table.
+  using AllocationResult = std::tuple<Data*, void*, HashCodeScrambler*, size_t>;
   AllocationResult allocateBuffer(JSContext* cx, uint32_t dataCapacity,
-                                  uint32_t buckets) {
+                                  uint32_t hashShift) {
     MOZ_ASSERT(dataCapacity <= MaxDataCapacity);
-    MOZ_ASSERT(buckets <= MaxHashBuckets);
+    MOZ_ASSERT(hashShift >= MinHashShift);
 
     // Ensure the maximum buffer size doesn't exceed INT32_MAX. Don't change
     // this without auditing the buffer allocation code!
-    static_assert(calcAllocSize(MaxDataCapacity, MaxHashBuckets) <= INT32_MAX);
+    static_assert(calcAllocSize(MaxDataCapacity, MinHashShift) <= INT32_MAX);
 
-    size_t numBytes = calcAllocSize(dataCapacity, buckets);
+    size_t numBytes = calcAllocSize(dataCapacity, hashShift);
 
     void* buf = obj->allocateCellBuffer(cx, numBytes);
     if (!buf) {
       return {};
     }
 
-    return getBufferParts(buf, numBytes, dataCapacity, buckets);
+    return getBufferParts(buf, numBytes, dataCapacity, hashShift);
   }
 
   static AllocationResult getBufferParts(void* buf, size_t numBytes,
                                          uint32_t dataCapacity,
-                                         uint32_t buckets) {
+                                         uint32_t hashShift) {
     static_assert(alignof(Data) % alignof(HashCodeScrambler) == 0,
                   "Hash code scrambler must be aligned properly");
     static_assert(alignof(HashCodeScrambler) % alignof(Data*) == 0,
                   "Hash table entries must be aligned properly");
+    static_assert(alignof(HashCodeScrambler) % alignof(uint32_t) == 0,
+                  "Probe table must be aligned properly");
 
     auto* data = static_cast<Data*>(buf);
     auto* hcs = reinterpret_cast<HashCodeScrambler*>(data + dataCapacity);
-    auto** table = reinterpret_cast<Data**>(hcs + 1);
+    void* table = hcs + 1;
 
-    MOZ_ASSERT(uintptr_t(table + buckets) == uintptr_t(buf) + numBytes);
+    MOZ_ASSERT(uintptr_t(table) + calcHashTableSize(hashShift) ==
+               uintptr_t(buf) + numBytes);
 
     return {data, table, hcs, numBytes};
   }
@@ -556,15 +827,17 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     constexpr uint32_t buckets = InitialBuckets;
     constexpr uint32_t capacity = uint32_t(buckets * FillFactor);
 
+    static_assert(!usesProbedLayout(InitialHashShift));
     auto [dataAlloc, tableAlloc, hcsAlloc, numBytes] =
-        allocateBuffer(cx, capacity, buckets);
+        allocateBuffer(cx, capacity, InitialHashShift);
     if (!dataAlloc) {
       return false;
     }
 
     *hcsAlloc = cx->realm()->randomHashCodeScrambler();
 
-    std::uninitialized_fill_n(tableAlloc, buckets, nullptr);
+    std::uninitialized_fill_n(static_cast<Data**>(tableAlloc), buckets,
+                              nullptr);
 
     setHashTable(tableAlloc);
     setData(dataAlloc);
@@ -577,6 +850,11 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
 
   void updateHashTableForRekey(Data* entry, HashNumber oldHash,
                                HashNumber newHash) {
+    if (isProbed()) {
+      updateProbeTableForRekey(entry - getData(), oldHash, newHash);
+      return;
+    }
+
     uint32_t hashShift = getHashShift();
     oldHash >>= hashShift;
     newHash >>= hashShift;
@@ -609,6 +887,42 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     *ep = entry;
   }
 
+  void updateProbeTableForRekey(uint32_t index, HashNumber oldHash,
+                                HashNumber newHash) {
+    if (oldHash == newHash) {
+      return;
+    }
+
+    // Moving an entry leaves a deleted slot behind. If the table has filled
+    // up, rebuild it from the current keys instead, which includes the new
+    // key for this entry.
+    ProbeTable table = getProbeTable();
+    if (table.isFull()) {
+      rebuildProbeTable();
+      return;
+    }
+
+    uint32_t slot;
+    MOZ_ALWAYS_TRUE(table.find(
+        oldHash, [index](uint32_t i) { return i == index; }, &slot));
+    table.erase(slot);
+    table.insert(newHash, index);
+  }
+
+  // Recreate the probe table from the keys in the data array, discarding
+  // deleted slots.
+  void rebuildProbeTable() {
+    ProbeTable table = getProbeTable();
+    table.clear();
+
+    const Data* data = getData();
+    for (uint32_t i = 0, len = getDataLength(); i < len; i++) {
+      if (!Ops::isEmpty(Ops::getKey(data[i].element))) {
+        table.insert(prepareHash(Ops::getKey(data[i].element)), i);
+      }
+    }
+  }
+
  public:
   explicit OrderedHashTableImpl(OrderedHashTableObject* obj) : obj(obj) {}
 
@@ -632,9 +946,9 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
 
     Data* oldData = getData();
     uint32_t dataCapacity = getDataCapacity();
-    uint32_t buckets = hashBuckets();
+    uint32_t hashShift = getHashShift();
 
-    size_t numBytes = calcAllocSize(dataCapacity, buckets);
+    size_t numBytes = calcAllocSize(dataCapacity, hashShift);
 
     void* buf = oldData;
     Nursery::WasBufferMoved result =
@@ -644,12 +958,21 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     }
 
     // The buffer was moved in memory. Update reserved slots and fix up the
-    // |Data*| pointers for the hash table chains.
+    // |Data*| pointers for the hash table chains. The probed layout stores
+    // indices so needs no fixup.
     // TODO(bug 1931492): consider storing indices instead of pointers to
     // simplify this.
 
-    auto [data, table, hcs, numBytesUnused] =
-        getBufferParts(buf, numBytes, dataCapacity, buckets);
+    auto [data, tableAlloc, hcs, numBytesUnused] =
+        getBufferParts(buf, numBytes, dataCapacity, hashShift);
+
+    setData(data);
+    setHashTable(tableAlloc);
+    setHashCodeScrambler(hcs);
+
+    if (usesProbedLayout(hashShift)) {
+      return;
+    }
 
     auto entryIndex = [=](const Data* entry) {
       MOZ_ASSERT(entry >= oldData);
@@ -662,15 +985,12 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
         data[i].chain = data + entryIndex(chain);
       }
     }
-    for (uint32_t i = 0; i < buckets; i++) {
+    Data** table = static_cast<Data**>(tableAlloc);
+    for (uint32_t i = 0, buckets = hashBuckets(); i < buckets; i++) {
       if (const Data* chain = table[i]) {
         table[i] = data + entryIndex(chain);
       }
     }
-
-    setData(data);
-    setHashTable(table);
-    setHashCodeScrambler(hcs);
   }
 
   size_t sizeOfExcludingObject(mozilla::MallocSizeOf mallocSizeOf) const {
@@ -722,8 +1042,7 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
       }
       h = prepareHash(Ops::getKey(element));
     }
-    auto [entry, chain] = addEntry(h);
-    new (entry) Data(std::forward<ElementInput>(element), chain);
+    addEntry(h, std::forward<ElementInput>(element));
     return true;
   }
 
@@ -752,8 +1071,7 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
       }
       h = prepareHash(Ops::getKey(element));
     }
-    auto [entry, chain] = addEntry(h);
-    new (entry) Data(std::forward<ElementInput>(element), chain);
+    Data* entry = addEntry(h, std::forward<ElementInput>(element));
     return &entry->element;
   }
 
@@ -767,7 +1085,11 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     // benefit.
 
     // If a matching entry exists, empty it.
-    Data* e = lookup(l);
+    if (getLiveCount() == 0) {
+      return false;
+    }
+    HashNumber h = prepareHash(l);
+    Data* e = lookup(l, h);
     if (e == nullptr) {
       return false;
     }
@@ -779,8 +1101,16 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     setLiveCount(liveCount);
     Ops::makeEmpty(&e->element);
 
-    // Update active iterators.
     uint32_t pos = e - getData();
+    if (isProbed()) {
+      ProbeTable table = getProbeTable();
+      uint32_t slot;
+      MOZ_ALWAYS_TRUE(
+          table.find(h, [pos](uint32_t i) { return i == pos; }, &slot));
+      table.erase(slot);
+    }
+
+    // Update active iterators.
     forEachIterator(
         [this, pos](auto* iter) { IterOps::onRemove(obj, iter, pos); });
 
@@ -811,7 +1141,11 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
       setLiveCount(0);
 
       size_t buckets = hashBuckets();
-      std::fill_n(getHashTable(), buckets, nullptr);
+      if (isProbed()) {
+        getProbeTable().clear();
+      } else {
+        std::fill_n(getHashTable(), buckets, nullptr);
+      }
 
       forEachIterator([](auto* iter) { IterOps::onClear(iter); });
 
@@ -1038,6 +1372,16 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     updateHashTableForRekey(entry, currentHash, newHash);
   }
 
+  // Like get(), for callers that have already computed the scrambled hash
+  // code for |l|. This is used by JIT code for tables that use the probed
+  // layout.
+  T* getWithHash(const Lookup& l, HashNumber h) {
+    MOZ_ASSERT(getLiveCount() > 0);
+    MOZ_ASSERT(h == prepareHash(l));
+    Data* e = lookup(l, h);
+    return e ? &e->element : nullptr;
+  }
+
   static constexpr size_t offsetOfDataElement() {
     static_assert(offsetof(Data, element) == 0,
                   "TableIteratorLoadEntry and TableIteratorAdvance depend on "
@@ -1079,19 +1423,23 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
   }
 
   void freeData(JSContext* cx, Data* data, uint32_t length, uint32_t capacity,
-                uint32_t hashBuckets) {
+                uint32_t hashShift) {
     MOZ_ASSERT(data);
     MOZ_ASSERT(capacity > 0);
 
     destroyData(data, length);
 
-    size_t numBytes = calcAllocSize(capacity, hashBuckets);
+    size_t numBytes = calcAllocSize(capacity, hashShift);
 
     obj->freeCellBuffer(cx, data, numBytes);
   }
 
   Data* lookup(const Lookup& l, HashNumber h) const {
     MOZ_ASSERT(hasAllocatedBuffer());
+    if (isProbed()) {
+      return probedLookup(l, h);
+    }
+
     Data** hashTable = getHashTable();
     uint32_t hashShift = getHashShift();
     for (Data* e = hashTable[h >> hashShift]; e; e = e->chain) {
@@ -1102,6 +1450,19 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     return nullptr;
   }
 
+  Data* probedLookup(const Lookup& l, HashNumber h) const {
+    Data* data = getData();
+    ProbeTable table = getProbeTable();
+    uint32_t slot;
+    auto matchIndex = [data, &l](uint32_t index) {
+      return Ops::match(Ops::getKey(data[index].element), l);
+    };
+    if (!table.find(h, matchIndex, &slot)) {
+      return nullptr;
+    }
+    return &data[table.indexAt(slot)];
+  }
+
   Data* lookup(const Lookup& l) const {
     // Note: checking |getLiveCount() > 0| is a minor performance optimization
     // but this check is also required for correctness because it implies
@@ -1112,20 +1473,39 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     return lookup(l, prepareHash(l));
   }
 
-  std::tuple<Data*, Data*> addEntry(HashNumber hash) {
+  template <typename ElementInput>
+  Data* addEntry(HashNumber hash, ElementInput&& element) {
     uint32_t dataLength = getDataLength();
     MOZ_ASSERT(dataLength < getDataCapacity());
 
     Data* entry = &getData()[dataLength];
+    if (isProbed()) {
+      // Rekeying entries can fill the table with deleted slots. Rebuild it
+      // before the new entry is added to the data array.
+      ProbeTable table = getProbeTable();
+      if (table.isFull()) {
+        rebuildProbeTable();
+      }
+      table.insert(hash, dataLength);
+
+      // The entry's storage holds probe table indices which must survive its
+      // construction.
+      uint8_t* indices =
+          reinterpret_cast<uint8_t*>(entry) + offsetof(Data, probeIndices);
+      uint8_t saved[ProbeTable::IndexPairSize];
+      memcpy(saved, indices, sizeof(saved));
+      new (entry) Data(std::forward<ElementInput>(element), nullptr);
+      memcpy(indices, saved, sizeof(saved));
+    } else {
+      Data** hashTable = getHashTable();
+      hash >>= getHashShift();
+      new (entry) Data(std::forward<ElementInput>(element), hashTable[hash]);
+      hashTable[hash] = entry;
+    }
+
     setDataLength(dataLength + 1);
     setLiveCount(getLiveCount() + 1);
-
-    Data** hashTable = getHashTable();
-    hash >>= getHashShift();
-    Data* chain = hashTable[hash];
-    hashTable[hash] = entry;
-
-    return std::make_tuple(entry, chain);
+    return entry;
   }
 
   /* This is called after rehashing the table. */
@@ -1138,21 +1518,14 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
 
   /* Compact the entries in the data array and rehash them. */
   void rehashInPlace() {
-    Data** hashTable = getHashTable();
-    std::fill_n(hashTable, hashBuckets(), nullptr);
-
     Data* const data = getData();
-    uint32_t hashShift = getHashShift();
     Data* wp = data;
     Data* end = data + getDataLength();
     for (Data* rp = data; rp != end; rp++) {
       if (!Ops::isEmpty(Ops::getKey(rp->element))) {
-        HashNumber h = prepareHash(Ops::getKey(rp->element)) >> hashShift;
         if (rp != wp) {
           wp->element = std::move(rp->element);
         }
-        wp->chain = hashTable[h];
-        hashTable[h] = wp;
         wp++;
       }
     }
@@ -1163,9 +1536,38 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
       wp++;
     }
     setDataLength(getLiveCount());
+    fillHashTable();
     compacted();
   }
 
+  // Recreate the hash table from the entries in the data array, which must not
+  // contain removed entries. For the probed layout this must be called after
+  // the entries have been moved into place because it stores indices in the
+  // data array.
+  void fillHashTable() {
+    Data* const data = getData();
+    uint32_t length = getDataLength();
+    MOZ_ASSERT(length == getLiveCount());
+
+    if (isProbed()) {
+      ProbeTable table = getProbeTable();
+      table.clear();
+      for (uint32_t i = 0; i < length; i++) {
+        table.insert(prepareHash(Ops::getKey(data[i].element)), i);
+      }
+      return;
+    }
+
+    Data** hashTable = getHashTable();
+    uint32_t hashShift = getHashShift();
+    std::fill_n(hashTable, hashBuckets(), nullptr);
+    for (uint32_t i = 0; i < length; i++) {
+      HashNumber h = prepareHash(Ops::getKey(data[i].element)) >> hashShift;
+      data[i].chain = hashTable[h];
+      hashTable[h] = &data[i];
+    }
+  }
+
   [[nodiscard]] bool rehashOnFull(JSContext* cx) {
     MOZ_ASSERT(getDataLength() == getDataCapacity());
 
@@ -1201,39 +1603,40 @@ class MOZ_STACK_CLASS OrderedHashTableImpl {
     uint32_t newCapacity = numHashBucketsToDataCapacity(newHashBuckets);
 
     auto [newData, newHashTable, newHcs, numBytes] =
-        allocateBuffer(cx, newCapacity, newHashBuckets);
+        allocateBuffer(cx, newCapacity, newHashShift);
     if (!newData) {
       return false;
     }
 
     *newHcs = *getHashCodeScrambler();
 
-    std::uninitialized_fill_n(newHashTable, newHashBuckets, nullptr);
-
     Data* const oldData = getData();
     const uint32_t oldDataLength = getDataLength();
+    const uint32_t oldCapacity = getDataCapacity();
+    const uint32_t oldHashShift = getHashShift();
 
     Data* wp = newData;
     Data* end = oldData + oldDataLength;
     for (Data* p = oldData; p != end; p++) {
       if (!Ops::isEmpty(Ops::getKey(p->element))) {
-        HashNumber h = prepareHash(Ops::getKey(p->element)) >> newHashShift;
-        new (wp) Data(std::move(p->element), newHashTable[h]);
-        newHashTable[h] = wp;
+        new (wp) Data(std::move(p->element), nullptr);
         wp++;
       }
     }
     MOZ_ASSERT(wp == newData + getLiveCount());
 
-    freeData(cx, oldData, oldDataLength, getDataCapacity(), hashBuckets());
+    freeData(cx, oldData, oldDataLength, oldCapacity, oldHashShift);
 
+    // Switch to the new buffer, which may use a different layout, and add the
+    // entries to its hash table.
     setHashTable(newHashTable);
+    setHashShift(newHashShift);
     setData(newData);
     setDataLength(getLiveCount());
     setDataCapacity(newCapacity);
-    setHashShift(newHashShift);
     setHashCodeScrambler(newHcs);
     MOZ_ASSERT(hashBuckets() == newHashBuckets);
+    fillHashTable();
 
     compacted();
     return true;
@@ -1331,6 +1734,9 @@ class MOZ_STACK_CLASS OrderedHashMapImpl {
   }
 #endif
   Entry* get(const Lookup& key) { return impl.get(key); }
+  Entry* getWithHash(const Lookup& key, HashNumber hash) {
+    return impl.getWithHash(key, hash);
+  }
   bool remove(JSContext* cx, const Lookup& key) { return impl.remove(cx, key); }
   void clear(JSContext* cx) { impl.clear(cx); }
 
@@ -1431,6 +1837,9 @@ class MOZ_STACK_CLASS OrderedHashSetImpl {
   void initSlots() { impl.initSlots(); }
   uint32_t count() const { return impl.count(); }
   bool has(const Lookup& value) const { return impl.has(value); }
+  T* getWithHash(const Lookup& value, HashNumber hash) {
+    return impl.getWithHash(value, hash);
+  }
   template <typename F>
   [[nodiscard]] bool forEachEntry(F&& f) const {
     return impl.forEachEntry(f);
@@ -2027,6 +2027,9 @@ static int BoyerMooreHorspool(const TextChar* text, uint32_t textLen,
   return -1;
 }
 
+// The first and last characters of a candidate match are found with
+// SIMD::memchrSpaced8/16, so InnerMatch only compares the characters between
+// them.
 template <typename TextChar, typename PatChar>
 struct MemCmp {
   using Extent = uint32_t;
@@ -2046,7 +2049,7 @@ struct ManualCmp {
   using Extent = const PatChar*;
   static MOZ_ALWAYS_INLINE Extent computeExtent(const PatChar* pat,
                                                 uint32_t patLen) {
-    return pat + patLen;
+    return pat + patLen - 1;
   }
   static MOZ_ALWAYS_INLINE bool match(const PatChar* p, const TextChar* t,
                                       Extent extent) {
@@ -2069,25 +2072,24 @@ static int Matcher(const TextChar* text, uint32_t textlen, const PatChar* pat,
 
   uint32_t i = 0;
   uint32_t n = textlen - patlen + 1;
+  uint32_t last = patlen - 1;
 
   while (i < n) {
     const TextChar* pos;
 
-    // This is a bit awkward. Consider the case where we're searching "abcdef"
-    // for "def". n will be 4, because we know in advance that the last place we
-    // can *start* a successful search will be at 'd'. However, if we just use n
-    // - i, then our first search will be looking through "abcd" for "de",
-    // because our memchr2xN functions search for two characters at a time. So
-    // we just have to compensate by adding 1. This will never exceed textlen
-    // because we know patlen is at least two.
-    size_t searchLen = n - i + 1;
+    // Look for a position where both the first and the last character of the
+    // pattern match. These are much less correlated than two adjacent
+    // characters, so there are fewer false candidates to compare in full.
+    // Only the n - i possible start positions are searched; the last
+    // character of the final candidate is text[textlen - 1].
     if (sizeof(TextChar) == 1) {
-      MOZ_ASSERT(pat[0] <= 0xff);
-      pos = (TextChar*)SIMD::memchr2x8((char*)text + i, pat[0], pat[1],
-                                       searchLen);
+      MOZ_ASSERT(pat[0] <= 0xff && pat[last] <= 0xff);
+      pos = (TextChar*)SIMD::memchrSpaced8((char*)text + i, pat[0], pat[last],
+                                           last, n - i);
     } else {
-      pos = (TextChar*)SIMD::memchr2x16((char16_t*)(text + i), char16_t(pat[0]),
-                                        char16_t(pat[1]), searchLen);
+      pos = (TextChar*)SIMD::memchrSpaced16((char16_t*)(text + i),
+                                            char16_t(pat[0]),
+                                            char16_t(pat[last]), last, n - i);
     }
 
     if (pos == nullptr) {
@@ -2095,9 +2097,7 @@ static int Matcher(const TextChar* text, uint32_t textlen, const PatChar* pat,
     }
 
     i = static_cast<uint32_t>(pos - text);
-    const uint32_t inlineLookaheadChars = 2;
-    if (InnerMatch::match(pat + inlineLookaheadChars,
-                          text + i + inlineLookaheadChars, extent)) {
+    if (InnerMatch::match(pat + 1, text + i + 1, extent)) {
       return i;
     }
 
@@ -2137,10 +2137,11 @@ static MOZ_ALWAYS_INLINE int StringMatch(const TextChar* text, uint32_t textLen,
     return pos - text;
   }
 
-  // We use a fast two-character-wide search in Matcher below, so we need to
-  // validate that pat[1] isn't outside the latin1 range up front if the
-  // sizes are different.
-  if (sizeof(TextChar) == 1 && sizeof(PatChar) > 1 && pat[1] > 0xff) {
+  // Matcher below searches for the first and last characters with a byte-wide
+  // search, so we need to validate that pat[patLen - 1] isn't outside the
+  // latin1 range up front if the sizes are different.
+  if (sizeof(TextChar) == 1 && sizeof(PatChar) > 1 &&
+      pat[patLen - 1] > 0xff) {
     return -1;
   }
 
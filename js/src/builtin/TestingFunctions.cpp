@@ -55,6 +55,7 @@
 #include "builtin/TestingUtility.h"  // js::ParseCompileOptions, js::ParseDebugMetadata
 #include "builtin/WeakMapObject.h"
 #include "ds/IdValuePair.h"               // js::IdValuePair
+#include "ds/LifoAlloc.h"                 // js::GetLifoChunkCacheStats
 #include "frontend/CompilationStencil.h"  // frontend::CompilationStencil
 #include "frontend/FrontendContext.h"     // AutoReportFrontendContext
 #include "gc/GC.h"
@@ -881,6 +882,35 @@ static bool FinishBackgroundFree(JSContext* cx, unsigned argc, Value* vp) {
   return true;
 }
 
+static bool LifoChunkCacheStats(JSContext* cx, unsigned argc, Value* vp) {
+  CallArgs args = CallArgsFromVp(argc, vp);
+
+  RootedObject result(cx, JS_NewPlainObject(cx));
+  if (!result) {
+    return false;
+  }
+
+  js::LifoChunkCacheStats stats = js::GetLifoChunkCacheStats();
+
+  RootedValue val(cx, NumberValue(double(stats.hits)));
+  if (!JS_DefineProperty(cx, result, "hits", val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  val = NumberValue(double(stats.misses));
+  if (!JS_DefineProperty(cx, result, "misses", val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  val = NumberValue(double(stats.cachedBytes));
+  if (!JS_DefineProperty(cx, result, "cachedBytes", val, JSPROP_ENUMERATE)) {
+    return false;
+  }
+
+  args.rval().setObject(*result);
+  return true;
+}
+
 static bool RelazifyFunctions(JSContext* cx, unsigned argc, Value* vp) {
   // Relazifying functions on GC is usually only done for compartments that are
   // not active. To aid fuzzing, this testing function allows us to relazify
@@ -10014,6 +10044,11 @@ static const JSFunctionSpecWithHelp TestingFunctions[] = {
 "finishBackgroundFree()",
 "  Wait for the GC's background free task to finish.\n"),
 
+    JS_FN_HELP("lifoChunkCacheStats", ::LifoChunkCacheStats, 0, 0,
+"lifoChunkCacheStats()",
+"  Return an object with the number of hits and misses of the process-wide\n"
+"  cache of LifoAlloc chunks, and the number of bytes it currently holds."),
+
     JS_FN_HELP("hasDisassembler", HasDisassembler, 0, 0,
 "hasDisassembler()",
 "  Return true if a disassembler is present (for disnative and wasmDis)."),
@@ -6,29 +6,251 @@
 
 #include "ds/LifoAlloc.h"
 
+#include "mozilla/Array.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/Likely.h"
 #include "mozilla/MathAlgorithms.h"
+#include "mozilla/ThreadLocal.h"
 
 #include <algorithm>
 
 #ifdef LIFO_CHUNK_PROTECT
 #  include "gc/Memory.h"
 #endif
+#include "threading/LockGuard.h"
+#include "threading/Mutex.h"
+#include "vm/MutexIDs.h"
 
 using namespace js;
 
 namespace js {
 namespace detail {
 
+// Process-wide cache of the memory of freed BumpChunks, see the Chunk cache
+// section in LifoAlloc.h.
+class LifoChunkCache {
+  // Chunks of 1 KB to 1 MB are cached, one size class per power of two.
+  static constexpr size_t MinChunkSizeLog2 = 10;
+  static constexpr size_t MaxChunkSizeLog2 = 20;
+  static constexpr size_t NumSizeClasses =
+      MaxChunkSizeLog2 - MinChunkSizeLog2 + 1;
+
+  // Chunks are only reused within the malloc arena they were allocated in.
+  // Only the two arenas used by LifoAllocs in practice are cached:
+  // MallocArena and BackgroundMallocArena.
+  static constexpr size_t NumArenas = 2;
+  static constexpr size_t NumBuckets = NumArenas * NumSizeClasses;
+
+  static constexpr size_t NumShards = 8;
+  static constexpr size_t MaxChunksPerBucket = 8;
+  static constexpr size_t MaxBytesPerShard = 2 * 1024 * 1024;
+
+  // Cached chunks of one size class and one arena.
+  struct Bucket {
+    mozilla::Array<void*, MaxChunksPerBucket> chunks;
+    size_t count = 0;
+  };
+
+  struct Shard {
+    Mutex lock{mutexid::LifoChunkCache};
+    mozilla::Array<Bucket, NumBuckets> buckets;
+    size_t bytes = 0;
+
+    void* take(size_t bucket, size_t size);
+    void purge();
+  };
+
+  mozilla::Array<Shard, NumShards> shards_;
+
+  mozilla::Atomic<uint64_t, mozilla::Relaxed> hits_;
+  mozilla::Atomic<uint64_t, mozilla::Relaxed> misses_;
+
+  // Threads are assigned shards round-robin the first time they use the
+  // cache. The shard index is stored plus one, so that zero means unassigned.
+  static MOZ_THREAD_LOCAL(uint32_t) threadShard;
+  static mozilla::Atomic<uint32_t, mozilla::Relaxed> nextShard;
+
+  static bool getBucket(size_t size, arena_id_t arena, size_t* bucket);
+  static size_t currentShard();
+
+ public:
+  static bool initThreadShard() { return threadShard.init(); }
+
+  ~LifoChunkCache() { purge(); }
+
+  // Return cached memory for a chunk of |size| bytes allocated in |arena|, or
+  // nullptr.
+  void* get(size_t size, arena_id_t arena);
+
+  // Take ownership of the memory of a freed chunk allocated in |arena|.
+  // Returns false if the chunk is not cacheable or the cache is full.
+  bool put(void* mem, size_t size, arena_id_t arena);
+
+  void purge();
+  LifoChunkCacheStats stats();
+
+  size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf);
+};
+
+MOZ_THREAD_LOCAL(uint32_t) LifoChunkCache::threadShard;
+mozilla::Atomic<uint32_t, mozilla::Relaxed> LifoChunkCache::nextShard;
+
+static LifoChunkCache* ChunkCache = nullptr;
+
+/* static */
+bool LifoChunkCache::getBucket(size_t size, arena_id_t arena,
+                               size_t* bucket) {
+  if (!mozilla::IsPowerOfTwo(size)) {
+    return false;
+  }
+  size_t log2 = mozilla::FloorLog2(size);
+  if (log2 < MinChunkSizeLog2 || log2 > MaxChunkSizeLog2) {
+    return false;
+  }
+
+  // Without jemalloc all the arenas are the same, in which case every chunk
+  // goes to the MallocArena buckets.
+  size_t arenaIndex;
+  if (arena == MallocArena) {
+    arenaIndex = 0;
+  } else if (arena == BackgroundMallocArena) {
+    arenaIndex = 1;
+  } else {
+    return false;
+  }
+
+  *bucket = arenaIndex * NumSizeClasses + (log2 - MinChunkSizeLog2);
+  return true;
+}
+
+/* static */
+size_t LifoChunkCache::currentShard() {
+  uint32_t shard = threadShard.get();
+  if (!shard) {
+    shard = nextShard++ % NumShards + 1;
+    threadShard.set(shard);
+  }
+  return shard - 1;
+}
+
+void* LifoChunkCache::Shard::take(size_t bucket, size_t size) {
+  Bucket& cls = buckets[bucket];
+  if (!cls.count) {
+    return nullptr;
+  }
+  bytes -= size;
+  return cls.chunks[--cls.count];
+}
+
+void* LifoChunkCache::get(size_t size, arena_id_t arena) {
+  size_t bucket;
+  if (!getBucket(size, arena, &bucket)) {
+    return nullptr;
+  }
+
+  // Look in this thread's shard first, then in any other shard which is not
+  // in use.
+  size_t first = currentShard();
+  void* mem;
+  {
+    LockGuard<Mutex> guard(shards_[first].lock);
+    mem = shards_[first].take(bucket, size);
+  }
+  for (size_t i = 1; !mem && i < NumShards; i++) {
+    Shard& shard = shards_[(first + i) % NumShards];
+    if (shard.lock.tryLock()) {
+      mem = shard.take(bucket, size);
+      shard.lock.unlock();
+    }
+  }
+
+  if (!mem) {
+    misses_++;
+    return nullptr;
+  }
+
+  hits_++;
+  MOZ_MAKE_MEM_UNDEFINED(mem, size);
+  return mem;
+}
+
+bool LifoChunkCache::put(void* mem, size_t size, arena_id_t arena) {
+  size_t bucket;
+  if (!getBucket(size, arena, &bucket)) {
+    return false;
+  }
+
+  Shard& shard = shards_[currentShard()];
+  LockGuard<Mutex> guard(shard.lock);
+  Bucket& cls = shard.buckets[bucket];
+  if (cls.count == MaxChunksPerBucket ||
+      shard.bytes + size > MaxBytesPerShard) {
+    return false;
+  }
+
+  MOZ_MAKE_MEM_NOACCESS(mem, size);
+  cls.chunks[cls.count++] = mem;
+  shard.bytes += size;
+  return true;
+}
+
+void LifoChunkCache::Shard::purge() {
+  LockGuard<Mutex> guard(lock);
+  for (size_t i = 0; i < NumBuckets; i++) {
+    Bucket& cls = buckets[i];
+    size_t size = size_t(1) << (MinChunkSizeLog2 + i % NumSizeClasses);
+    while (cls.count) {
+      void* mem = cls.chunks[--cls.count];
+      MOZ_MAKE_MEM_UNDEFINED(mem, size);
+      js_free(mem);
+    }
+  }
+  bytes = 0;
+}
+
+void LifoChunkCache::purge() {
+  for (Shard& shard : shards_) {
+    shard.purge();
+  }
+}
+
+LifoChunkCacheStats LifoChunkCache::stats() {
+  LifoChunkCacheStats result;
+  result.hits = hits_;
+  result.misses = misses_;
+  for (Shard& shard : shards_) {
+    LockGuard<Mutex> guard(shard.lock);
+    result.cachedBytes += shard.bytes;
+  }
+  return result;
+}
+
+size_t LifoChunkCache::sizeOfIncludingThis(
+    mozilla::MallocSizeOf mallocSizeOf) {
+  size_t n = mallocSizeOf(this);
+  for (Shard& shard : shards_) {
+    LockGuard<Mutex> guard(shard.lock);
+    for (const Bucket& cls : shard.buckets) {
+      for (size_t i = 0; i < cls.count; i++) {
+        n += mallocSizeOf(cls.chunks[i]);
+      }
+    }
+  }
+  return n;
+}
+
 /* static */
 UniquePtr<BumpChunk> BumpChunk::newWithCapacity(size_t size, arena_id_t arena) {
   MOZ_DIAGNOSTIC_ASSERT(size >= sizeof(BumpChunk));
-  void* mem = js_arena_malloc(arena, size);
+  void* mem = ChunkCache ? ChunkCache->get(size, arena) : nullptr;
   if (!mem) {
-    return nullptr;
+    mem = js_arena_malloc(arena, size);
+    if (!mem) {
+      return nullptr;
+    }
   }
 
-  UniquePtr<BumpChunk> result(new (mem) BumpChunk(size));
+  UniquePtr<BumpChunk> result(new (mem) BumpChunk(size, arena));
 
   // We assume that the alignment of LIFO_ALLOC_ALIGN is less than that of the
   // underlying memory allocator -- creating a new BumpChunk should always
@@ -92,6 +314,54 @@ void BumpChunk::setReadWrite() {
 }  // namespace detail
 }  // namespace js
 
+void JS::DeletePolicy<js::detail::BumpChunk>::operator()(
+    const js::detail::BumpChunk* constChunk) {
+  auto* chunk = const_cast<js::detail::BumpChunk*>(constChunk);
+  size_t size = chunk->computedSizeOfIncludingThis();
+  arena_id_t arena = chunk->arena();
+  chunk->~BumpChunk();
+  if (!js::detail::ChunkCache ||
+      !js::detail::ChunkCache->put(chunk, size, arena)) {
+    js_free(chunk);
+  }
+}
+
+bool js::InitLifoChunkCache() {
+  MOZ_ASSERT(!detail::ChunkCache);
+  if (!detail::LifoChunkCache::initThreadShard()) {
+    return false;
+  }
+  detail::ChunkCache = js_new<detail::LifoChunkCache>();
+  return !!detail::ChunkCache;
+}
+
+void js::ShutDownLifoChunkCache() {
+  // Chunks freed from now on go straight back to malloc.
+  detail::LifoChunkCache* cache = detail::ChunkCache;
+  detail::ChunkCache = nullptr;
+  js_delete(cache);
+}
+
+void js::PurgeLifoChunkCache() {
+  if (detail::ChunkCache) {
+    detail::ChunkCache->purge();
+  }
+}
+
+LifoChunkCacheStats js::GetLifoChunkCacheStats() {
+  if (!detail::ChunkCache) {
+    return LifoChunkCacheStats();
+  }
+  return detail::ChunkCache->stats();
+}
+
+size_t js::SizeOfLifoChunkCache(mozilla::MallocSizeOf mallocSizeOf) {
+  if (!detail::ChunkCache) {
+    return 0;
+  }
+  return detail::ChunkCache->sizeOfIncludingThis(mallocSizeOf);
+}
+
 void LifoAlloc::reset(size_t defaultChunkSize) {
   MOZ_ASSERT(mozilla::IsPowerOfTwo(defaultChunkSize));
 
@@ -63,6 +63,24 @@
 // and setOversizeThreshold, which must be smaller than the default chunk size
 // with which the LifoAlloc was initialized.
 //
+// ** Chunk cache
+//
+// Parsers and compilers create and destroy LifoAllocs all the time, on the main
+// thread and on helper threads. To avoid going back to malloc for every new
+// chunk, freed chunks are kept in a process-wide cache (see LifoChunkCache in
+// LifoAlloc.cpp) and reused by the next chunk of the same size.
+//
+// The cache is split into a few shards, each protected by its own lock, and
+// each thread uses its own shard first so that threads do not contend. Only
+// chunks whose size is a power of two are cached, which covers the chunks made
+// for small allocations (see NextSize) but not oversize ones. Cached chunks are
+// kept apart by malloc arena, and only reused by a LifoAlloc allocating in the
+// same arena, so that the cache does not mix main thread and background
+// allocations. Only chunks of MallocArena and BackgroundMallocArena are cached.
+//
+// The cache is bounded, and is purged by shrinking GCs, which are used when
+// memory is short.
+//
 // ** LifoAllocScope (mark & release)
 //
 // As the memory cannot be reclaimed except when the LifoAlloc structure is
@@ -193,6 +211,22 @@
 #include "util/Memory.h"
 #include "util/Poison.h"
 
+namespace js {
+namespace detail {
+class BumpChunk;
+}  // namespace detail
+}  // namespace js
+
+namespace JS {
+
+// Freed chunks are returned to the chunk cache instead of being freed directly.
+template <>
+struct DeletePolicy<js::detail::BumpChunk> {
+  void operator()(const js::detail::BumpChunk* chunk);
+};
+
+}  // namespace JS
+
 namespace js {
 
 // Because the LifoAlloc just drops its contents on the floor, it should only be
@@ -416,6 +450,8 @@ class BumpChunk : public SingleLinkedListElement<BumpChunk> {
   uint8_t* bump_;
   // Pointer to the first byte after this chunk.
   uint8_t* const capacity_;
+  // Malloc arena the memory of this chunk was allocated in.
+  const arena_id_t arena_;
 
 #ifdef MOZ_DIAGNOSTIC_ASSERT_ENABLED
   // Magic number used to check against poisoned values.
@@ -474,9 +510,10 @@ class BumpChunk : public SingleLinkedListElement<BumpChunk> {
   BumpChunk& operator=(const BumpChunk&) = delete;
   BumpChunk(const BumpChunk&) = delete;
 
-  explicit BumpChunk(uintptr_t capacity)
+  BumpChunk(uintptr_t capacity, arena_id_t arena)
       : bump_(begin()),
-        capacity_(base() + capacity)
+        capacity_(base() + capacity),
+        arena_(arena)
 #ifdef MOZ_DIAGNOSTIC_ASSERT_ENABLED
         ,
         magic_(magicNumber)
@@ -555,6 +592,9 @@ class BumpChunk : public SingleLinkedListElement<BumpChunk> {
   // Report allocation size.
   size_t computedSizeOfIncludingThis() const { return capacity_ - base(); }
 
+  // Malloc arena which owns the memory of this chunk.
+  arena_id_t arena() const { return arena_; }
+
   // Opaque type used to carry a pointer to the current location of the bump_
   // pointer, within a BumpChunk.
   class Mark {
@@ -1236,6 +1276,29 @@ class LifoAllocPolicy {
   }
 };
 
+// Create and destroy the process-wide cache of LifoAlloc chunks. Chunks freed
+// when there is no cache go straight back to malloc.
+[[nodiscard]] bool InitLifoChunkCache();
+void ShutDownLifoChunkCache();
+
+// Free all cached chunks.
+void PurgeLifoChunkCache();
+
+struct LifoChunkCacheStats {
+  // Number of chunks of a cacheable size which were taken from the cache, or
+  // which had to be allocated because the cache had none.
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+
+  // Total size of the chunks currently held by the cache.
+  size_t cachedBytes = 0;
+};
+
+LifoChunkCacheStats GetLifoChunkCacheStats();
+
+// Memory used by the cache, including the chunks it holds.
+size_t SizeOfLifoChunkCache(mozilla::MallocSizeOf mallocSizeOf);
+
 }  // namespace js
 
 #endif /* ds_LifoAlloc_h */
@@ -37,7 +37,8 @@
 #include "js/UniquePtr.h"
 #include "js/Utility.h"                // UniqueChars
 #include "js/Value.h"                  // JS::Value
-#include "vm/EnvironmentObject.h"      // WithEnvironmentObject
+#include "vm/ConcurrentDelazification.h"  // DelazificationProfile
+#include "vm/EnvironmentObject.h"         // WithEnvironmentObject
 #include "vm/FunctionFlags.h"          // FunctionFlags
 #include "vm/GeneratorAndAsyncKind.h"  // js::GeneratorKind, js::FunctionAsyncKind
 #include "vm/HelperThreads.h"  // StartOffThreadDelazification, WaitForAllDelazifyTasks
@@ -1573,6 +1574,12 @@ bool frontend::DelazifyCanonicalScriptedFunction(JSContext* cx,
   ScriptSource* ss = lazy->scriptSource();
   ScopeBindingCache* scopeCache = &cx->caches().scopeCache;
 
+  // Record the order in which functions are first executed, for the
+  // ConcurrentProfileGuided delazification of the next loads of this source.
+  if (HashNumber sourceHash = ss->profileSourceHash()) {
+    DelazificationProfile::recordExecution(sourceHash, lazy->sourceStart());
+  }
+
   if (ss->hasSourceType<Utf8Unit>()) {
     // UTF-8 source text.
     return DelazifyCanonicalScriptedFunctionImpl<Utf8Unit>(cx, fc, scopeCache,
@@ -12,8 +12,10 @@
 #include "mozilla/ScopeExit.h"              // mozilla::MakeScopeExit
 #include "mozilla/Try.h"                    // MOZ_TRY
 
+#include <algorithm>    // std::min
 #include <stddef.h>     // size_t
 #include <stdint.h>     // uint8_t, uint16_t, uint32_t
+#include <string.h>     // memcpy
 #include <type_traits>  // std::has_unique_object_representations
 #include <utility>      // std::forward
 
@@ -24,7 +26,11 @@
 #include "js/CompileOptions.h"         // JS::ReadOnlyDecodeOptions
 #include "js/experimental/JSStencil.h"  // ScriptIndex
 #include "js/Transcoding.h"  // JS::TranscodeBuffer, JS::TranscodeRange, JS::TranscodeResult
-#include "vm/JSScript.h"      // ScriptSource
+#include "js/UniquePtr.h"    // js::UniquePtr, js::MakeUnique
+#include "vm/HelperThreads.h"  // AutoLockHelperThreadState, AutoUnlockHelperThreadState
+#include "vm/HelperThreadState.h"  // HelperThreadState, StencilDecodeTask
+#include "vm/JSScript.h"           // ScriptSource
+#include "vm/Runtime.h"            // CanUseExtraThreads
 #include "vm/Scope.h"         // SizeOfParserScopeData
 #include "vm/StencilEnums.h"  // js::ImmutableScriptFlagsEnum
 
@@ -383,6 +389,167 @@ template /* static */ XDRResult StencilXDR::codeSharedData(
 template /* static */ XDRResult StencilXDR::codeSharedData(
     XDRState<XDR_DECODE>* xdr, RefPtr<SharedImmutableScriptData>& sisd);
 
+/* static */ JS::TranscodeResult StencilXDR::decodeSharedDataEntries(
+    FrontendContext* fc, XDRSharedDataEntrySpan entries) {
+  for (const XDRSharedDataEntry& entry : entries) {
+    RefPtr<SharedImmutableScriptData> sisd =
+        SharedImmutableScriptData::create(fc);
+    if (!sisd) {
+      return JS::TranscodeResult::Throw;
+    }
+
+    auto isd = ImmutableScriptData::new_(fc, entry.size);
+    if (!isd) {
+      return JS::TranscodeResult::Throw;
+    }
+    memcpy(reinterpret_cast<uint8_t*>(isd.get()), entry.data, entry.size);
+    sisd->setOwn(std::move(isd), entry.hash);
+
+    if (!sisd->get()->validateLayout(entry.size)) {
+      MOZ_ASSERT(false, "Bad ImmutableScriptData");
+      return JS::TranscodeResult::Failure_BadDecode;
+    }
+
+    *entry.result = std::move(sisd);
+  }
+
+  return JS::TranscodeResult::Ok;
+}
+
+// Below this number of SharedImmutableScriptData, the cost of waking up helper
+// threads dominates the cost of copying the data on the current thread.
+static constexpr size_t ParallelSharedDataThreshold = 256;
+
+// Number of SharedImmutableScriptData decoded by each StencilDecodeTask.
+static constexpr size_t SharedDataEntriesPerTask = 128;
+
+static bool CanDecodeSharedDataInParallel(XDRState<XDR_DECODE>* xdr,
+                                          size_t length) {
+  const auto& options = static_cast<XDRStencilDecoder*>(xdr)->options();
+  if (options.usePinnedBytecode) {
+    // The data is used in place, there is nothing to copy.
+    return false;
+  }
+
+  return length >= ParallelSharedDataThreshold && CanUseExtraThreads() &&
+         IsHelperThreadStateInitialized();
+}
+
+// Decode the SharedImmutableScriptData vector by first locating each entry in
+// the buffer, then copying the entries out of the buffer on helper threads and
+// on the current thread. The sharing of the decoded data is done on the
+// current thread once all the chunks are decoded, as it contends on the
+// global script data table.
+static XDRResult DecodeSharedDataVectorInParallel(
+    XDRState<XDR_DECODE>* xdr, SharedDataContainer::SharedDataVector& vec) {
+  Vector<XDRSharedDataEntry, 0, SystemAllocPolicy> entries;
+  if (!entries.reserve(vec.length())) {
+    js::ReportOutOfMemory(xdr->fc());
+    return xdr->fail(JS::TranscodeResult::Throw);
+  }
+
+  for (auto& slot : vec) {
+    XDRSharedDataEntry entry;
+    MOZ_TRY(xdr->codeUint32(&entry.size));
+
+    // See codeSharedData for the meaning of a zero size.
+    if (!entry.size) {
+      continue;
+    }
+
+    MOZ_TRY(xdr->align32());
+    MOZ_TRY(xdr->codeUint32(&entry.hash));
+    MOZ_TRY(xdr->readData(&entry.data, entry.size));
+    entry.result = &slot;
+    entries.infallibleAppend(entry);
+  }
+
+  XDRSharedDataEntrySpan all(entries.begin(), entries.length());
+  size_t ownLength = std::min(SharedDataEntriesPerTask, all.Length());
+
+  Vector<UniquePtr<StencilDecodeTask>, 0, SystemAllocPolicy> tasks;
+  for (size_t begin = ownLength; begin < all.Length();
+       begin += SharedDataEntriesPerTask) {
+    size_t end = std::min(begin + SharedDataEntriesPerTask, all.Length());
+    auto task = js::MakeUnique<StencilDecodeTask>(all.FromTo(begin, end));
+    if (!task || !tasks.append(std::move(task))) {
+      js::ReportOutOfMemory(xdr->fc());
+      return xdr->fail(JS::TranscodeResult::Throw);
+    }
+  }
+
+  // Tasks which could not be added to the worklist are run on this thread.
+  size_t submitted = 0;
+  {
+    AutoLockHelperThreadState lock;
+    for (auto& task : tasks) {
+      if (!HelperThreadState().submitTask(task.get(), lock)) {
+        break;
+      }
+      submitted++;
+    }
+  }
+
+  JS::TranscodeResult result =
+      StencilXDR::decodeSharedDataEntries(xdr->fc(), all.To(ownLength));
+
+  {
+    AutoLockHelperThreadState lock;
+
+    // Take back every task which no helper thread has started and run it
+    // here. This thread may itself be a helper thread, as for off-thread
+    // decoding, so it must not wait for tasks which still need a free helper
+    // thread to run.
+    for (size_t i = 0; i < tasks.length(); i++) {
+      StencilDecodeTask* task = tasks[i].get();
+      if (i < submitted &&
+          !HelperThreadState().removePendingStencilDecodeTask(task, lock)) {
+        continue;
+      }
+
+      {
+        AutoUnlockHelperThreadState unlock(lock);
+        task->runTask();
+      }
+      task->done = true;
+    }
+
+    // The remaining tasks are running or finished.
+    for (auto& task : tasks) {
+      while (!task->done) {
+        HelperThreadState().wait(lock);
+      }
+    }
+  }
+
+  for (auto& task : tasks) {
+    if (task->result == JS::TranscodeResult::Failure_BadDecode ||
+        result == JS::TranscodeResult::Ok) {
+      result = task->result;
+    }
+  }
+  if (result == JS::TranscodeResult::Throw) {
+    // Errors reported to the FrontendContext of the helper threads are
+    // dropped with it. All of them are out-of-memory errors.
+    if (!xdr->fc()->hadErrors()) {
+      js::ReportOutOfMemory(xdr->fc());
+    }
+    return xdr->fail(result);
+  }
+  if (result != JS::TranscodeResult::Ok) {
+    return xdr->fail(result);
+  }
+
+  for (const XDRSharedDataEntry& entry : entries) {
+    if (!SharedImmutableScriptData::shareScriptData(xdr->fc(),
+                                                    *entry.result)) {
+      return xdr->fail(JS::TranscodeResult::Throw);
+    }
+  }
+
+  return Ok();
+}
+
 template <XDRMode mode>
 /* static */ XDRResult StencilXDR::codeSharedDataContainer(
     XDRState<mode>* xdr, SharedDataContainer& sharedData) {
@@ -432,6 +599,12 @@ template <XDRMode mode>
       }
       auto& vec = *sharedData.asVector();
       MOZ_TRY(XDRVectorInitialized(xdr, vec));
+      if constexpr (mode == XDR_DECODE) {
+        if (CanDecodeSharedDataInParallel(xdr, vec.length())) {
+          MOZ_TRY(DecodeSharedDataVectorInParallel(xdr, vec));
+          break;
+        }
+      }
       for (auto& entry : vec) {
         // NOTE: There can be nullptr, even if we don't perform syntax parsing,
         //       because of constant folding.
@@ -1329,6 +1502,11 @@ XDRResult StencilXDR::codeSource(XDRState<mode>* xdr,
   MOZ_TRY(xdr->codeUint32(&source->startLine_));
   MOZ_TRY(xdr->codeUint32(source->startColumn_.addressOfValueForTranscode()));
 
+  // The source text may not be part of the encoded data, so the hash used by
+  // the DelazificationProfile is kept instead of being computed on decode.
+  static_assert(sizeof(source->profileSourceHash_) == sizeof(uint32_t));
+  MOZ_TRY(xdr->codeUint32(&source->profileSourceHash_));
+
   // The introduction info doesn't persist across encode/decode.
   if (mode == XDR_DECODE) {
     source->introductionType_ = maybeOptions->introductionType;
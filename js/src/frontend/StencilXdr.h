@@ -8,6 +8,7 @@
 #define frontend_StencilXdr_h
 
 #include "mozilla/RefPtr.h"  // RefPtr
+#include "mozilla/Span.h"    // mozilla::Span
 
 #include "frontend/ParserAtom.h"  // ParserAtom, ParserAtomSpan
 #include "frontend/Stencil.h"  // BitIntStencil, ScopeStencil, BaseParserScopeData
@@ -57,6 +58,19 @@ struct CanCopyDataToDisk {
   static constexpr bool value = unique_repr && no_pointer;
 };
 
+// A SharedImmutableScriptData entry of a stencil buffer which has been located
+// but not yet copied out of the buffer. Decoding such entries only touches the
+// entry itself, which lets large stencils split this work across helper
+// threads. See StencilXDR::decodeSharedDataEntries.
+struct XDRSharedDataEntry {
+  const uint8_t* data = nullptr;
+  uint32_t size = 0;
+  uint32_t hash = 0;
+  RefPtr<SharedImmutableScriptData>* result = nullptr;
+};
+
+using XDRSharedDataEntrySpan = mozilla::Span<XDRSharedDataEntry>;
+
 // This is just a namespace class that can be used in friend declarations,
 // so that the statically declared XDR methods within have access to the
 // relevant struct internals.
@@ -114,6 +128,11 @@ class StencilXDR {
   static XDRResult codeSharedDataContainer(XDRState<mode>* xdr,
                                            SharedDataContainer& sharedData);
 
+  // Copy each entry out of the buffer and validate its layout, without
+  // sharing it. This can run on any thread, as long as `fc` is owned by it.
+  static JS::TranscodeResult decodeSharedDataEntries(
+      FrontendContext* fc, XDRSharedDataEntrySpan entries);
+
   template <XDRMode mode>
   static XDRResult codeParserAtom(XDRState<mode>* xdr, LifoAlloc& alloc,
                                   ParserAtom** atomp);
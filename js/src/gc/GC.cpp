@@ -1380,6 +1380,8 @@ uint32_t GCRuntime::getParameter(JSGCParamKey key, const AutoLockGC& lock) {
       return markingThreadCount;
     case JSGC_SYSTEM_PAGE_SIZE_KB:
       return SystemPageSize() / 1024;
+    case JSGC_LAST_LEVEL_CACHE_SIZE_KB:
+      return LastLevelCacheSize() / 1024;
     case JSGC_HIGH_FREQUENCY_MODE:
       return schedulingState.inHighFrequencyGCMode();
     default:
@@ -2508,6 +2510,10 @@ void GCRuntime::purgeRuntime() {
   cx->frontendCollectionPool().purge();
 
   rt->caches().purge();
+  if (isShrinkingGC()) {
+    rt->caches().regExpBytecodeCache.purge();
+    PurgeLifoChunkCache();
+  }
 
   if (rt->isMainRuntime()) {
     SharedImmutableStringsCache::getSingleton().purge();
@@ -79,6 +79,8 @@ class ArenaChunk;
   _("nurseryEagerCollectionTimeoutMS",                                      \
     JSGC_NURSERY_EAGER_COLLECTION_TIMEOUT_MS, true)                         \
   _("nurseryMaxTimeGoalMS", JSGC_NURSERY_MAX_TIME_GOAL_MS, true)            \
+  _("nurseryCacheAwareSizingEnabled",                                       \
+    JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED, true)                          \
   _("zoneAllocDelayKB", JSGC_ZONE_ALLOC_DELAY_KB, true)                     \
   _("mallocThresholdBase", JSGC_MALLOC_THRESHOLD_BASE, true)                \
   _("urgentThreshold", JSGC_URGENT_THRESHOLD_MB, true)                      \
@@ -89,6 +91,7 @@ class ArenaChunk;
   _("maxMarkingThreads", JSGC_MAX_MARKING_THREADS, true)                    \
   _("markingThreadCount", JSGC_MARKING_THREAD_COUNT, false)                 \
   _("systemPageSizeKB", JSGC_SYSTEM_PAGE_SIZE_KB, false)                    \
+  _("lastLevelCacheSizeKB", JSGC_LAST_LEVEL_CACHE_SIZE_KB, false)           \
   _("semispaceNurseryEnabled", JSGC_SEMISPACE_NURSERY_ENABLED, true)        \
   _("generateMissingAllocSites", JSGC_GENERATE_MISSING_ALLOC_SITES, true)   \
   _("highFrequencyMode", JSGC_HIGH_FREQUENCY_MODE, false)                   \
@@ -145,6 +145,8 @@ class MarkStack {
     JSObject* asRangeObject() const;
     JSRope* asTempRope() const;
 
+    JS::Zone* zoneFromAnyThread() const;
+
     void assertValid() const;
   };
 
@@ -208,6 +210,7 @@ class MarkStack {
   bool hasEntries() const { return !isEmpty(); }
 
   Tag peekTag() const;
+  JS::Zone* peekZone() const;
   TaggedPtr popPtr();
   SlotsOrElementsRange popSlotsOrElementsRange();
 
@@ -397,7 +400,16 @@ class GCMarker {
   bool hasEntries(gc::MarkColor color) const;
 
   bool canDonateWork() const;
-  bool shouldDonateWork() const;
+  bool shouldDonateWork(uint32_t waitingTasks) const;
+
+  // The number of words on the stack for the current color.
+  size_t stackDepth() const { return stack.position(); }
+
+  // The zone of the thing at the top of the stack, which is the work that is
+  // donated first.
+  JS::Zone* peekZone() const { return stack.peekZone(); }
+
+  void setDonationThreshold(size_t words) { donationThreshold = words; }
 
   void start();
   void stop();
@@ -618,6 +630,13 @@ class GCMarker {
   /* Random number generator state. */
   MainThreadOrGCTaskData<mozilla::non_crypto::XorShift128PlusRNG> random;
 
+ private:
+  /*
+   * Minimum stack depth in words for donating work to a single waiting task
+   * during parallel marking. See shouldDonateWork.
+   */
+  MainThreadOrGCTaskData<size_t> donationThreshold;
+
 #ifdef DEBUG
  private:
   /* Assert that start and stop are called with correct ordering. */
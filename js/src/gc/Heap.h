@@ -407,7 +407,8 @@ class alignas(ArenaSize) Arena {
   inline size_t& atomBitmapStart();
 
   template <typename T, FinalizeKind finalizeKind>
-  size_t finalize(JS::GCContext* gcx, AllocKind thingKind, size_t thingSize);
+  size_t finalize(JS::GCContext* gcx, AllocKind thingKind, size_t thingSize,
+                  size_t* nfinalizedOut);
 
   static void staticAsserts();
   static void checkLookupTables();
@@ -1357,7 +1357,8 @@ bool GCMarker::markCurrentColorInParallel(ParallelMarkTask* task,
     // TODO: It might be better to only check this occasionally, possibly
     // combined with the slice budget check. Experiments with giving this its
     // own counter resulted in worse performance.
-    if (waitingTaskCount && shouldDonateWork()) {
+    uint32_t waitingTasks = waitingTaskCount;
+    if (waitingTasks && shouldDonateWork(waitingTasks)) {
       task->donateWork();
     }
   }
@@ -1767,6 +1768,11 @@ inline JSRope* MarkStack::TaggedPtr::asTempRope() const {
   return &ptr()->as<JSString>()->asRope();
 }
 
+inline JS::Zone* MarkStack::TaggedPtr::zoneFromAnyThread() const {
+  MOZ_ASSERT(ptr()->isTenured());
+  return ptr()->asTenured().zoneFromAnyThread();
+}
+
 inline MarkStack::SlotsOrElementsRange::SlotsOrElementsRange(
     SlotsOrElementsKind kindArg, JSObject* obj, size_t startArg)
     : startAndKind_((startArg << StartShift) | size_t(kindArg)),
@@ -2074,6 +2080,13 @@ inline MarkStack::Tag MarkStack::peekTag() const {
   return peekPtr().tag();
 }
 
+JS::Zone* MarkStack::peekZone() const {
+  // The top word of a SlotsOrElementsRange is also a tagged pointer, to the
+  // range's object.
+  MOZ_ASSERT(!isEmpty());
+  return peekPtr().zoneFromAnyThread();
+}
+
 inline MarkStack::TaggedPtr MarkStack::popPtr() {
   MOZ_ASSERT(!isEmpty());
   MOZ_ASSERT(!TagIsRangeTag(peekTag()));
@@ -2212,7 +2225,8 @@ GCMarker::GCMarker(JSRuntime* rt)
       state(NotActive),
       incrementalWeakMapMarkingEnabled(
           TuningDefaults::IncrementalWeakMapMarkingEnabled),
-      random(js::GenerateRandomSeed(), js::GenerateRandomSeed())
+      random(js::GenerateRandomSeed(), js::GenerateRandomSeed()),
+      donationThreshold(0)
 #ifdef DEBUG
       ,
       checkAtomMarking(true),
@@ -2337,15 +2351,22 @@ void GCMarker::leaveParallelMarkingMode() {
 // Therefore we try hard to split work up at the start of a slice (calling
 // canDonateWork) but when a slice is running we only donate if there is enough
 // work to make it worthwhile (calling shouldDonateWork).
+//
+// The threshold for the latter is set by ParallelMarker from the measured
+// stack depths at the start of parallel marking, and is divided between the
+// waiting tasks so that work still gets split up as the stacks drain.
 bool GCMarker::canDonateWork() const {
   return stack.position() > ValueRangeWords;
 }
-bool GCMarker::shouldDonateWork() const {
+bool GCMarker::shouldDonateWork(uint32_t waitingTasks) const {
   constexpr size_t MinWordCount = 12;
   static_assert(MinWordCount >= ValueRangeWords,
                 "We must always leave at least one stack entry.");
 
-  return stack.position() > MinWordCount;
+  MOZ_ASSERT(waitingTasks != 0);
+  size_t threshold =
+      donationThreshold / mozilla::CountPopulation32(waitingTasks);
+  return stack.position() > std::max(threshold, MinWordCount);
 }
 
 template <typename Tracer>
@@ -37,6 +37,10 @@
 #    include <sys/syscall.h>
 #  endif
 
+#  ifdef XP_DARWIN
+#    include <sys/sysctl.h>
+#  endif
+
 #  if !defined(__wasi__)
 #    include <sys/mman.h>
 #    include <sys/resource.h>
@@ -76,6 +80,9 @@ static size_t numAddressBits = 0;
 /* An estimate of the number of bytes available for virtual memory. */
 static size_t virtualMemoryLimit = size_t(-1);
 
+/* The size of the largest CPU cache, or zero if this is not known. */
+static size_t lastLevelCacheSize = 0;
+
 /* Whether decommit is enabled. */
 static bool decommitEnabled = false;
 
@@ -154,6 +161,8 @@ size_t SystemAddressBits() { return numAddressBits; }
 
 size_t VirtualMemoryLimit() { return virtualMemoryLimit; }
 
+size_t LastLevelCacheSize() { return lastLevelCacheSize; }
+
 bool UsingScattershotAllocator() {
 #ifdef JS_64BIT
   return numAddressBits >= MinAddressBitsForRandomAlloc;
@@ -418,6 +427,58 @@ static inline uint64_t FindAddressLimitInner(size_t highBit, size_t tries) {
 
 #endif  // defined(JS_64BIT)
 
+static size_t FindLastLevelCacheSize() {
+#if defined(XP_WIN)
+  DWORD length = 0;
+  if (GetLogicalProcessorInformation(nullptr, &length) ||
+      GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+    return 0;
+  }
+
+  size_t count = length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+  UniquePtr<SYSTEM_LOGICAL_PROCESSOR_INFORMATION[], JS::FreePolicy> info(
+      js_pod_malloc<SYSTEM_LOGICAL_PROCESSOR_INFORMATION>(count));
+  if (!info || !GetLogicalProcessorInformation(info.get(), &length)) {
+    return 0;
+  }
+
+  size_t size = 0;
+  BYTE level = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (info[i].Relationship != RelationCache) {
+      continue;
+    }
+    const CACHE_DESCRIPTOR& cache = info[i].Cache;
+    if (cache.Level > level || (cache.Level == level && cache.Size > size)) {
+      level = cache.Level;
+      size = cache.Size;
+    }
+  }
+  return size;
+#elif defined(XP_DARWIN)
+  for (const char* name : {"hw.l3cachesize", "hw.l2cachesize"}) {
+    uint64_t size = 0;
+    size_t length = sizeof(size);
+    if (sysctlbyname(name, &size, &length, nullptr, 0) == 0 && size != 0) {
+      return size_t(size);
+    }
+  }
+  return 0;
+#elif defined(_SC_LEVEL3_CACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+  // Some systems report zero or -1 for levels they don't have or can't
+  // describe.
+  for (int name : {_SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE}) {
+    long size = sysconf(name);
+    if (size > 0) {
+      return size_t(size);
+    }
+  }
+  return 0;
+#else
+  return 0;
+#endif
+}
+
 void InitMemorySubsystem() {
   if (pageSize == 0) {
 #ifdef XP_WIN
@@ -465,6 +526,8 @@ void InitMemorySubsystem() {
       }
     }
 #endif
+
+    lastLevelCacheSize = FindLastLevelCacheSize();
   }
 
   MOZ_ASSERT(gMappedMemorySizeBytes == 0);
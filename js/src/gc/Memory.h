@@ -36,6 +36,11 @@ size_t SystemAddressBits();
 // to be determined, then it will be size_t(-1).
 size_t VirtualMemoryLimit();
 
+// The size in bytes of the largest (usually last level) CPU cache, as reported
+// by the operating system. If this could not be determined then it will be
+// zero.
+size_t LastLevelCacheSize();
+
 // The scattershot allocator is used on platforms that have a large address
 // range. On these platforms we allocate at random addresses.
 bool UsingScattershotAllocator();
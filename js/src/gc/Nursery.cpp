@@ -270,7 +270,8 @@ js::Nursery::Nursery(GCRuntime* gc)
       minorGCTriggerReason_(JS::GCReason::NO_REASON),
       prevPosition_(0),
       hasRecentGrowthData(false),
-      smoothedTargetSize(0.0) {
+      smoothedTargetSize(0.0),
+      smoothedThroughput(0.0) {
   // Try to keep fields used by allocation fast path together at the start of
   // the nursery.
   static_assert(offsetof(Nursery, toSpace.position_) < TypicalCacheLineSize);
@@ -1075,6 +1076,22 @@ void js::Nursery::renderProfileJSON(JSONPrinter& json) const {
     json.property("chunk_alloc_us", timeInChunkAlloc_, json.MICROSECONDS);
   }
 
+  if (lastSizing.limitedBy) {
+    json.beginObjectProperty("sizing");
+    json.property("limited_by", lastSizing.limitedBy);
+    json.property("target_size", lastSizing.targetSize);
+    json.floatProperty("fraction_promoted", lastSizing.fractionPromoted, 4);
+    json.floatProperty("duty_factor", lastSizing.dutyFactor, 4);
+    json.property("throughput_bytes_per_ms", size_t(lastSizing.throughput));
+    if (lastSizing.latencyLimit) {
+      json.property("latency_limit", lastSizing.latencyLimit);
+    }
+    if (lastSizing.cacheLimit) {
+      json.property("cache_limit", lastSizing.cacheLimit);
+    }
+    json.endObject();
+  }
+
   // This calculation includes the whole collection time, not just the time
   // spent promoting.
   double totalTime = profileDurations_[ProfileKey::Total].ToSeconds();
@@ -2197,6 +2214,8 @@ void js::Nursery::Space::setStartToCurrentPosition() {
 
 void js::Nursery::maybeResizeNursery(JS::GCOptions options,
                                      JS::GCReason reason) {
+  lastSizing = SizingDecision();
+
 #ifdef JS_GC_ZEAL
   // This zeal mode disabled nursery resizing.
   if (gc->hasZealMode(ZealMode::GenerationalGC)) {
@@ -2206,6 +2225,7 @@ void js::Nursery::maybeResizeNursery(JS::GCOptions options,
 
   size_t newCapacity =
       std::clamp(targetSize(options, reason), minSpaceSize(), maxSpaceSize());
+  lastSizing.targetSize = newCapacity;
 
   MOZ_ASSERT(roundSize(newCapacity) == newCapacity);
   MOZ_ASSERT(newCapacity >= SystemPageSize());
@@ -2255,18 +2275,21 @@ size_t js::Nursery::targetSize(JS::GCOptions options, JS::GCReason reason) {
   if (options == JS::GCOptions::Shrink || gc::IsOOMReason(reason) ||
       gc->systemHasLowMemory()) {
     clearRecentGrowthData();
+    lastSizing.limitedBy = "shrink";
     return 0;
   }
 
   // Don't resize the nursery during shutdown.
   if (options == JS::GCOptions::Shutdown) {
     clearRecentGrowthData();
+    lastSizing.limitedBy = "shutdown";
     return capacity();
   }
 
   TimeStamp now = TimeStamp::Now();
 
   if (reason == JS::GCReason::PREPARE_FOR_PAGELOAD) {
+    lastSizing.limitedBy = "page load";
     return roundSize(maxSpaceSize());
   }
 
@@ -2276,6 +2299,7 @@ size_t js::Nursery::targetSize(JS::GCOptions options, JS::GCReason reason) {
           tunables().nurseryEagerCollectionTimeout() &&
       !js::SupportDifferentialTesting()) {
     clearRecentGrowthData();
+    lastSizing.limitedBy = "unused";
     return 0;
   }
 
@@ -2295,6 +2319,22 @@ size_t js::Nursery::targetSize(JS::GCOptions options, JS::GCReason reason) {
     dutyFactor = collectorTime.ToSeconds() / totalTime.ToSeconds();
   }
 
+  // Measure the collector's throughput in bytes of nursery collected per
+  // millisecond, smoothed over recent collections.
+  double collectorTimeMS = collectorTime.ToMilliseconds();
+  if (previousGC.nurseryUsedBytes != 0 && collectorTimeMS > 0.0) {
+    double throughput = double(previousGC.nurseryUsedBytes) / collectorTimeMS;
+    if (hasRecentGrowthData && smoothedThroughput != 0.0) {
+      smoothedThroughput = 0.75 * smoothedThroughput + 0.25 * throughput;
+    } else {
+      smoothedThroughput = throughput;
+    }
+  }
+
+  lastSizing.fractionPromoted = fractionPromoted;
+  lastSizing.dutyFactor = dutyFactor;
+  lastSizing.throughput = smoothedThroughput;
+
   // Calculate a growth factor to try to achieve target promotion rate and duty
   // factor goals.
   static const double PromotionGoal = 0.02;
@@ -2302,22 +2342,48 @@ size_t js::Nursery::targetSize(JS::GCOptions options, JS::GCReason reason) {
   double promotionGrowth = fractionPromoted / PromotionGoal;
   double dutyGrowth = dutyFactor / DutyFactorGoal;
   double growthFactor = std::max(promotionGrowth, dutyGrowth);
+  const char* limitedBy =
+      promotionGrowth >= dutyGrowth ? "promotion" : "duty factor";
 
 #ifndef DEBUG
   // In optimized builds, decrease the growth factor to try to keep collections
-  // shorter than a target maximum time. Don't do this during page load.
+  // shorter than a target maximum time. Don't do this during page load. The
+  // size that can be collected in this time is estimated from the measured
+  // throughput.
   //
   // Debug builds are so much slower and more unpredictable that doing this
   // would cause very different nursery behaviour to an equivalent release
   // build.
   double maxTimeGoalMS = tunables().nurseryMaxTimeGoalMS().ToMilliseconds();
   if (!gc->isInPageLoad() && maxTimeGoalMS != 0.0 &&
-      !js::SupportDifferentialTesting()) {
-    double timeGrowth = maxTimeGoalMS / collectorTime.ToMilliseconds();
-    growthFactor = std::min(growthFactor, timeGrowth);
+      smoothedThroughput != 0.0 && !js::SupportDifferentialTesting()) {
+    double latencyLimit = maxTimeGoalMS * smoothedThroughput;
+    lastSizing.latencyLimit = size_t(latencyLimit);
+    double timeGrowth = latencyLimit / double(capacity());
+    if (timeGrowth < growthFactor) {
+      growthFactor = timeGrowth;
+      limitedBy = "time goal";
+    }
   }
 #endif
 
+  // Don't let the nursery grow beyond the size of the CPU's largest cache,
+  // after which collections become much more expensive, unless we are
+  // promoting too much. The cost of promotion outweighs that of cache misses.
+  size_t cacheSize = LastLevelCacheSize();
+  if (tunables().nurseryCacheAwareSizingEnabled() && cacheSize != 0 &&
+      !js::SupportDifferentialTesting()) {
+    size_t cacheLimit = AdjustSizeForSemispace(cacheSize, semispaceEnabled_);
+    lastSizing.cacheLimit = cacheLimit;
+    double cacheGrowth = double(cacheLimit) / double(capacity());
+    if (promotionGrowth <= 1.0 && cacheGrowth < growthFactor) {
+      growthFactor = cacheGrowth;
+      limitedBy = "cache";
+    }
+  }
+
+  lastSizing.limitedBy = limitedBy;
+
   // Limit the range of the growth factor to prevent transient high promotion
   // rates from affecting the nursery size too far into the future.
   static const double GrowthRange = 2.0;
@@ -2357,6 +2423,7 @@ void js::Nursery::clearRecentGrowthData() {
 
   hasRecentGrowthData = false;
   smoothedTargetSize = 0.0;
+  smoothedThroughput = 0.0;
 }
 
 /* static */
@@ -328,6 +328,9 @@ class Nursery {
 
   bool canCreateAllocSite() { return pretenuringNursery.canCreateAllocSite(); }
   void noteAllocSiteCreated() { pretenuringNursery.noteAllocSiteCreated(); }
+  gc::PretenuringProfile& pretenuringProfile() {
+    return pretenuringNursery.profile();
+  }
   bool reportPretenuring() const { return pretenuringReportFilter_.enabled; }
   void maybeStopPretenuring(gc::GCRuntime* gc) {
     pretenuringNursery.maybeStopPretenuring(gc);
@@ -663,8 +666,30 @@ class Nursery {
   };
   PreviousGC previousGC;
 
+  // The inputs to and result of the most recent resizing decision made by
+  // targetSize(), reported in the profile JSON.
+  struct SizingDecision {
+    // The factor that determined the target size, or nullptr if no decision
+    // has been made.
+    const char* limitedBy = nullptr;
+    size_t targetSize = 0;
+    double fractionPromoted = 0.0;
+    double dutyFactor = 0.0;
+    // Smoothed minor GC throughput in bytes of nursery collected per
+    // millisecond.
+    double throughput = 0.0;
+    // The size we estimate can be collected within the max time goal, or zero
+    // if there is no time goal.
+    size_t latencyLimit = 0;
+    // The per-space size limit imposed by the CPU cache, or zero if there is
+    // none.
+    size_t cacheLimit = 0;
+  };
+  SizingDecision lastSizing;
+
   bool hasRecentGrowthData;
   double smoothedTargetSize;
+  double smoothedThroughput;
 
   // During a collection most hoisted slot and element buffers indicate their
   // new location with a forwarding pointer at the base. This does not work
@@ -6,6 +6,8 @@
 
 #include "gc/ParallelMarking.h"
 
+#include <algorithm>
+
 #include "gc/GCInternals.h"
 #include "gc/GCLock.h"
 #include "vm/GeckoProfiler.h"
@@ -76,22 +78,17 @@ bool ParallelMarker::mark(const SliceBudget& sliceBudget) {
   for (size_t i = 0; i < workerCount(); i++) {
     GCMarker* marker = gc->markers[i].get();
     tasks[i].emplace(this, marker, color, i, sliceBudget);
-
-    // Attempt to populate empty mark stacks.
-    //
-    // TODO: When tuning for more than two markers we may need to adopt a more
-    // sophisticated approach.
-    if (!marker->hasEntriesForCurrentColor() && gc->marker().canDonateWork()) {
-      GCMarker::moveWork(marker, &gc->marker(), false);
-    }
   }
 
+  distributeInitialWork();
+
   AutoLockHelperThreadState lock;
 
   MOZ_ASSERT(!hasActiveTasks(lock));
   for (size_t i = 0; i < workerCount(); i++) {
     ParallelMarkTask& task = *tasks[i];
     if (task.hasWork()) {
+      task.zoneHint = task.marker->peekZone();
       setTaskActive(&task, lock);
     }
   }
@@ -122,6 +119,46 @@ bool ParallelMarker::hasWork(MarkColor color) const {
   return false;
 }
 
+void ParallelMarker::distributeInitialWork() {
+  // Attempt to populate empty mark stacks, each time taking work from the
+  // marker with the deepest stack. Taking it from the same marker every time
+  // would leave later markers with geometrically less work.
+  for (size_t i = 0; i < workerCount(); i++) {
+    GCMarker* marker = gc->markers[i].get();
+    if (marker->hasEntriesForCurrentColor()) {
+      continue;
+    }
+
+    GCMarker* donor = nullptr;
+    for (const auto& other : gc->markers) {
+      if (!donor || other->stackDepth() > donor->stackDepth()) {
+        donor = other.get();
+      }
+    }
+    if (!donor->canDonateWork()) {
+      break;
+    }
+
+    GCMarker::moveWork(marker, donor, false);
+  }
+
+  // Only donate work while marking once there is a meaningful fraction of a
+  // marker's share of the measured work on its stack, as small donations from
+  // deep stacks interrupt marking for little benefit.
+  static constexpr size_t DonationsPerShare = 8;
+  static constexpr size_t MaxDonationThreshold = 1024;
+
+  size_t totalDepth = 0;
+  for (const auto& marker : gc->markers) {
+    totalDepth += marker->stackDepth();
+  }
+  size_t threshold = std::min(totalDepth / (workerCount() * DonationsPerShare),
+                              MaxDonationThreshold);
+  for (const auto& marker : gc->markers) {
+    marker->setDonationThreshold(threshold);
+  }
+}
+
 ParallelMarkTask::ParallelMarkTask(ParallelMarker* pm, GCMarker* marker,
                                    MarkColor color, uint32_t id,
                                    const SliceBudget& budget)
@@ -130,7 +167,8 @@ ParallelMarkTask::ParallelMarkTask(ParallelMarker* pm, GCMarker* marker,
       marker(marker),
       color(*marker, color),
       budget(budget),
-      id(id) {
+      id(id),
+      zoneHint(nullptr) {
   marker->enterParallelMarkingMode();
 }
 
@@ -144,17 +182,21 @@ bool ParallelMarkTask::hasWork() const {
 }
 
 void ParallelMarkTask::recordDuration() {
+  const gcstats::ParallelMarkThreadStats& taskStats = stats.ref();
+
   // Record times separately to avoid double counting when these are summed.
   gc->stats().recordParallelPhase(gcstats::PhaseKind::PARALLEL_MARK_MARK,
-                                  markTime.ref());
+                                  taskStats.markTime);
   gc->stats().recordParallelPhase(gcstats::PhaseKind::PARALLEL_MARK_WAIT,
-                                  waitTime.ref());
-  TimeDuration other = duration() - markTime.ref() - waitTime.ref();
+                                  taskStats.waitTime);
+  TimeDuration other = duration() - taskStats.markTime - taskStats.waitTime;
   if (other < TimeDuration::Zero()) {
     other = TimeDuration::Zero();
   }
   gc->stats().recordParallelPhase(gcstats::PhaseKind::PARALLEL_MARK_OTHER,
                                   other);
+
+  gc->stats().recordParallelMarkThread(id, taskStats);
 }
 
 void ParallelMarkTask::run(AutoLockHelperThreadState& lock) {
@@ -184,7 +226,7 @@ bool ParallelMarkTask::tryMarking(AutoLockHelperThreadState& lock) {
   {
     AutoUnlockHelperThreadState unlock(lock);
 
-    AutoAddTimeDuration time(markTime.ref());
+    AutoAddTimeDuration time(stats.ref().markTime);
     finished = marker->markCurrentColorInParallel(this, budget);
 
     GeckoProfilerRuntime& profiler = gc->rt->geckoProfiler();
@@ -220,7 +262,7 @@ bool ParallelMarkTask::requestWork(AutoLockHelperThreadState& lock) {
 }
 
 void ParallelMarkTask::waitUntilResumed(AutoLockHelperThreadState& lock) {
-  AutoAddTimeDuration time(waitTime.ref());
+  AutoAddTimeDuration time(stats.ref().waitTime);
 
   pm->addTaskToWaitingList(this, lock);
 
@@ -290,11 +332,20 @@ bool ParallelMarker::isTaskInWaitingList(
 }
 #endif
 
-ParallelMarkTask* ParallelMarker::takeWaitingTask() {
+ParallelMarkTask* ParallelMarker::takeWaitingTask(JS::Zone* zoneHint) {
   MOZ_ASSERT(hasWaitingTasks());
   uint32_t id = waitingTasks.FindFirst();
   MOZ_ASSERT(id < workerCount());
 
+  if (zoneHint && tasks[id]->zoneHint != zoneHint) {
+    for (uint32_t i = id + 1; i < workerCount(); i++) {
+      if (waitingTasks[i] && tasks[i]->zoneHint == zoneHint) {
+        id = i;
+        break;
+      }
+    }
+  }
+
   MOZ_ASSERT(waitingTasks[id]);
   waitingTasks[id] = false;
   return &*tasks[id];
@@ -326,11 +377,14 @@ void ParallelMarker::setTaskInactive(ParallelMarkTask* task,
   }
 }
 
-void ParallelMarkTask::donateWork() { pm->donateWorkFrom(marker); }
+void ParallelMarkTask::donateWork() { pm->donateWorkFrom(this); }
 
-void ParallelMarker::donateWorkFrom(GCMarker* src) {
+void ParallelMarker::donateWorkFrom(ParallelMarkTask* src) {
   GeckoProfilerRuntime& profiler = gc->rt->geckoProfiler();
 
+  // The work at the top of the stack is donated first.
+  JS::Zone* zone = src->marker->peekZone();
+
   if (!gHelperThreadLock.tryLock()) {
     if (profiler.enabled()) {
       profiler.markEvent("Parallel marking donate failed", "lock already held");
@@ -348,19 +402,31 @@ void ParallelMarker::donateWorkFrom(GCMarker* src) {
   }
 
   // Take a waiting task off the list.
-  ParallelMarkTask* waitingTask = takeWaitingTask();
+  ParallelMarkTask* waitingTask = takeWaitingTask(zone);
 
   // |task| is not running so it's safe to move work to it.
   MOZ_ASSERT(waitingTask->isWaiting);
 
+  bool sameZone = waitingTask->zoneHint == zone;
+  waitingTask->zoneHint = zone;
+
   gHelperThreadLock.unlock();
 
   // Move some work from this thread's mark stack to the waiting task.
   MOZ_ASSERT(!waitingTask->hasWork());
-  size_t wordsMoved = GCMarker::moveWork(waitingTask->marker, src, true);
+  size_t wordsMoved =
+      GCMarker::moveWork(waitingTask->marker, src->marker, true);
 
   gc->stats().count(gcstats::COUNT_PARALLEL_MARK_INTERRUPTIONS);
 
+  src->stats.ref().donationsSent++;
+  gcstats::ParallelMarkThreadStats& received = waitingTask->stats.ref();
+  received.donationsReceived++;
+  received.wordsReceived += wordsMoved;
+  if (sameZone) {
+    received.zoneAffinityHits++;
+  }
+
   if (profiler.enabled()) {
     char details[32];
     SprintfLiteral(details, "words=%zu", wordsMoved);
@@ -14,6 +14,7 @@
 
 #include "gc/GCMarker.h"
 #include "gc/GCParallelTask.h"
+#include "gc/Statistics.h"
 #include "js/HeapAPI.h"
 #include "js/SliceBudget.h"
 #include "threading/ConditionVariable.h"
@@ -68,9 +69,14 @@ class alignas(TypicalCacheLineSize) ParallelMarkTask : public GCParallelTask {
 
   HelperThreadLockData<bool> isWaiting;
 
-  // Length of time this task spent blocked waiting for work.
-  MainThreadOrGCTaskData<mozilla::TimeDuration> markTime;
-  MainThreadOrGCTaskData<mozilla::TimeDuration> waitTime;
+  // The zone of the work this task was last given. Waiting tasks are
+  // preferentially given more work from the same zone.
+  HelperThreadLockData<JS::Zone*> zoneHint;
+
+  // Time spent marking and blocked waiting for work, and work donated to and
+  // from this task. Counts of work received are updated by the donating thread
+  // while this task is waiting.
+  MainThreadOrGCTaskData<gcstats::ParallelMarkThreadStats> stats;
 };
 
 // Per-runtime parallel marking state.
@@ -81,13 +87,17 @@ class alignas(TypicalCacheLineSize) ParallelMarkTask : public GCParallelTask {
 // This uses a work-requesting approach. Threads mark until they run out of
 // work and then add themselves to a list of waiting tasks and block. Running
 // tasks with enough work may donate work to a waiting task and resume it.
+//
+// Work is donated from the top of the donor's stack, preferably to a waiting
+// task that was last given work from the same zone, to keep that zone's arenas
+// and mark bits in the cache of a single thread.
 class MOZ_STACK_CLASS ParallelMarker {
  public:
   static bool mark(GCRuntime* gc, const JS::SliceBudget& sliceBudget);
 
   bool hasWaitingTasks() const { return !waitingTasks.IsEmpty(); }
 
-  void donateWorkFrom(GCMarker* src);
+  void donateWorkFrom(ParallelMarkTask* src);
 
  private:
   static bool markOneColor(GCRuntime* gc, MarkColor color,
@@ -99,6 +109,8 @@ class MOZ_STACK_CLASS ParallelMarker {
 
   bool hasWork(MarkColor color) const;
 
+  void distributeInitialWork();
+
   void addTask(ParallelMarkTask* task, const AutoLockHelperThreadState& lock);
 
   void addTaskToWaitingList(ParallelMarkTask* task,
@@ -107,7 +119,7 @@ class MOZ_STACK_CLASS ParallelMarker {
   bool isTaskInWaitingList(const ParallelMarkTask* task,
                            const AutoLockHelperThreadState& lock) const;
 #endif
-  ParallelMarkTask* takeWaitingTask();
+  ParallelMarkTask* takeWaitingTask(JS::Zone* zoneHint = nullptr);
 
   bool hasActiveTasks(const AutoLockHelperThreadState& lock) const {
     return !activeTasks.ref().IsEmpty();
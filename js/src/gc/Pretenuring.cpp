@@ -7,13 +7,21 @@
 
 #include "gc/Pretenuring.h"
 
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Sprintf.h"
 
+#include <string.h>
+
+#include "jsfriendapi.h"
+
 #include "gc/GCInternals.h"
 #include "gc/PublicIterators.h"
 #include "jit/BaselineJIT.h"
 #include "jit/Invalidation.h"
+#include "jit/JitScript.h"
 #include "js/Prefs.h"
+#include "vm/JSContext.h"
+#include "vm/ProfileTranscoding.h"
 
 #include "gc/Marking-inl.h"
 #include "gc/PrivateIterators-inl.h"
@@ -207,6 +215,12 @@ AllocSite::SiteResult AllocSite::processSite(
         }
       }
     }
+
+    // Invalidation can reset the state, so check it again here.
+    if (isNormal() && hasScript() &&
+        (prevState == State::LongLived) != (state() == State::LongLived)) {
+      gc->nursery().pretenuringProfile().noteStateChange(this);
+    }
   }
 
   if (reportFilter.matches(*this)) {
@@ -357,8 +371,18 @@ bool AllocSite::maybeResetState() {
     return false;
   }
 
+  bool wasLongLived = state() == State::LongLived;
   invalidationCount++;
   setState(State::Unknown);
+
+  // Sites that are no longer pretenured must not be pretenured by later runs
+  // either. They rarely get back to processSite as long-lived sites have no
+  // nursery allocations, so update the profile here.
+  if (wasLongLived && isNormal() && hasScript()) {
+    GCRuntime* gc = &zone()->runtimeFromMainThread()->gc;
+    gc->nursery().pretenuringProfile().noteStateChange(this);
+  }
+
   return true;
 }
 
@@ -395,6 +419,124 @@ bool AllocSite::needsSweep(JSTracer* trc) const {
   return false;
 }
 
+/* static */
+PretenuringProfile::SiteKey PretenuringProfile::getSiteKey(
+    const AllocSite* site) {
+  // Use the same script key as JitHintsMap. Scripts that have an introducer
+  // filename, such as those created by eval() and new Function(), are likely
+  // to have different source and are excluded.
+  JSScript* script = site->script();
+  HashNumber filenameHash = script->filenameHash();
+  if (!filenameHash || script->scriptSource()->hasIntroducerFilename()) {
+    return 0;
+  }
+
+  HashNumber scriptKey =
+      mozilla::AddToHash(filenameHash, script->sourceStart());
+  return (SiteKey(scriptKey) << 32) | site->pcOffset();
+}
+
+void PretenuringProfile::maybeInitSite(AllocSite* site) const {
+  MOZ_ASSERT(site->isNormal());
+  MOZ_ASSERT(site->state() == AllocSite::State::Unknown);
+  MOZ_ASSERT(!site->hasNurseryAllocations());
+
+  if (longLivedSites_.empty()) {
+    return;
+  }
+
+  SiteKey key = getSiteKey(site);
+  if (key && longLivedSites_.has(key)) {
+    site->setState(AllocSite::State::LongLived);
+  }
+}
+
+void PretenuringProfile::noteStateChange(const AllocSite* site) {
+  MOZ_ASSERT(site->isNormal());
+
+  // Sites created for trial inlining are owned by the outer script's inlining
+  // root rather than its ICScript.
+  JSScript* script = site->script();
+  if (!script->hasJitScript() ||
+      !script->jitScript()->icScript()->hasAllocSite(site)) {
+    return;
+  }
+
+  SiteKey key = getSiteKey(site);
+  if (!key) {
+    return;
+  }
+
+  if (site->state() != AllocSite::State::LongLived) {
+    longLivedSites_.remove(key);
+    return;
+  }
+
+  // The profile is only a hint so ignore OOM.
+  if (longLivedSites_.count() < MaxEntries) {
+    (void)longLivedSites_.put(key);
+  }
+}
+
+// The encoding uses the native byte order and is:
+//
+//   uint32_t magic, version
+//   uint32_t siteCount
+//   uint64_t sites[siteCount]
+bool PretenuringProfile::encode(JS::TranscodeBuffer& buffer) const {
+  ProfileWriter writer(buffer, EncodingMagic, EncodingVersion);
+  writer.writeUint32(count());
+  for (auto iter = longLivedSites_.iter(); !iter.done(); iter.next()) {
+    writer.writeUint64(iter.get());
+  }
+  return writer.ok();
+}
+
+bool PretenuringProfile::decode(const JS::TranscodeRange& range) {
+  ProfileReader reader(range);
+  uint32_t siteCount;
+  const uint8_t* sites;
+  if (!reader.readHeader(EncodingMagic, EncodingVersion) ||
+      !reader.readUint32(&siteCount) || siteCount > MaxEntries ||
+      !reader.readBytes(&sites, siteCount * sizeof(SiteKey)) ||
+      !reader.done()) {
+    return false;
+  }
+
+  // Reserve space first so that we either merge all sites or none.
+  if (!longLivedSites_.reserve(longLivedSites_.count() + siteCount)) {
+    return false;
+  }
+
+  for (uint32_t i = 0; i < siteCount; i++) {
+    SiteKey key;
+    memcpy(&key, sites + i * sizeof(key), sizeof(key));
+    if (key && !longLivedSites_.has(key)) {
+      longLivedSites_.putNewInfallible(key);
+    }
+  }
+
+  return true;
+}
+
+JS_PUBLIC_API bool js::EncodePretenuringProfile(JSContext* cx,
+                                                JS::TranscodeBuffer& buffer) {
+  MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+
+  if (!cx->runtime()->gc.nursery().pretenuringProfile().encode(buffer)) {
+    ReportOutOfMemory(cx);
+    return false;
+  }
+  return true;
+}
+
+JS_PUBLIC_API bool js::DecodePretenuringProfile(
+    JSContext* cx, const JS::TranscodeRange& range) {
+  MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+
+  return cx->runtime()->gc.nursery().pretenuringProfile().decode(range);
+}
+
 bool PretenuringZone::calculateYoungTenuredSurvivalRate(double* rateOut) {
   MOZ_ASSERT(allocCountInNewlyCreatedArenas >=
              survivorCountInNewlyCreatedArenas);
@@ -22,6 +22,9 @@
 #include <algorithm>
 
 #include "gc/AllocKind.h"
+#include "js/AllocPolicy.h"
+#include "js/HashTable.h"
+#include "js/Transcoding.h"
 #include "js/TypeDecls.h"
 
 class JS_PUBLIC_API JSTracer;
@@ -35,6 +38,7 @@ namespace js::gc {
 struct AllocSiteFilter;
 class GCRuntime;
 class PretenuringNursery;
+class PretenuringProfile;
 
 // Number of trace kinds supportd by the nursery. These are arranged at the
 // start of JS::TraceKind.
@@ -122,6 +126,7 @@ class AllocSite {
 
   friend class PretenuringZone;
   friend class PretenuringNursery;
+  friend class PretenuringProfile;
 
   uintptr_t rawScript() const { return scriptAndState & ~STATE_MASK; }
 
@@ -402,6 +407,54 @@ class PretenuringZone {
   }
 };
 
+// Pretenuring decisions that can be carried over to a later process.
+//
+// When a site is pretenured its location is recorded here, keyed by its
+// script's filename hash and source start (as for JIT hints, see [SMDOC]
+// JitHintsMap) and its bytecode offset. Sites created later for the same
+// location start out long-lived rather than waiting for nursery collections to
+// find out again that their allocations survive. Locations are forgotten when
+// their site stops being long-lived, either after a minor GC or when the site
+// is reset (see AllocSite::maybeResetState).
+//
+// Sites created for trial inlining have bytecode offsets in the inlined script
+// and are neither recorded nor initialized from the profile.
+class PretenuringProfile {
+ public:
+  // The script key in the high 32 bits and the bytecode offset in the low 32
+  // bits, or zero if the script can't be identified.
+  using SiteKey = uint64_t;
+  static SiteKey getSiteKey(const AllocSite* site);
+
+ private:
+  using SiteSet = HashSet<SiteKey, DefaultHasher<SiteKey>, SystemAllocPolicy>;
+  SiteSet longLivedSites_;
+
+  static constexpr size_t MaxEntries = 10000;
+
+ public:
+  // Persistent format, see |encode| and |decode|.
+  static constexpr uint32_t EncodingMagic = 0x524e5450;  // 'PTNR'
+  static constexpr uint32_t EncodingVersion = 1;
+
+  size_t count() const { return longLivedSites_.count(); }
+
+  // Called when a site for an outer script is created.
+  void maybeInitSite(AllocSite* site) const;
+
+  // Called when a site's state changes to or from LongLived, either in
+  // AllocSite::processSite or AllocSite::maybeResetState.
+  void noteStateChange(const AllocSite* site);
+
+  // Serialize the recorded sites into |buffer|.
+  bool encode(JS::TranscodeBuffer& buffer) const;
+
+  // Merge sites previously produced by |encode| into this profile. Returns
+  // false without modifying the profile if the buffer is malformed or was
+  // produced by an incompatible version, and false on OOM.
+  bool decode(const JS::TranscodeRange& range);
+};
+
 // Pretenuring information stored as part of the the GC nursery.
 class PretenuringNursery {
   AllocSite* allocatedSites;
@@ -410,9 +463,13 @@ class PretenuringNursery {
 
   uint32_t totalAllocCount_ = 0;
 
+  PretenuringProfile profile_;
+
  public:
   PretenuringNursery() : allocatedSites(AllocSite::EndSentinel) {}
 
+  PretenuringProfile& profile() { return profile_; }
+
   bool hasAllocatedSites() const {
     return allocatedSites != AllocSite::EndSentinel;
   }
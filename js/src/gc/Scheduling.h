@@ -509,6 +509,12 @@
     nurseryMaxTimeGoalMS, ConvertMillis, NoCheck,                              \
     mozilla::TimeDuration::FromMilliseconds(4))                                \
                                                                                \
+  /*                                                                           \
+   * JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED                                   \
+   */                                                                          \
+  _(JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED, bool,                             \
+    nurseryCacheAwareSizingEnabled, ConvertBool, NoCheck, true)                \
+                                                                               \
   /*                                                                           \
    * JSGC_STORE_BUFFER_ENTRIES                                                 \
    * JSGC_STORE_BUFFER_SCALING                                                 \
@@ -468,6 +468,13 @@ UniqueChars Statistics::formatDetailedMessage() const {
       }
     }
   }
+  if (!parallelMarkThreads.empty() &&
+      !fragments.append(formatDetailedParallelMarkThreads())) {
+    return UniqueChars(nullptr);
+  }
+  if (!fragments.append(formatDetailedFinalizedCells())) {
+    return UniqueChars(nullptr);
+  }
   if (!fragments.append(formatDetailedTotals())) {
     return UniqueChars(nullptr);
   }
@@ -605,6 +612,51 @@ UniqueChars Statistics::formatDetailedTotals() const {
   return DuplicateString(buffer);
 }
 
+UniqueChars Statistics::formatDetailedParallelMarkThreads() const {
+  FragmentVector fragments;
+  if (!fragments.append(DuplicateString("  ---- Parallel Marking ----\n"))) {
+    return UniqueChars(nullptr);
+  }
+
+  char buffer[256];
+  for (size_t i = 0; i < parallelMarkThreads.length(); i++) {
+    const ParallelMarkThreadStats& thread = parallelMarkThreads[i];
+    SprintfLiteral(buffer,
+                   "    Thread %zu: Mark: %.3fms Wait: %.3fms Donated: %" PRIu32
+                   " Received: %" PRIu32 " (%zu words, %" PRIu32
+                   " same zone)\n",
+                   i, t(thread.markTime), t(thread.waitTime),
+                   thread.donationsSent, thread.donationsReceived,
+                   thread.wordsReceived, thread.zoneAffinityHits);
+    if (!fragments.append(DuplicateString(buffer))) {
+      return UniqueChars(nullptr);
+    }
+  }
+  return Join(fragments);
+}
+
+UniqueChars Statistics::formatDetailedFinalizedCells() const {
+  FragmentVector fragments;
+  if (!fragments.append(DuplicateString("  ---- Finalized Cells ----\n"))) {
+    return UniqueChars(nullptr);
+  }
+
+  char buffer[128];
+  for (auto kind : AllAllocKinds()) {
+    uint32_t count = getFinalizedCells(kind);
+    if (!count) {
+      continue;
+    }
+    SprintfLiteral(buffer, "    %s: %" PRIu32 " (%s)\n", AllocKindName(kind),
+                   count,
+                   IsForegroundFinalized(kind) ? "foreground" : "background");
+    if (!fragments.append(DuplicateString(buffer))) {
+      return UniqueChars(nullptr);
+    }
+  }
+  return Join(fragments);
+}
+
 void Statistics::formatJsonSlice(size_t sliceNum, JSONPrinter& json) const {
   /*
    * We number each of the slice properties to keep the code in
@@ -725,6 +777,42 @@ void Statistics::formatJsonDescription(JSONPrinter& json) const {
   if (removedChunks) {
     json.property("removed_chunks", removedChunks);
   }
+  uint32_t foregroundFinalized = 0;
+  uint32_t backgroundFinalized = 0;
+  for (auto kind : AllAllocKinds()) {
+    uint32_t count = getFinalizedCells(kind);
+    if (IsForegroundFinalized(kind)) {
+      foregroundFinalized += count;
+    } else {
+      backgroundFinalized += count;
+    }
+  }
+  if (foregroundFinalized || backgroundFinalized) {
+    json.beginObjectProperty("finalized_cells");
+    for (auto kind : AllAllocKinds()) {
+      uint32_t count = getFinalizedCells(kind);
+      if (count) {
+        json.property(AllocKindName(kind), count);
+      }
+    }
+    json.endObject();
+    json.property("foreground_finalized_cells", foregroundFinalized);
+    json.property("background_finalized_cells", backgroundFinalized);
+  }
+  if (!parallelMarkThreads.empty()) {
+    json.beginListProperty("parallel_mark_threads");
+    for (const ParallelMarkThreadStats& thread : parallelMarkThreads) {
+      json.beginObject();
+      json.property("mark", thread.markTime, JSONPrinter::MILLISECONDS);
+      json.property("wait", thread.waitTime, JSONPrinter::MILLISECONDS);
+      json.property("donations_sent", thread.donationsSent);
+      json.property("donations_received", thread.donationsReceived);
+      json.property("words_received", thread.wordsReceived);
+      json.property("zone_affinity_hits", thread.zoneAffinityHits);
+      json.endObject();
+    }
+    json.endList();
+  }
   json.property("major_gc_number", startingMajorGCNumber);
   json.property("minor_gc_number", startingMinorGCNumber);
   json.property("slice_number", startingSliceNumber);
@@ -793,6 +881,10 @@ Statistics::Statistics(GCRuntime* gc)
     count = 0;
   }
 
+  for (auto& count : finalizedCells) {
+    count = 0;
+  }
+
   for (auto& stat : stats) {
     stat = 0;
   }
@@ -991,6 +1083,13 @@ void Statistics::beginGC(JS::GCOptions options, const TimeStamp& currentTime) {
 
   totalGCTime_ = TimeDuration::Zero();
 
+  // Background finalization of the previous GC has finished by now, so its
+  // counts can be cleared. They are not cleared at the end of a GC, as
+  // background finalization may still be adding to them then.
+  for (auto& count : finalizedCells) {
+    count = 0;
+  }
+
   preTotalGCHeapBytes = 0;
   postTotalGCHeapBytes = 0;
   preCollectedGCHeapBytes = 0;
@@ -1287,6 +1386,7 @@ void Statistics::endSlice() {
     for (auto& count : counts) {
       count = 0;
     }
+    parallelMarkThreads.clear();
 
     // Clear the timers at the end of a GC, preserving the data for
     // PhaseKind::MUTATOR.
@@ -1547,6 +1647,25 @@ void Statistics::recordParallelPhase(PhaseKind phaseKind,
   maxTime = std::max(maxTime, duration);
 }
 
+void Statistics::recordParallelMarkThread(
+    size_t index, const ParallelMarkThreadStats& threadStats) {
+  MOZ_ASSERT(CurrentThreadCanAccessRuntime(gc->rt));
+
+  // These statistics are informational, so ignore OOM.
+  if (index >= parallelMarkThreads.length() &&
+      !parallelMarkThreads.resize(index + 1)) {
+    return;
+  }
+
+  ParallelMarkThreadStats& total = parallelMarkThreads[index];
+  total.markTime += threadStats.markTime;
+  total.waitTime += threadStats.waitTime;
+  total.donationsSent += threadStats.donationsSent;
+  total.donationsReceived += threadStats.donationsReceived;
+  total.wordsReceived += threadStats.wordsReceived;
+  total.zoneAffinityHits += threadStats.zoneAffinityHits;
+}
+
 TimeStamp Statistics::beginSCC() { return TimeStamp::Now(); }
 
 void Statistics::endSCC(unsigned scc, TimeStamp start) {
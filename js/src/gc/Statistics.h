@@ -16,6 +16,7 @@
 #include "jspubtd.h"
 #include "NamespaceImports.h"
 
+#include "gc/AllocKind.h"
 #include "gc/GCEnum.h"
 #include "js/AllocPolicy.h"
 #include "js/GCAPI.h"
@@ -104,6 +105,22 @@ struct Trigger {
   size_t threshold = 0;
 };
 
+// Statistics for one parallel marking thread, accumulated over a major GC.
+struct ParallelMarkThreadStats {
+  mozilla::TimeDuration markTime;
+  mozilla::TimeDuration waitTime;
+
+  // Number of times this thread gave work to or received work from another.
+  uint32_t donationsSent = 0;
+  uint32_t donationsReceived = 0;
+
+  // Number of mark stack words received from other threads.
+  size_t wordsReceived = 0;
+
+  // Number of donations received for a zone this thread was already marking.
+  uint32_t zoneAffinityHits = 0;
+};
+
 #define FOR_EACH_GC_PROFILE_TIME(_)                                 \
   _(Total, "total", PhaseKind::NONE)                                \
   _(Background, "bgwrk", PhaseKind::NONE)                           \
@@ -162,6 +179,8 @@ struct Statistics {
   void beginPhase(PhaseKind phaseKind);
   void endPhase(PhaseKind phaseKind);
   void recordParallelPhase(PhaseKind phaseKind, TimeDuration duration);
+  void recordParallelMarkThread(size_t index,
+                                const ParallelMarkThreadStats& threadStats);
 
   // Occasionally, we may be in the middle of something that is tracked by
   // this class, and we need to do something unusual (eg evict the nursery)
@@ -218,6 +237,14 @@ struct Statistics {
 
   uint32_t getCount(Count s) const { return uint32_t(counts[s]); }
 
+  // Called from both foreground and background sweeping.
+  void addFinalizedCells(gc::AllocKind kind, size_t count) {
+    finalizedCells[kind] += uint32_t(count);
+  }
+  uint32_t getFinalizedCells(gc::AllocKind kind) const {
+    return uint32_t(finalizedCells[kind]);
+  }
+
   void setStat(Stat s, uint32_t value) { stats[s] = value; }
 
   uint32_t getStat(Stat s) const { return stats[s]; }
@@ -367,9 +394,21 @@ struct Statistics {
                   COUNT_LIMIT>
       counts;
 
+  /*
+   * Number of dead cells finalized for each alloc kind for this GC. Counts for
+   * background finalized kinds may still grow after the GC ends.
+   */
+  EnumeratedArray<gc::AllocKind,
+                  mozilla::Atomic<uint32_t, mozilla::ReleaseAcquire>,
+                  gc::AllocKind::LIMIT>
+      finalizedCells;
+
   /* Other GC statistics. */
   EnumeratedArray<Stat, uint32_t, STAT_LIMIT> stats;
 
+  /* Per-thread parallel marking statistics for this GC. */
+  Vector<ParallelMarkThreadStats, 0, SystemAllocPolicy> parallelMarkThreads;
+
   /*
    * These events cannot be kept in the above array, we need to take their
    * address.
@@ -479,6 +518,8 @@ struct Statistics {
                                              const SliceData& slice) const;
   UniqueChars formatDetailedPhaseTimes(const PhaseTimes& phaseTimes) const;
   UniqueChars formatDetailedTotals() const;
+  UniqueChars formatDetailedParallelMarkThreads() const;
+  UniqueChars formatDetailedFinalizedCells() const;
 
   void formatJsonDescription(JSONPrinter&) const;
   void formatJsonSliceDescription(unsigned i, const SliceData& slice,
@@ -119,7 +119,7 @@ static constexpr size_t ArenaReleaseBatchSize = 32;
 
 template <typename T, FinalizeKind finalizeKind>
 inline size_t Arena::finalize(JS::GCContext* gcx, AllocKind thingKind,
-                              size_t thingSize) {
+                              size_t thingSize, size_t* nfinalizedOut) {
   /* Enforce requirements on size of T. */
   MOZ_ASSERT(thingSize % CellAlignBytes == 0);
   MOZ_ASSERT(thingSize >= MinCellSize);
@@ -192,6 +192,7 @@ inline size_t Arena::finalize(JS::GCContext* gcx, AllocKind thingKind,
   MOZ_ASSERT(nfree + nmarked == thingsPerArena(thingKind));
 #endif
 
+  *nfinalizedOut = nfinalized;
   return nmarked;
 }
 
@@ -208,19 +209,24 @@ static inline bool FinalizeTypedArenas(JS::GCContext* gcx, ArenaList& src,
   size_t thingSize = Arena::thingSize(thingKind);
   size_t thingsPerArena = Arena::thingsPerArena(thingKind);
   size_t markCount = 0;
+  size_t finalizedCount = 0;
   size_t emptyCount = 0;
 
   GCRuntime* gc = &gcx->runtimeFromAnyThread()->gc;
-  auto updateMarkCount = mozilla::MakeScopeExit(
-      [&] { gc->stats().addCount(gcstats::COUNT_CELLS_MARKED, markCount); });
+  auto updateCounts = mozilla::MakeScopeExit([&] {
+    gc->stats().addCount(gcstats::COUNT_CELLS_MARKED, markCount);
+    gc->stats().addFinalizedCells(thingKind, finalizedCount);
+  });
 
   while (!src.isEmpty()) {
     Arena* arena = src.popFront();
-    size_t nmarked =
-        arena->finalize<T, finalizeKind>(gcx, thingKind, thingSize);
+    size_t nfinalized;
+    size_t nmarked = arena->finalize<T, finalizeKind>(gcx, thingKind,
+                                                      thingSize, &nfinalized);
     size_t nfree = thingsPerArena - nmarked;
 
     markCount += nmarked;
+    finalizedCount += nfinalized;
 
     dest.insertAt(arena, nfree);
 
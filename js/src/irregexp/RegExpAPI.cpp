@@ -33,6 +33,7 @@
 #include "js/friend/ErrorMessages.h"  // JSMSG_*
 #include "js/friend/StackLimits.h"    // js::ReportOverRecursed
 #include "util/StringBuilder.h"
+#include "util/Unicode.h"
 #include "vm/MatchPairs.h"
 #include "vm/PlainObject.h"
 #include "vm/RegExpShared.h"
@@ -54,6 +55,7 @@ using v8::internal::HandleScope;
 using v8::internal::InputOutputData;
 using v8::internal::IrregexpInterpreter;
 using v8::internal::NativeRegExpMacroAssembler;
+using v8::internal::RegExpAtom;
 using v8::internal::RegExpBytecodeGenerator;
 using v8::internal::RegExpCapture;
 using v8::internal::RegExpCompileData;
@@ -63,7 +65,9 @@ using v8::internal::RegExpMacroAssembler;
 using v8::internal::RegExpMacroAssemblerTracer;
 using v8::internal::RegExpNode;
 using v8::internal::RegExpParser;
+using v8::internal::RegExpTree;
 using v8::internal::SMRegExpMacroAssembler;
+using v8::internal::TextElement;
 using v8::internal::Zone;
 using v8::internal::ZoneVector;
 
@@ -388,6 +392,26 @@ static bool UseBoyerMoore(Handle<JSAtom*> pattern, JS::AutoAssertNoGC& nogc) {
   return HasFewDifferentCharacters(pattern->twoByteChars(nogc), length);
 }
 
+// If every match of |tree| starts with the same literal characters, return the
+// atom holding them. Only captures are looked through, because other groups
+// may change flags such as ignoreCase.
+static RegExpAtom* RequiredPrefix(RegExpTree* tree) {
+  while (true) {
+    if (tree->IsCapture()) {
+      tree = tree->AsCapture()->body();
+    } else if (tree->IsAlternative()) {
+      tree = tree->AsAlternative()->nodes()->at(0);
+    } else if (tree->IsText()) {
+      TextElement& first = tree->AsText()->elements()->at(0);
+      return first.text_type() == TextElement::ATOM ? first.atom() : nullptr;
+    } else if (tree->IsAtom()) {
+      return tree->AsAtom();
+    } else {
+      return nullptr;
+    }
+  }
+}
+
 // Sample character frequency information for use in Boyer-Moore.
 static void SampleCharacters(Handle<JSLinearString*> sample_subject,
                              RegExpCompiler& compiler) {
@@ -768,6 +792,38 @@ bool CompilePattern(JSContext* cx, MutableHandleRegExpShared re,
                     RegExpShared::CodeKind codeKind) {
   Rooted<JSAtom*> pattern(cx, re->getSource());
   JS::RegExpFlags flags = re->getFlags();
+  bool isLatin1 = input->hasLatin1Chars();
+
+  // Another zone may already have compiled bytecode for this regexp. Cached
+  // regexps never use atom matching or named captures, so a hit lets us skip
+  // parsing as well.
+  RegExpBytecodeCache& bytecodeCache =
+      cx->runtime()->caches().regExpBytecodeCache;
+  if (codeKind == RegExpShared::CodeKind::Bytecode) {
+    RegExpBytecodeCache::Compilation cached;
+    if (bytecodeCache.lookup(pattern, flags, isLatin1, &cached)) {
+      if (re->kind() == RegExpShared::Kind::Unparsed) {
+        Rooted<JSAtom*> requiredPrefix(cx);
+        if (cached.requiredPrefix) {
+          requiredPrefix = AtomizeChars(cx, cached.requiredPrefix.get(),
+                                        cached.requiredPrefixLength);
+          if (!requiredPrefix) {
+            return false;
+          }
+        }
+        re->useRegExpMatch(cached.pairCount, requiredPrefix);
+      }
+      MOZ_ASSERT(re->kind() == RegExpShared::Kind::RegExp);
+      MOZ_ASSERT(re->pairCount() == cached.pairCount);
+      MOZ_ASSERT(re->numNamedCaptures() == 0);
+      re->updateMaxRegisters(cached.maxRegisters);
+      uint32_t length = cached.byteCode->length();
+      re->setByteCode(cached.byteCode.release(), isLatin1);
+      js::AddCellMemory(re, length, MemoryUse::RegExpSharedBytecode);
+      return true;
+    }
+  }
+
   LifoAllocScope allocScope(&cx->tempLifoAlloc());
   HandleScope handleScope(cx->isolate);
   Zone zone(allocScope.alloc());
@@ -796,6 +852,7 @@ bool CompilePattern(JSContext* cx, MutableHandleRegExpShared re,
     // This is the first time we have compiled this regexp.
     // First, check to see if we should use simple string search
     // with an atom.
+    Rooted<JSAtom*> requiredPrefix(cx);
     if (!flags.ignoreCase() && !flags.sticky()) {
       Rooted<JSAtom*> searchAtom(cx);
       if (data.simple) {
@@ -803,17 +860,33 @@ bool CompilePattern(JSContext* cx, MutableHandleRegExpShared re,
         searchAtom = re->getSource();
       } else if (data.tree->IsAtom() && data.capture_count == 0) {
         // The parse-tree is a single atom that is not equal to the pattern.
-        v8::internal::RegExpAtom* atom = data.tree->AsAtom();
+        RegExpAtom* atom = data.tree->AsAtom();
         const char16_t* twoByteChars = atom->data().begin();
         searchAtom = AtomizeChars(cx, twoByteChars, atom->length());
         if (!searchAtom) {
           return false;
         }
       }
-      JS::AutoAssertNoGC nogc(cx);
-      if (searchAtom && !UseBoyerMoore(searchAtom, nogc)) {
-        re->useAtomMatch(searchAtom);
-        return true;
+      {
+        JS::AutoAssertNoGC nogc(cx);
+        if (searchAtom && !UseBoyerMoore(searchAtom, nogc)) {
+          re->useAtomMatch(searchAtom);
+          return true;
+        }
+      }
+
+      // Otherwise, look for literal characters that every match starts with,
+      // so that execution can search for them before running the matcher.
+      // Skip prefixes starting with a surrogate, because unicode regexps may
+      // start matching in the middle of a surrogate pair.
+      RegExpAtom* prefix = RequiredPrefix(data.tree);
+      if (prefix && prefix->length() > 0 &&
+          !unicode::IsSurrogate(prefix->data()[0])) {
+        requiredPrefix =
+            AtomizeChars(cx, prefix->data().begin(), prefix->length());
+        if (!requiredPrefix) {
+          return false;
+        }
       }
     }
     if (data.named_captures) {
@@ -824,15 +897,13 @@ bool CompilePattern(JSContext* cx, MutableHandleRegExpShared re,
     // All fallible initialization has succeeded, so we can change state.
     // Add one to capture_count to account for the whole-match capture.
     uint32_t pairCount = data.capture_count + 1;
-    re->useRegExpMatch(pairCount);
+    re->useRegExpMatch(pairCount, requiredPrefix);
   }
 
   MOZ_ASSERT(re->kind() == RegExpShared::Kind::RegExp);
 
   RegExpCompiler compiler(cx->isolate, &zone, data.capture_count, flags,
-                          input->hasLatin1Chars());
-
-  bool isLatin1 = input->hasLatin1Chars();
+                          isLatin1);
 
   SampleCharacters(input, compiler);
   data.node = compiler.PreprocessRegExp(&data, isLatin1);
@@ -864,6 +935,12 @@ bool CompilePattern(JSContext* cx, MutableHandleRegExpShared re,
     case AssembleResult::Success:
       break;
   }
+
+  if (!useNativeCode && !data.named_captures) {
+    bytecodeCache.maybePut(pattern, flags, isLatin1, re->pairCount(),
+                           re->getMaxRegisters(), re->requiredPrefix(),
+                           re->getByteCode(isLatin1));
+  }
   return true;
 }
 
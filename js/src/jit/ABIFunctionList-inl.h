@@ -169,6 +169,7 @@ namespace jit {
   _(js::jit::InvokeFromInterpreterStub)                                        \
   _(js::jit::LazyLinkTopActivation)                                            \
   _(js::jit::LinearizeForCharAccessPure)                                       \
+  _(js::jit::MapObjectLookupProbed)                                            \
   _(js::jit::ObjectHasGetterSetterPure)                                        \
   _(js::jit::ObjectIsCallable)                                                 \
   _(js::jit::ObjectIsConstructor)                                              \
@@ -178,6 +179,7 @@ namespace jit {
   _(js::jit::PreserveWrapper)                                                  \
   _(js::jit::Printf0)                                                          \
   _(js::jit::Printf1)                                                          \
+  _(js::jit::SetObjectLookupProbed)                                            \
   _(js::jit::StringFromCharCodeNoGC)                                           \
   _(js::jit::StringTrimEndIndex)                                               \
   _(js::jit::StringTrimStartIndex)                                             \
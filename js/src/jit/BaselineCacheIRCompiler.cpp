@@ -2464,6 +2464,24 @@ void DumpNonAOTICStubAndQuit(CacheKind kind, const CacheIRWriter& writer) {
     abort();
   }
 }
+
+static void RecordAttachedStubForAOT(JSContext* cx, CacheKind kind,
+                                     const CacheIRWriter& writer) {
+  JSRuntime* rt = cx->runtime();
+  if (!rt->aotICRecorder) {
+    AOTICRecorder* recorder = js_new<AOTICRecorder>();
+    if (!recorder || !recorder->init(cx)) {
+      // Recording is a best-effort debugging aid; give up on OOM rather than
+      // disturbing the workload.
+      js_delete(recorder);
+      JitOptions.recordAOTICs = false;
+      fprintf(stderr, "AOT IC recorder: out of memory, recording disabled.\n");
+      return;
+    }
+    rt->aotICRecorder = recorder;
+  }
+  rt->aotICRecorder->recordAttach(kind, writer);
+}
 #endif
 
 static constexpr uint32_t StubDataOffset = sizeof(ICCacheIRStub);
@@ -2710,6 +2728,13 @@ ICAttachResult js::jit::AttachBaselineCacheIRStub(
                                ? icScript->inliningRoot()->owningScript()
                                : outerScript;
   owningScript->updateLastICStubCounter();
+
+#ifdef ENABLE_JS_AOT_ICS
+  if (JitOptions.recordAOTICs) {
+    RecordAttachedStubForAOT(cx, kind, writer);
+  }
+#endif
+
   return ICAttachResult::Attached;
 }
 
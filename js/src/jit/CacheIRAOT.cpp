@@ -8,13 +8,21 @@
 
 #  include "jit/CacheIRAOT.h"
 
+#  include "mozilla/HashFunctions.h"
+
+#  include <algorithm>
+#  include <stdio.h>
+#  include <stdlib.h>
+
 #  include "jsmath.h"
 #  include "jstypes.h"
 
 #  include "gc/AllocKind.h"
 #  include "jit/CacheIR.h"
 #  include "jit/CacheIRAOTGenerated.h"
+#  include "jit/CacheIRSpewer.h"
 #  include "jit/JitZone.h"
+#  include "js/Printer.h"
 #  include "js/ScalarType.h"
 #  include "js/Value.h"
 #  include "vm/CompletionKind.h"
@@ -95,6 +103,12 @@ JS_AOT_IC_DATA(IC_STUBFIELD)
 
 JS_AOT_IC_DATA(IC_LASTUSED)
 
+// Generate the corpus file names.
+
+#  define IC_FILE(idx, name) static const char IC##idx##File[] = name;
+
+JS_AOT_IC_FILES(IC_FILE)
+
 // Now, generate the toplevel list of AOT structs from which we can
 // reconstitute a CacheIRWriter.
 
@@ -112,7 +126,8 @@ JS_AOT_IC_DATA(IC_LASTUSED)
         sizeof(IC##idx##StubFields) / sizeof(IC##idx##StubFields[0]),   \
         IC##idx##LastUsed,                                              \
         IC##idx,                                                        \
-        sizeof(IC##idx)},
+        sizeof(IC##idx),                                                \
+        IC##idx##File},
 
 static const CacheIRAOTStub stubs[] = {JS_AOT_IC_DATA(IC_TOP)};
 
@@ -143,4 +158,128 @@ CacheIRWriter::CacheIRWriter(JSContext* cx, const CacheIRAOTStub& stub)
   buffer_.writeBytes(stub.data, stub.dataLength);
 }
 
+static JS::UniqueChars AOTBodyText(CacheKind kind,
+                                    const CacheIRWriter& writer) {
+  Sprinter sp(nullptr, /* shouldReportOOM = */ false);
+  if (!sp.init()) {
+    return nullptr;
+  }
+  SpewCacheIROpsAsAOT(sp, kind, writer);
+  return sp.release();
+}
+
+AOTICRecorder::Entry* AOTICRecorder::lookupOrAdd(JS::UniqueChars body,
+                                                 const char* corpusFile) {
+  EntryIndex::AddPtr p = index_.lookupForAdd(body.get());
+  if (p) {
+    return &entries_[p->value()];
+  }
+
+  const char* key = body.get();
+  if (!entries_.emplaceBack(std::move(body), corpusFile)) {
+    return nullptr;
+  }
+  if (!index_.add(p, key, entries_.length() - 1)) {
+    entries_.popBack();
+    return nullptr;
+  }
+  return &entries_.back();
+}
+
+bool AOTICRecorder::init(JSContext* cx) {
+  for (const CacheIRAOTStub& stub : GetAOTStubs()) {
+    CacheIRWriter writer(cx, stub);
+    if (writer.failed()) {
+      return false;
+    }
+    JS::UniqueChars body = AOTBodyText(stub.kind, writer);
+    if (!body || !lookupOrAdd(std::move(body), stub.file)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void AOTICRecorder::recordAttach(CacheKind kind, const CacheIRWriter& writer) {
+  JS::UniqueChars body = AOTBodyText(kind, writer);
+  Entry* entry = body ? lookupOrAdd(std::move(body), /* corpusFile = */ nullptr)
+                      : nullptr;
+  if (!entry) {
+    incomplete_ = true;
+    return;
+  }
+  entry->hits++;
+}
+
+void AOTICRecorder::writeFiles(const char* dir) const {
+  if (entries_.empty()) {
+    return;
+  }
+
+  Vector<size_t, 0, SystemAllocPolicy> ranking;
+  if (!ranking.reserve(entries_.length())) {
+    fprintf(stderr, "AOT IC recorder: out of memory, nothing written.\n");
+    return;
+  }
+  for (size_t i = 0; i < entries_.length(); i++) {
+    ranking.infallibleAppend(i);
+  }
+  std::stable_sort(ranking.begin(), ranking.end(), [this](size_t a, size_t b) {
+    return entries_[a].hits > entries_[b].hits;
+  });
+
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/aot-ics-report.txt", dir);
+  FILE* report = fopen(path, "a");
+  if (!report) {
+    fprintf(stderr, "AOT IC recorder: can't open '%s'.\n", path);
+    return;
+  }
+
+  fprintf(report, "# hits\tsource\tfile%s\n",
+          incomplete_ ? " (incomplete: some stubs were not recorded)" : "");
+
+  uint32_t newBodies = 0;
+  uint32_t corpusBodies = 0;
+  uint32_t unusedCorpusBodies = 0;
+  for (size_t i : ranking) {
+    const Entry& entry = entries_[i];
+    if (entry.corpusFile) {
+      fprintf(report, "%u\tcorpus\t%s\n", entry.hits, entry.corpusFile);
+      corpusBodies++;
+      if (entry.hits == 0) {
+        unusedCorpusBodies++;
+      }
+      continue;
+    }
+
+    size_t length = strlen(entry.body.get());
+    char filename[64];
+    snprintf(filename, sizeof(filename), "IC-rec-%08x%08x",
+             mozilla::HashString(entry.body.get(), length), uint32_t(length));
+    fprintf(report, "%u\tnew\t%s\n", entry.hits, filename);
+
+    snprintf(path, sizeof(path), "%s/%s", dir, filename);
+    FILE* file = fopen(path, "w");
+    if (!file) {
+      fprintf(stderr, "AOT IC recorder: can't open '%s'.\n", path);
+      continue;
+    }
+    fwrite(entry.body.get(), 1, length, file);
+    fclose(file);
+    newBodies++;
+  }
+
+  fprintf(report, "# %u of %u corpus bodies were never attached\n",
+          unusedCorpusBodies, corpusBodies);
+  fclose(report);
+  fprintf(stderr, "AOT IC recorder: wrote %u new IC bodies to '%s'.\n",
+          newBodies, dir);
+}
+
+void AOTICRecorder::finish() const {
+  const char* dir = getenv("AOT_ICS_RECORD_DIR");
+  writeFiles(dir ? dir : ".");
+}
+
 #endif /* ENABLE_JS_AOT_ICS */
@@ -7,10 +7,14 @@
 #ifndef jit_CacheIRAOT_h
 #define jit_CacheIRAOT_h
 
+#include "mozilla/HashTable.h"
 #include "mozilla/Span.h"
 
 #include "jit/CacheIR.h"
 #include "jit/CacheIRWriter.h"
+#include "js/HashTable.h"
+#include "js/UniquePtr.h"
+#include "js/Vector.h"
 
 struct JSContext;
 
@@ -36,11 +40,64 @@ struct CacheIRAOTStub {
   const uint32_t* operandLastUsed;  // length: numOperandIds
   const uint8_t* data;
   size_t dataLength;
+  const char* file;  // Name of the corpus file in js/src/ics/.
 };
 
 mozilla::Span<const CacheIRAOTStub> GetAOTStubs();
 void FillAOTICs(JSContext* cx, JitZone* zone);
 
+// Records the IC bodies attached by Baseline while running a workload, so
+// that they can be added to the AOT corpus in js/src/ics/. Enabled with
+// --record-aot-ics; each runtime lazily creates its own recorder.
+//
+// Bodies are deduplicated by their AOT text form (see SpewCacheIROpsAsAOT),
+// which does not include stub field values. When the runtime is destroyed,
+// every body that is not already in the corpus is written to its own
+// IC-rec-* file (named after a hash of its contents, so repeated runs
+// converge on the same files), and a report listing all bodies ranked by how
+// many times they were attached is appended to aot-ics-report.txt. Corpus
+// bodies are listed under their corpus file name, and the ones that were
+// never attached are listed with a zero count, which helps pruning the
+// corpus.
+//
+// The files are written to the directory named by the AOT_ICS_RECORD_DIR
+// environment variable, or to the current directory.
+class AOTICRecorder {
+  struct Entry {
+    JS::UniqueChars body;
+    uint32_t hits = 0;
+
+    // The corpus file this body was loaded from, or null for new bodies.
+    const char* corpusFile = nullptr;
+
+    Entry(JS::UniqueChars body, const char* corpusFile)
+        : body(std::move(body)), corpusFile(corpusFile) {}
+  };
+
+  // Keys point into the |body| strings owned by |entries_|.
+  using EntryIndex = HashMap<const char*, size_t, mozilla::CStringHasher,
+                             SystemAllocPolicy>;
+
+  Vector<Entry, 0, SystemAllocPolicy> entries_;
+  EntryIndex index_;
+
+  // Set if a body could not be recorded, in which case the report is marked
+  // as incomplete.
+  bool incomplete_ = false;
+
+  Entry* lookupOrAdd(JS::UniqueChars body, const char* corpusFile);
+  void writeFiles(const char* dir) const;
+
+ public:
+  // Seed the recorder with the bodies of the AOT corpus.
+  [[nodiscard]] bool init(JSContext* cx);
+
+  void recordAttach(CacheKind kind, const CacheIRWriter& writer);
+
+  // Write out the new bodies and the report.
+  void finish() const;
+};
+
 }  // namespace jit
 }  // namespace js
 
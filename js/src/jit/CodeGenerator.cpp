@@ -14223,6 +14223,20 @@ JitCode* JitZone::generateStringConcatStub(JSContext* cx) {
   masm.Push(FramePointer);
   masm.moveStackPtrTo(FramePointer);
 
+  // Let the VM flatten the result if lhs has a deep left spine. See
+  // JSRope::EagerFlattenDepth.
+  {
+    Label shallow;
+    masm.branchIfNotRope(lhs, &shallow);
+    masm.load32(Address(lhs, JSString::offsetOfFlags()), temp1);
+    masm.and32(Imm32(JSString::ROPE_DEPTH_MASK), temp1);
+    masm.branch32(
+        Assembler::AboveOrEqual, temp1,
+        Imm32((JSRope::EagerFlattenDepth - 1) << JSString::ROPE_DEPTH_SHIFT),
+        &failure);
+    masm.bind(&shallow);
+  }
+
   // If lhs is empty, return rhs.
   Label leftEmpty;
   masm.loadStringLength(lhs, temp1);
@@ -14272,6 +14286,19 @@ JitCode* JitZone::generateStringConcatStub(JSContext* cx) {
   static_assert(JSString::INIT_ROPE_FLAGS == 0,
                 "Rope type flags must have no bits set");
   masm.and32(Imm32(JSString::LATIN1_CHARS_BIT), temp1);
+
+  // The left spine of the new rope is one rope deeper than lhs. It can't
+  // reach EagerFlattenDepth because of the check above, so there's no need to
+  // saturate it.
+  {
+    Label notRope;
+    masm.or32(Imm32(1 << JSString::ROPE_DEPTH_SHIFT), temp1);
+    masm.branchIfNotRope(lhs, &notRope);
+    masm.load32(Address(lhs, JSString::offsetOfFlags()), temp3);
+    masm.and32(Imm32(JSString::ROPE_DEPTH_MASK), temp3);
+    masm.add32(temp3, temp1);
+    masm.bind(&notRope);
+  }
   masm.store32(temp1, Address(output, JSString::offsetOfFlags()));
   masm.store32(temp2, Address(output, JSString::offsetOfLength()));
 
@@ -616,24 +616,32 @@ def generate_cacheirops_header(c_out, yaml_path):
 
 def read_aot_ics(ic_path):
     ics = ""
+    files = ""
     idx = 0
-    for entry in os.scandir(ic_path):
+    # Sort so that the generated table does not depend on directory order.
+    for entry in sorted(os.scandir(ic_path), key=lambda e: e.name):
         if entry.is_file() and os.path.basename(entry.path).startswith("IC-"):
             with open(entry.path) as f:
                 content = f.read().strip()
                 ics += "  _(%d, %s) \\\n" % (idx, content)
+                files += '  _(%d, "%s") \\\n' % (idx, entry.name)
                 idx += 1
-    return ics
+    return ics, files
 
 
 def generate_aot_ics_header(c_out, ic_path):
     """Generate CacheIROpsGenerated.h from AOT IC corpus."""
 
     # Read in all ICs from js/src/ics/IC-*.
-    ics = read_aot_ics(ic_path)
+    ics, files = read_aot_ics(ic_path)
 
     contents = "#define JS_AOT_IC_DATA(_) \\\n"
     contents += ics
     contents += "\n"
 
+    # The corpus file each IC came from, used by the AOT IC recorder report.
+    contents += "#define JS_AOT_IC_FILES(_) \\\n"
+    contents += files
+    contents += "\n"
+
     generate_header(c_out, "jit_CacheIRAOTGenerated_h", contents)
@@ -340,9 +340,21 @@ static bool LinkCodeGen(JSContext* cx, CodeGenerator* codegen,
     return false;
   }
 
-  // Record Ion compile time in glean.
+  // Record Ion compile time in glean. The per-phase breakdown is only spewed.
   if (mozilla::TimeDuration compileTime = codegen->getCompilationTime()) {
     cx->metrics().ION_COMPILE_TIME(compileTime);
+
+    const IonCompilePhaseTimes& phaseTimes = codegen->mirGen().phaseTimes();
+    JitSpew(JitSpew_IonScripts,
+            "Compiled %s:%u:%u in %.3fms (build %.3fms, optimize %.3fms, "
+            "lower %.3fms, regalloc %.3fms, codegen %.3fms)",
+            script->filename(), script->lineno(),
+            script->column().oneOriginValue(), compileTime.ToMilliseconds(),
+            phaseTimes.buildMIR.ToMilliseconds(),
+            phaseTimes.optimizeMIR.ToMilliseconds(),
+            phaseTimes.lowering.ToMilliseconds(),
+            phaseTimes.regalloc.ToMilliseconds(),
+            phaseTimes.codegen.ToMilliseconds());
   }
 
   return true;
@@ -1579,6 +1591,8 @@ LIRGraph* GenerateLIR(MIRGenerator* mir) {
     return nullptr;
   }
 
+  mozilla::TimeStamp lowerStart = mozilla::TimeStamp::Now();
+
   LIRGenerator lirgen(mir, graph, *lir);
   {
     if (!lirgen.generate()) {
@@ -1600,7 +1614,11 @@ LIRGraph* GenerateLIR(MIRGenerator* mir) {
   }
 #endif
 
-  IonRegisterAllocator allocator = mir->optimizationInfo().registerAllocator();
+  mozilla::TimeStamp regallocStart = mozilla::TimeStamp::Now();
+  mir->phaseTimes().lowering = regallocStart - lowerStart;
+
+  IonRegisterAllocator allocator =
+      mir->optimizationInfo().registerAllocator(*lir);
   switch (allocator) {
     case RegisterAllocator_Backtracking: {
       BacktrackingAllocator regalloc(mir, &lirgen, *lir);
@@ -1630,6 +1648,8 @@ LIRGraph* GenerateLIR(MIRGenerator* mir) {
   }
 #endif
 
+  mir->phaseTimes().regalloc = mozilla::TimeStamp::Now() - regallocStart;
+
   if (mir->shouldCancel("Allocate Registers")) {
     return nullptr;
   }
@@ -1665,18 +1685,28 @@ CodeGenerator* CompileBackEnd(MIRGenerator* mir, WarpSnapshot* snapshot) {
     }
   }
 
+  IonCompilePhaseTimes& phaseTimes = mir->phaseTimes();
+  mozilla::TimeStamp optimizeStartTime = mozilla::TimeStamp::Now();
+  phaseTimes.buildMIR = optimizeStartTime - compileStartTime;
+
   if (!OptimizeMIR(mir)) {
     return nullptr;
   }
 
+  phaseTimes.optimizeMIR = mozilla::TimeStamp::Now() - optimizeStartTime;
+
+  // GenerateLIR records the lowering and register allocation times.
   LIRGraph* lir = GenerateLIR(mir);
   if (!lir) {
     return nullptr;
   }
 
+  mozilla::TimeStamp codegenStartTime = mozilla::TimeStamp::Now();
   CodeGenerator* codegen = GenerateCode(mir, lir, snapshot);
   if (codegen) {
-    codegen->setCompilationTime(mozilla::TimeStamp::Now() - compileStartTime);
+    mozilla::TimeStamp now = mozilla::TimeStamp::Now();
+    phaseTimes.codegen = now - codegenStartTime;
+    codegen->setCompilationTime(now - compileStartTime);
   }
   return codegen;
 }
@@ -9,6 +9,7 @@
 #include "jit/Ion.h"
 #include "jit/JitHints.h"
 #include "jit/JitRuntime.h"
+#include "jit/LIR.h"
 #include "js/Prefs.h"
 #include "vm/JSScript.h"
 
@@ -92,11 +93,22 @@ OptimizationLevel OptimizationLevelInfo::levelForScript(JSContext* cx,
   return OptimizationLevel::Normal;
 }
 
-IonRegisterAllocator OptimizationInfo::registerAllocator() const {
+IonRegisterAllocator OptimizationInfo::registerAllocator(
+    const LIRGraph& lir) const {
   switch (JS::Prefs::ion_regalloc()) {
     case 0:
     default:
-      // Use the default register allocator.
+      // Use the default register allocator, unless the graph is so large that
+      // the backtracking allocator's superlinear compile time would dominate.
+      // The simple allocator produces worse code but runs in linear time. The
+      // limits are tuned for JS functions, so wasm always uses the default.
+      if (level_ == OptimizationLevel::Normal &&
+          registerAllocator_ == RegisterAllocator_Backtracking &&
+          (lir.numInstructions() > JitOptions.ionBacktrackingMaxInstructions ||
+           lir.numVirtualRegisters() >
+               JitOptions.ionBacktrackingMaxVirtualRegisters)) {
+        return RegisterAllocator_Simple;
+      }
       return registerAllocator_;
     case 1:
       return RegisterAllocator_Backtracking;
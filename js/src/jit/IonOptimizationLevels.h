@@ -17,6 +17,8 @@
 namespace js {
 namespace jit {
 
+class LIRGraph;
+
 enum class OptimizationLevel : uint8_t { Normal, Wasm, Count, DontCompile };
 
 #ifdef JS_JITSPEW
@@ -199,7 +201,9 @@ class OptimizationInfo {
            !JitOptions.disableRedundantGCBarriers;
   }
 
-  IonRegisterAllocator registerAllocator() const;
+  // Select the register allocator for a compilation after lowering, so that
+  // the default allocator can be chosen based on the size of |lir|.
+  IonRegisterAllocator registerAllocator(const LIRGraph& lir) const;
 
   bool scalarReplacementEnabled() const {
     return scalarReplacement_ && !JitOptions.disableScalarReplacement;
@@ -6,7 +6,12 @@
 
 #include "jit/JitHints-inl.h"
 
+#include "jsfriendapi.h"
+
 #include "gc/Pretenuring.h"
+#include "jit/JitRuntime.h"
+#include "vm/JSContext.h"
+#include "vm/ProfileTranscoding.h"
 
 #include "vm/BytecodeLocation-inl.h"
 #include "vm/JSScript-inl.h"
@@ -22,7 +27,7 @@ JitHintsMap::~JitHintsMap() {
   ionHintMap_.clear();
 }
 
-JitHintsMap::IonHint* JitHintsMap::addIonHint(ScriptKey key,
+JitHintsMap::IonHint* JitHintsMap::newIonHint(ScriptKey key,
                                               ScriptToHintMap::AddPtr& p) {
   UniquePtr<IonHint> hint = MakeUnique<IonHint>(key);
   if (!hint) {
@@ -33,15 +38,29 @@ JitHintsMap::IonHint* JitHintsMap::addIonHint(ScriptKey key,
     return nullptr;
   }
 
-  ionHintQueue_.insertBack(hint.get());
+  return hint.release();
+}
+
+JitHintsMap::IonHint* JitHintsMap::addIonHint(ScriptKey key,
+                                              ScriptToHintMap::AddPtr& p) {
+  IonHint* hint = newIonHint(key, p);
+  if (!hint) {
+    return nullptr;
+  }
+
+  ionHintQueue_.insertBack(hint);
 
   if (ionHintMap_.count() > IonHintMaxEntries) {
-    IonHint* h = ionHintQueue_.popFirst();
-    ionHintMap_.remove(h->key());
-    js_delete(h);
+    evictLeastRecentlyUsedIonHint();
   }
 
-  return hint.release();
+  return hint;
+}
+
+void JitHintsMap::evictLeastRecentlyUsedIonHint() {
+  IonHint* h = ionHintQueue_.popFirst();
+  ionHintMap_.remove(h->key());
+  js_delete(h);
 }
 
 void JitHintsMap::updateAsRecentlyUsed(IonHint* hint) {
@@ -177,3 +196,179 @@ bool JitHintsMap::hasMonomorphicInlineHintAtOffset(JSScript* script,
 
   return false;
 }
+
+// The encoding is:
+//
+//   uint32_t magic, version
+//   uint32_t bloomLength
+//   uint8_t  bloomBits[bloomLength]
+//   uint32_t bloomEntryCount
+//   uint32_t ionHintCount
+//   ionHintCount * {
+//     uint32_t key, threshold, offsetCount
+//     uint32_t offsets[offsetCount]
+//   }
+bool JitHintsMap::encode(JS::TranscodeBuffer& buffer) const {
+  ProfileWriter writer(buffer, EncodingMagic, EncodingVersion);
+
+  writer.writeUint32(baselineHintMap_.rawLength());
+  writer.writeBytes(baselineHintMap_.rawBits(), baselineHintMap_.rawLength());
+  writer.writeUint32(baselineEntryCount_);
+
+  writer.writeUint32(ionHintMap_.count());
+  for (const IonHint* hint = ionHintQueue_.getFirst(); hint;
+       hint = hint->getNext()) {
+    writer.writeUint32(hint->key());
+    writer.writeUint32(hint->threshold());
+
+    const auto& offsets = hint->monomorphicInlineEntries();
+    writer.writeUint32(offsets.length());
+    for (uint32_t offset : offsets) {
+      writer.writeUint32(offset);
+    }
+  }
+
+  return writer.ok();
+}
+
+JitHintsMap::DecodeResult JitHintsMap::decode(
+    const JS::TranscodeRange& range) {
+  // Validate the whole buffer before touching the map, so that a truncated or
+  // corrupted file never leaves partially merged hints behind.
+  uint32_t bloomLength, bloomEntryCount, ionHintCount;
+  const uint8_t* bloomBits;
+  const uint8_t* ionHintsStart;
+  {
+    ProfileReader reader(range);
+    if (!reader.readHeader(EncodingMagic, EncodingVersion) ||
+        !reader.readUint32(&bloomLength) ||
+        bloomLength != baselineHintMap_.rawLength() ||
+        !reader.readBytes(&bloomBits, bloomLength) ||
+        !reader.readUint32(&bloomEntryCount) ||
+        bloomEntryCount > MaxEntries_ ||
+        !reader.readUint32(&ionHintCount) ||
+        ionHintCount > IonHintMaxEntries) {
+      return DecodeResult::Rejected;
+    }
+
+    // Remember where the Ion hints start so we can re-read them below.
+    ionHintsStart = reader.position();
+
+    for (uint32_t i = 0; i < ionHintCount; i++) {
+      uint32_t key, threshold, offsetCount;
+      if (!reader.readUint32(&key) || key == 0 ||
+          !reader.readUint32(&threshold) ||
+          !reader.readUint32(&offsetCount) ||
+          offsetCount > MonomorphicInlineMaxEntries) {
+        return DecodeResult::Rejected;
+      }
+      const uint8_t* offsets;
+      if (!reader.readBytes(&offsets, offsetCount * sizeof(uint32_t))) {
+        return DecodeResult::Rejected;
+      }
+    }
+
+    if (!reader.done()) {
+      return DecodeResult::Rejected;
+    }
+  }
+
+  // The merged filter holds at most the sum of both entry counts. If that
+  // goes over the limit, the next insertion clears the filter as usual.
+  baselineHintMap_.unionWith(bloomBits);
+  baselineEntryCount_ =
+      std::min(baselineEntryCount_ + bloomEntryCount, MaxEntries_);
+
+  // Decoded Ion hints are queued in their encoded order, but before the hints
+  // already in the map: they are the first ones evicted, and once the map is
+  // full they only replace hints decoded earlier in this loop.
+  IonHint* firstExisting = ionHintQueue_.getFirst();
+
+  ProfileReader reader(JS::TranscodeRange(
+      ionHintsStart, range.end().get() - ionHintsStart));
+  for (uint32_t i = 0; i < ionHintCount; i++) {
+    uint32_t key, threshold, offsetCount;
+    MOZ_ALWAYS_TRUE(reader.readUint32(&key));
+    MOZ_ALWAYS_TRUE(reader.readUint32(&threshold));
+    MOZ_ALWAYS_TRUE(reader.readUint32(&offsetCount));
+
+    if (ionHintMap_.has(key)) {
+      // Hints collected by this process are more relevant.
+      const uint8_t* skipped;
+      MOZ_ALWAYS_TRUE(
+          reader.readBytes(&skipped, offsetCount * sizeof(uint32_t)));
+      continue;
+    }
+
+    if (ionHintMap_.count() >= IonHintMaxEntries) {
+      if (ionHintQueue_.getFirst() == firstExisting) {
+        // The map only holds hints which were already there.
+        break;
+      }
+      evictLeastRecentlyUsedIonHint();
+    }
+
+    auto p = ionHintMap_.lookupForAdd(key);
+    IonHint* hint = newIonHint(key, p);
+    if (!hint) {
+      return DecodeResult::OutOfMemory;
+    }
+    if (firstExisting) {
+      firstExisting->setPrevious(hint);
+    } else {
+      ionHintQueue_.insertBack(hint);
+    }
+
+    // The warmup threshold may have changed since the hints were saved.
+    hint->initThreshold(
+        std::min(threshold, JitOptions.normalIonWarmUpThreshold));
+
+    for (uint32_t j = 0; j < offsetCount; j++) {
+      uint32_t offset;
+      MOZ_ALWAYS_TRUE(reader.readUint32(&offset));
+      if (!hint->addMonomorphicInlineOffset(offset)) {
+        return DecodeResult::OutOfMemory;
+      }
+    }
+  }
+
+  return DecodeResult::Ok;
+}
+
+JS_PUBLIC_API bool js::EncodeJitHints(JSContext* cx,
+                                      JS::TranscodeBuffer& buffer) {
+  MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+
+  JSRuntime* rt = cx->runtime();
+  if (!rt->hasJitRuntime() || !rt->jitRuntime()->hasJitHintsMap()) {
+    return true;
+  }
+
+  if (!rt->jitRuntime()->getJitHintsMap()->encode(buffer)) {
+    ReportOutOfMemory(cx);
+    return false;
+  }
+  return true;
+}
+
+JS_PUBLIC_API bool js::DecodeJitHints(JSContext* cx,
+                                      const JS::TranscodeRange& range) {
+  MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+
+  // There is nothing to merge into when hints are disabled.
+  JSRuntime* rt = cx->runtime();
+  if (!rt->hasJitRuntime() || !rt->jitRuntime()->hasJitHintsMap()) {
+    return true;
+  }
+
+  switch (rt->jitRuntime()->getJitHintsMap()->decode(range)) {
+    case JitHintsMap::DecodeResult::Ok:
+      return true;
+    case JitHintsMap::DecodeResult::Rejected:
+      return false;
+    case JitHintsMap::DecodeResult::OutOfMemory:
+      ReportOutOfMemory(cx);
+      return false;
+  }
+  MOZ_CRASH("Unexpected DecodeResult");
+}
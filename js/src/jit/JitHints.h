@@ -11,6 +11,7 @@
 #include "mozilla/HashTable.h"
 #include "mozilla/LinkedList.h"
 #include "jit/JitOptions.h"
+#include "js/Transcoding.h"
 #include "vm/BytecodeLocation.h"
 #include "vm/JSScript.h"
 
@@ -27,6 +28,14 @@ namespace js::jit {
  * value, and if we ever encounter this script again later, e.g. during a
  * navigation, then we try to eagerly compile it into baseline and ion
  * based on its previous execution history.
+ *
+ * The map can also outlive the process: |encode| serializes the baseline
+ * bloom filter and the Ion hints into a flat buffer that an embedder can
+ * store on disk (off the main thread, as the buffer is self-contained), and
+ * |decode| merges such a buffer back into a fresh map on the next run.  The
+ * script keys only depend on the filename and source position, so they are
+ * stable across processes of the same build.  The buffer uses the native
+ * byte order and is not meant to be shared between machines.
  */
 
 class JitHintsMap {
@@ -69,7 +78,7 @@ class JitHintsMap {
 
     void initThreshold(uint32_t threshold) { threshold_ = threshold; }
 
-    uint32_t threshold() { return threshold_; }
+    uint32_t threshold() const { return threshold_; }
 
     void incThreshold(uint32_t inc) {
       uint32_t newThreshold = threshold() + inc;
@@ -100,10 +109,15 @@ class JitHintsMap {
       return monomorphicInlineOffsets.append(newOffset);
     }
 
-    ScriptKey key() {
+    ScriptKey key() const {
       MOZ_ASSERT(key_ != 0, "Should have valid key.");
       return key_;
     }
+
+    const Vector<uint32_t, 0, SystemAllocPolicy>& monomorphicInlineEntries()
+        const {
+      return monomorphicInlineOffsets;
+    }
   };
 
   using ScriptToHintMap =
@@ -112,7 +126,6 @@ class JitHintsMap {
   using IonHintPriorityQueue = mozilla::LinkedList<IonHint>;
 
   static constexpr uint32_t InvalidationThresholdIncrement = 500;
-  static constexpr uint32_t IonHintMaxEntries = 5000;
   static constexpr uint32_t MonomorphicInlineMaxEntries = 16;
 
   static uint32_t IonHintEagerThresholdValue(uint32_t lastStubCounter,
@@ -152,9 +165,17 @@ class JitHintsMap {
   void incrementBaselineEntryCount();
 
   void updateAsRecentlyUsed(IonHint* hint);
+  IonHint* newIonHint(ScriptKey key, ScriptToHintMap::AddPtr& p);
   IonHint* addIonHint(ScriptKey key, ScriptToHintMap::AddPtr& p);
+  void evictLeastRecentlyUsedIonHint();
+
+  // Persistent format, see |encode| and |decode|.
+  static constexpr uint32_t EncodingMagic = 0x544e484a;  // 'JHNT'
+  static constexpr uint32_t EncodingVersion = 1;
 
  public:
+  static constexpr uint32_t IonHintMaxEntries = 5000;
+
   ~JitHintsMap();
 
   void setEagerBaselineHint(JSScript* script);
@@ -167,6 +188,19 @@ class JitHintsMap {
   bool hasMonomorphicInlineHintAtOffset(JSScript* script, uint32_t offset);
 
   void recordInvalidation(JSScript* script);
+
+  // Serialize the hints into |buffer|.  Ion hints are written from least to
+  // most recently used so that decoding preserves the eviction order.
+  bool encode(JS::TranscodeBuffer& buffer) const;
+
+  enum class DecodeResult { Ok, Rejected, OutOfMemory };
+
+  // Merge hints previously produced by |encode| into this map.  Returns
+  // Rejected without modifying the map if the buffer is malformed or was
+  // produced by an incompatible version.  Entries already present in the map
+  // take precedence over decoded ones, and decoded Ion hints are treated as
+  // less recently used than all of them so that they never evict them.
+  [[nodiscard]] DecodeResult decode(const JS::TranscodeRange& range);
 };
 
 }  // namespace js::jit
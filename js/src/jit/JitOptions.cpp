@@ -190,6 +190,10 @@ DefaultJitOptions::DefaultJitOptions() {
 #ifdef ENABLE_JS_AOT_ICS
   SET_DEFAULT(enableAOTICs, false);
   SET_DEFAULT(enableAOTICEnforce, false);
+
+  // Whether to record attached IC bodies for the AOT corpus. See
+  // AOTICRecorder.
+  SET_DEFAULT(recordAOTICs, false);
 #endif
 
 #ifdef ENABLE_JS_AOT_ICS_FORCE
@@ -296,6 +300,12 @@ DefaultJitOptions::DefaultJitOptions() {
   SET_DEFAULT(ionMaxLocalsAndArgs, 10 * 1000);
   SET_DEFAULT(ionMaxLocalsAndArgsMainThread, 256);
 
+  // Limits on the size of the LIR graph of a JS function for which the default
+  // register allocator is the backtracking allocator. Larger graphs use the
+  // simple allocator, trading code quality for compile time.
+  SET_DEFAULT(ionBacktrackingMaxInstructions, 150 * 1000);
+  SET_DEFAULT(ionBacktrackingMaxVirtualRegisters, 100 * 1000);
+
 #if defined(JS_CODEGEN_MIPS64) || defined(JS_CODEGEN_LOONG64) || \
     defined(JS_CODEGEN_RISCV64)
   SET_DEFAULT(spectreIndexMasking, false);
@@ -124,11 +124,14 @@ struct DefaultJitOptions {
   uint32_t ionMaxScriptSizeMainThread;
   uint32_t ionMaxLocalsAndArgs;
   uint32_t ionMaxLocalsAndArgsMainThread;
+  uint32_t ionBacktrackingMaxInstructions;
+  uint32_t ionBacktrackingMaxVirtualRegisters;
   uint32_t wasmBatchBaselineThreshold;
   uint32_t wasmBatchIonThreshold;
 #ifdef ENABLE_JS_AOT_ICS
   bool enableAOTICs;
   bool enableAOTICEnforce;
+  bool recordAOTICs;
 #endif
 
   // Spectre mitigation flags. Each mitigation has its own flag in order to
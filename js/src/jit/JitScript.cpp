@@ -883,9 +883,24 @@ gc::AllocSite* ICScript::getOrCreateAllocSite(JSScript* outerScript,
 
   nursery.noteAllocSiteCreated();
 
+  // Sites for inlined scripts have bytecode offsets in the inlined script, so
+  // the profile doesn't apply to them.
+  if (outerScript->jitScript()->icScript() == this) {
+    nursery.pretenuringProfile().maybeInitSite(site);
+  }
+
   return site;
 }
 
+bool ICScript::hasAllocSite(const gc::AllocSite* site) const {
+  for (const gc::AllocSite* s : allocSites_) {
+    if (s == site) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ICScript::ensureEnvAllocSite(JSScript* outerScript) {
   if (envAllocSite_) {
     return;
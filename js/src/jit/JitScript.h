@@ -204,6 +204,7 @@ class alignas(uintptr_t) ICScript final : public TrailingArray<ICScript> {
   void resetActive() { active_ = false; }
 
   gc::AllocSite* getOrCreateAllocSite(JSScript* outerScript, uint32_t pcOffset);
+  bool hasAllocSite(const gc::AllocSite* site) const;
 
   void ensureEnvAllocSite(JSScript* outerScript);
   gc::AllocSite* maybeEnvAllocSite() const { return envAllocSite_; }
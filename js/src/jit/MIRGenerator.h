@@ -14,6 +14,7 @@
 #include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/Result.h"
+#include "mozilla/TimeStamp.h"
 
 #include <stdarg.h>
 #include <stddef.h>
@@ -37,6 +38,18 @@ class JitRuntime;
 class MIRGraph;
 class OptimizationInfo;
 
+// Time spent in each phase of an Ion backend compilation. These are recorded
+// on the thread running the compilation and spewed on the IonScripts channel
+// when the result is linked, so that slow compilations can be attributed to a
+// phase.
+struct IonCompilePhaseTimes {
+  mozilla::TimeDuration buildMIR;
+  mozilla::TimeDuration optimizeMIR;
+  mozilla::TimeDuration lowering;
+  mozilla::TimeDuration regalloc;
+  mozilla::TimeDuration codegen;
+};
+
 class MIRGenerator final {
  public:
   MIRGenerator(CompileRealm* realm, const JitCompileOptions& options,
@@ -129,6 +142,9 @@ class MIRGenerator final {
   void setNeedsStaticStackAlignment() { needsStaticStackAlignment_ = true; }
   bool needsStaticStackAlignment() const { return needsStaticStackAlignment_; }
 
+  IonCompilePhaseTimes& phaseTimes() { return phaseTimes_; }
+  const IonCompilePhaseTimes& phaseTimes() const { return phaseTimes_; }
+
  public:
   CompileRealm* realm;
   CompileRuntime* runtime;
@@ -148,6 +164,8 @@ class MIRGenerator final {
   bool needsOverrecursedCheck_;
   bool needsStaticStackAlignment_;
 
+  IonCompilePhaseTimes phaseTimes_;
+
   bool instrumentedProfiling_;
   bool instrumentedProfilingIsCached_;
   bool stringsCanBeInNursery_;
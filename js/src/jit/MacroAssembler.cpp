@@ -10206,9 +10206,13 @@ void MacroAssembler::orderedHashTableLookup(Register setOrMapObj,
 #endif
 
   // Determine the bucket by computing |hash >> object->hashShift|. The hash
-  // shift is stored as PrivateUint32Value.
+  // shift is stored as PrivateUint32Value. Large tables don't use hash chains
+  // and are handled out of line.
+  Label probed;
   move32(hash, entryTemp);
   unboxInt32(Address(setOrMapObj, TableObject::offsetOfHashShift()), temp2);
+  branch32(Assembler::BelowOrEqual, temp2,
+           Imm32(TableObject::ProbedLayoutMaxHashShift), &probed);
   flexibleRshift32(temp2, entryTemp);
 
   loadPrivate(Address(setOrMapObj, TableObject::offsetOfHashTable()), temp2);
@@ -10260,6 +10264,44 @@ void MacroAssembler::orderedHashTableLookup(Register setOrMapObj,
           entryTemp);
   bind(&start);
   branchTestPtr(Assembler::NonZero, entryTemp, entryTemp, &loop);
+  jump(&notFound);
+
+  // Search tables using OrderedHashProbeTable by calling into C++. This is only
+  // used for tables with thousands of entries so the call overhead is small
+  // compared to the cache misses this layout avoids.
+  bind(&probed);
+  {
+    LiveRegisterSet volatileRegs(RegisterSet::Volatile());
+    volatileRegs.takeUnchecked(entryTemp);
+    PushRegsInMask(volatileRegs);
+
+    pushValue(value);
+    moveStackPtrTo(temp2);
+
+    setupUnalignedABICall(temp1);
+    loadJSContext(temp1);
+    passABIArg(temp1);
+    passABIArg(setOrMapObj);
+    passABIArg(temp2);
+    passABIArg(hash);
+
+    if constexpr (std::is_same_v<TableObject, SetObject>) {
+      using Fn =
+          void* (*)(JSContext*, SetObject*, const Value*, mozilla::HashNumber);
+      callWithABI<Fn, jit::SetObjectLookupProbed>();
+    } else {
+      static_assert(std::is_same_v<TableObject, MapObject>);
+      using Fn =
+          void* (*)(JSContext*, MapObject*, const Value*, mozilla::HashNumber);
+      callWithABI<Fn, jit::MapObjectLookupProbed>();
+    }
+    storeCallPointerResult(entryTemp);
+
+    popValue(value);
+    PopRegsInMask(volatileRegs);
+
+    branchTestPtr(Assembler::NonZero, entryTemp, entryTemp, found);
+  }
 
   bind(&notFound);
 }
@@ -3259,6 +3259,31 @@ bool MapObjectSetFromIC(JSContext* cx, Handle<MapObject*> obj, HandleValue key,
   return true;
 }
 
+template <class T>
+static void* LookupProbed(JSContext* cx, T* obj, const Value* value,
+                          mozilla::HashNumber hash) {
+  // JIT code has already normalized |value|, so this can't GC.
+  HashableValue hashable;
+  MOZ_ALWAYS_TRUE(hashable.setValue(cx, *value));
+
+  using Table = typename T::Table;
+  return Table(obj).getWithHash(hashable, hash);
+}
+
+void* SetObjectLookupProbed(JSContext* cx, SetObject* obj, const Value* value,
+                            mozilla::HashNumber hash) {
+  AutoUnsafeCallWithABI unsafe;
+
+  return LookupProbed(cx, obj, value, hash);
+}
+
+void* MapObjectLookupProbed(JSContext* cx, MapObject* obj, const Value* value,
+                            mozilla::HashNumber hash) {
+  AutoUnsafeCallWithABI unsafe;
+
+  return LookupProbed(cx, obj, value, hash);
+}
+
 #ifdef DEBUG
 template <class T>
 static mozilla::HashNumber HashValue(JSContext* cx, T* obj,
@@ -725,6 +725,11 @@ bool MapObjectSet(JSContext* cx, Handle<MapObject*> obj, HandleValue key,
 bool MapObjectSetFromIC(JSContext* cx, Handle<MapObject*> obj, HandleValue key,
                         HandleValue val, MutableHandleValue rval);
 
+void* SetObjectLookupProbed(JSContext* cx, SetObject* obj, const Value* value,
+                            mozilla::HashNumber hash);
+void* MapObjectLookupProbed(JSContext* cx, MapObject* obj, const Value* value,
+                            mozilla::HashNumber hash);
+
 void AssertSetObjectHash(JSContext* cx, SetObject* obj, const Value* value,
                          mozilla::HashNumber actualHash);
 void AssertMapObjectHash(JSContext* cx, MapObject* obj, const Value* value,
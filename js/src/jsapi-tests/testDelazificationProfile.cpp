@@ -0,0 +1,254 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/RefPtr.h"     // RefPtr
+#include "mozilla/ScopeExit.h"  // mozilla::MakeScopeExit
+#include "mozilla/Utf8.h"       // mozilla::Utf8Unit
+
+#include <initializer_list>
+
+#include "jsfriendapi.h"  // js::{Encode,Decode}DelazificationProfile
+
+#include "frontend/CompilationStencil.h"  // js::frontend::ScriptStencilRef
+#include "js/CompileOptions.h"            // JS::CompileOptions
+#include "js/experimental/CompileScript.h"  // JS::CompileGlobalScriptToStencil
+#include "js/experimental/JSStencil.h"      // JS::{Encode,Decode}Stencil
+#include "js/SourceText.h"                  // JS::SourceText
+#include "js/Stack.h"                       // JS::NativeStackSize
+#include "js/Transcoding.h"  // JS::TranscodeBuffer, JS::TranscodeRange
+#include "jsapi-tests/tests.h"
+#include "util/Text.h"
+#include "vm/ConcurrentDelazification.h"  // js::DelazificationProfile
+#include "vm/JSScript.h"                  // js::ScriptSource
+
+using namespace js;
+
+// The profile is shared by the whole process, thus each test uses its own
+// source text to not observe the executions recorded by other tests.
+static HashNumber HashTestSource(const char* text) {
+  return DelazificationProfile::hashSource(text, js_strlen(text));
+}
+
+BEGIN_TEST(testDelazificationProfile_RecordOrder) {
+  HashNumber hash = HashTestSource("testDelazificationProfile_RecordOrder");
+  CHECK(hash != 0);
+
+  DelazificationProfile::recordExecution(hash, 30);
+  DelazificationProfile::recordExecution(hash, 10);
+  DelazificationProfile::recordExecution(hash, 30);
+  DelazificationProfile::recordExecution(hash, 20);
+
+  DelazificationProfile::FunctionList functions;
+  CHECK(DelazificationProfile::lookup(hash, functions));
+  CHECK_EQUAL(functions.length(), 3u);
+  CHECK_EQUAL(functions[0], 30u);
+  CHECK_EQUAL(functions[1], 10u);
+  CHECK_EQUAL(functions[2], 20u);
+
+  return true;
+}
+END_TEST(testDelazificationProfile_RecordOrder)
+
+BEGIN_TEST(testDelazificationProfile_EncodeDecode) {
+  HashNumber recorded = HashTestSource("testDelazificationProfile_Recorded");
+  HashNumber decoded = HashTestSource("testDelazificationProfile_Decoded");
+
+  DelazificationProfile::recordExecution(recorded, 5);
+
+  JS::TranscodeBuffer buffer;
+  CHECK(js::EncodeDelazificationProfile(cx, buffer));
+  JS::TranscodeRange range(buffer.begin(), buffer.length());
+
+  // Decoding our own profile does not duplicate any function.
+  CHECK(js::DecodeDelazificationProfile(cx, range));
+  DelazificationProfile::FunctionList functions;
+  CHECK(DelazificationProfile::lookup(recorded, functions));
+  CHECK_EQUAL(functions.length(), 1u);
+  CHECK_EQUAL(functions[0], 5u);
+
+  // A profile with more sources than the limit is rejected. The checks shared
+  // by all profiles are covered by testProfileTranscoding.
+  const uint32_t tooManySources[] = {DelazificationProfile::EncodingMagic,
+                                     DelazificationProfile::EncodingVersion,
+                                     DelazificationProfile::MaxSources + 1};
+  CHECK(!js::DecodeDelazificationProfile(
+      cx, JS::TranscodeRange(reinterpret_cast<const uint8_t*>(tooManySources),
+                             sizeof(tooManySources))));
+
+  // A profile recorded by another process is merged after the functions
+  // recorded by this one.
+  const uint32_t other[] = {DelazificationProfile::EncodingMagic,
+                            DelazificationProfile::EncodingVersion,
+                            2,
+                            recorded,
+                            2,
+                            7,
+                            5,
+                            decoded,
+                            1,
+                            42};
+  CHECK(js::DecodeDelazificationProfile(
+      cx, JS::TranscodeRange(reinterpret_cast<const uint8_t*>(other),
+                             sizeof(other))));
+
+  functions.clear();
+  CHECK(DelazificationProfile::lookup(recorded, functions));
+  CHECK_EQUAL(functions.length(), 2u);
+  CHECK_EQUAL(functions[0], 5u);
+  CHECK_EQUAL(functions[1], 7u);
+
+  functions.clear();
+  CHECK(DelazificationProfile::lookup(decoded, functions));
+  CHECK_EQUAL(functions.length(), 1u);
+  CHECK_EQUAL(functions[0], 42u);
+
+  return true;
+}
+END_TEST(testDelazificationProfile_EncodeDecode)
+
+// Compile |source| with the ConcurrentProfileGuided strategy, and record the
+// executions of its top-level functions in the order given by |executed|, as
+// indexes into the functions of the source.
+static RefPtr<JS::Stencil> CompileProfiled(
+    JS::FrontendContext* fc, const char* source,
+    std::initializer_list<size_t> executed) {
+  JS::PrefableCompileOptions prefableOptions;
+  JS::CompileOptions options(prefableOptions);
+  options.setEagerDelazificationStrategy(
+      JS::DelazificationOption::ConcurrentProfileGuided);
+
+  JS::SourceText<mozilla::Utf8Unit> srcBuf;
+  if (!srcBuf.init(fc, source, js_strlen(source),
+                   JS::SourceOwnership::Borrowed)) {
+    return nullptr;
+  }
+  RefPtr<JS::Stencil> stencil =
+      JS::CompileGlobalScriptToStencil(fc, options, srcBuf);
+  if (!stencil) {
+    return nullptr;
+  }
+
+  const frontend::CompilationStencil* initial = stencil->getInitial();
+  HashNumber hash = initial->source->profileSourceHash();
+  MOZ_RELEASE_ASSERT(hash);
+  for (size_t index : executed) {
+    DelazificationProfile::recordExecution(
+        hash, initial->scriptExtra[index].extent.sourceStart);
+  }
+  return stencil;
+}
+
+static constexpr JS::NativeStackSize StackSize = 128 * sizeof(size_t) * 1024;
+
+// Functions are delazified in the order of their first execution, and the ones
+// which never ran are skipped.
+BEGIN_FRONTEND_TEST(testDelazificationProfile_ExecutionOrder) {
+  JS::FrontendContext* fc = JS::NewFrontendContext();
+  CHECK(fc);
+  auto destroyFc =
+      mozilla::MakeScopeExit([fc] { JS::DestroyFrontendContext(fc); });
+  JS::SetNativeStackQuota(fc, StackSize);
+
+  // Script indexes follow the source order: f is 1, g is 2 and h is 3.
+  RefPtr<JS::Stencil> stencil = CompileProfiled(
+      fc,
+      "function f() { return 1; }\n"
+      "function g() { return 2; }\n"
+      "function h() { return f(); }\n"
+      "// testDelazificationProfile_ExecutionOrder",
+      {3, 1});
+  CHECK(stencil);
+
+  auto indexesGuard = stencil->ensureRelativeIndexes(fc);
+  CHECK(indexesGuard);
+
+  DelazificationProfile::FunctionList functions;
+  CHECK(DelazificationProfile::lookup(
+      stencil->getInitial()->source->profileSourceHash(), functions));
+  ProfileGuidedDelazification strategy;
+  CHECK(strategy.init(functions));
+
+  frontend::ScriptStencilRef topLevel{*stencil, frontend::ScriptIndex(0)};
+  CHECK(strategy.add(fc, topLevel));
+
+  CHECK(!strategy.done());
+  CHECK_EQUAL(uint32_t(strategy.next().scriptIndex_), 3u);
+  CHECK(!strategy.done());
+  CHECK_EQUAL(uint32_t(strategy.next().scriptIndex_), 1u);
+  CHECK(strategy.done());
+
+  return true;
+}
+END_TEST(testDelazificationProfile_ExecutionOrder)
+
+// Run the delazification of a profiled source to completion, and check that
+// only the executed functions have been delazified.
+BEGIN_FRONTEND_TEST(testDelazificationProfile_SkipUnprofiled) {
+  JS::FrontendContext* fc = JS::NewFrontendContext();
+  CHECK(fc);
+  auto destroyFc =
+      mozilla::MakeScopeExit([fc] { JS::DestroyFrontendContext(fc); });
+  JS::SetNativeStackQuota(fc, StackSize);
+
+  RefPtr<JS::Stencil> stencil = CompileProfiled(
+      fc,
+      "function f() { return 1; }\n"
+      "function g() { return 2; }\n"
+      "function h() { return f(); }\n"
+      "// testDelazificationProfile_SkipUnprofiled",
+      {3, 1});
+  CHECK(stencil);
+
+  JS::PrefableCompileOptions prefableOptions;
+  JS::CompileOptions options(prefableOptions);
+  options.setEagerDelazificationStrategy(
+      JS::DelazificationOption::ConcurrentProfileGuided);
+
+  DelazificationContext context(prefableOptions, StackSize);
+  CHECK(context.init(options, stencil));
+  CHECK(context.delazify());
+  CHECK(context.done());
+
+  CHECK(stencil->getDelazificationAt(1));
+  CHECK(!stencil->getDelazificationAt(2));
+  CHECK(stencil->getDelazificationAt(3));
+
+  return true;
+}
+END_TEST(testDelazificationProfile_SkipUnprofiled)
+
+// Decoded stencils keep the profile of their source, even though the source
+// text is not necessarily encoded with them.
+BEGIN_FRONTEND_TEST(testDelazificationProfile_DecodedSource) {
+  JS::FrontendContext* fc = JS::NewFrontendContext();
+  CHECK(fc);
+  auto destroyFc =
+      mozilla::MakeScopeExit([fc] { JS::DestroyFrontendContext(fc); });
+  JS::SetNativeStackQuota(fc, StackSize);
+
+  RefPtr<JS::Stencil> stencil = CompileProfiled(
+      fc,
+      "function f() { return 1; }\n"
+      "// testDelazificationProfile_DecodedSource",
+      {1});
+  CHECK(stencil);
+
+  JS::TranscodeBuffer buffer;
+  CHECK(JS::EncodeStencil(fc, stencil, buffer) == JS::TranscodeResult::Ok);
+
+  JS::DecodeOptions decodeOptions;
+  JS::TranscodeRange range(buffer.begin(), buffer.length());
+  RefPtr<JS::Stencil> decoded;
+  CHECK(JS::DecodeStencil(fc, decodeOptions, range,
+                          getter_AddRefs(decoded)) == JS::TranscodeResult::Ok);
+
+  HashNumber hash = stencil->getInitial()->source->profileSourceHash();
+  CHECK_EQUAL(decoded->getInitial()->source->profileSourceHash(), hash);
+
+  return true;
+}
+END_TEST(testDelazificationProfile_DecodedSource)
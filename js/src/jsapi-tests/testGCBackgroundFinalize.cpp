@@ -0,0 +1,127 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gc/AllocKind.h"
+#include "gc/GCRuntime.h"
+#include "js/GCAPI.h"
+#include "jsapi-tests/tests.h"
+#include "vm/Runtime.h"
+
+using namespace js;
+using namespace js::gc;
+
+static unsigned ForegroundFinalizeCount = 0;
+static uint32_t FinalizedCellsAtCycleEnd = 0;
+
+static void ForegroundFinalize(JS::GCContext* gcx, JSObject* obj) {
+  MOZ_ASSERT(gcx->onMainThread());
+  ForegroundFinalizeCount++;
+}
+
+static const JSClassOps ForegroundFinalizeClassOps = {
+    nullptr,             // addProperty
+    nullptr,             // delProperty
+    nullptr,             // enumerate
+    nullptr,             // newEnumerate
+    nullptr,             // resolve
+    nullptr,             // mayResolve
+    ForegroundFinalize,  // finalize
+    nullptr,             // call
+    nullptr,             // construct
+    nullptr,             // trace
+};
+
+static const JSClass ForegroundFinalizeClass = {
+    "ForegroundFinalize",
+    JSCLASS_FOREGROUND_FINALIZE,
+    &ForegroundFinalizeClassOps,
+};
+
+static void RecordFinalizedCells(JSContext* cx, JS::GCProgress progress,
+                                 const JS::GCDescription& desc) {
+  if (progress != JS::GC_CYCLE_END) {
+    return;
+  }
+
+  // Foreground finalization has finished by the end of the cycle, although
+  // background finalization may still be running.
+  const gcstats::Statistics& stats = cx->runtime()->gc.stats();
+  FinalizedCellsAtCycleEnd = 0;
+  for (auto kind : AllAllocKinds()) {
+    if (IsForegroundFinalized(kind) && IsObjectAllocKind(kind)) {
+      FinalizedCellsAtCycleEnd += stats.getFinalizedCells(kind);
+    }
+  }
+}
+
+// Check that the number of cells finalized is recorded per alloc kind.
+BEGIN_TEST(testGCFinalizedCellCounts) {
+  AutoLeaveZeal leaveZeal(cx);
+
+  static constexpr unsigned ObjectCount = 100;
+
+  JS_GC(cx);
+
+  for (unsigned i = 0; i < ObjectCount; i++) {
+    JSObject* obj = JS_NewObject(cx, &ForegroundFinalizeClass);
+    CHECK(obj);
+    CHECK(obj->isTenured());
+    CHECK(IsForegroundFinalized(obj->asTenured().getAllocKind()));
+  }
+
+  ForegroundFinalizeCount = 0;
+  JS::GCSliceCallback prev = JS::SetGCSliceCallback(cx, RecordFinalizedCells);
+  JS_GC(cx);
+  JS::SetGCSliceCallback(cx, prev);
+
+  CHECK_EQUAL(ForegroundFinalizeCount, ObjectCount);
+  CHECK(FinalizedCellsAtCycleEnd >= ObjectCount);
+
+  return true;
+}
+END_TEST(testGCFinalizedCellCounts)
+
+#ifdef JS_HAS_INTL_API
+
+// Check that Intl objects whose finalizers only free their ICU data are
+// finalized off the main thread.
+BEGIN_TEST(testGCBackgroundFinalizeIntl) {
+  static const char* const constructors[] = {
+      "new Intl.Collator()",
+      "new Intl.DateTimeFormat()",
+      "new Intl.DisplayNames(undefined, {type: 'region'})",
+      "new Intl.DurationFormat()",
+      "new Intl.ListFormat()",
+      "new Intl.NumberFormat()",
+      "new Intl.PluralRules()",
+      "new Intl.RelativeTimeFormat()",
+  };
+
+  for (const char* constructor : constructors) {
+    JS::RootedValue v(cx);
+    EVAL(constructor, &v);
+    CHECK(v.isObject());
+
+    JSObject* obj = &v.toObject();
+    CHECK(obj->isTenured());
+    CHECK(IsBackgroundFinalized(obj->asTenured().getAllocKind()));
+  }
+
+  // Use the objects so that they allocate their ICU data before they die.
+  EXEC(
+      "new Intl.Collator().compare('a', 'b');"
+      "new Intl.NumberFormat().format(1);"
+      "new Intl.DateTimeFormat().formatRange(0, 1);");
+
+  JS_GC(cx);
+  cx->runtime()->gc.waitBackgroundSweepEnd();
+
+  return true;
+}
+END_TEST(testGCBackgroundFinalizeIntl)
+
+#endif  // JS_HAS_INTL_API
@@ -0,0 +1,45 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+
+#include "gc/GCRuntime.h"
+#include "gc/Memory.h"
+#include "js/GCAPI.h"
+#include "jsapi-tests/tests.h"
+#include "vm/Runtime.h"
+
+using namespace js;
+
+BEGIN_TEST(testGCNurserySizing) {
+  AutoLeaveZeal leaveZeal(cx);
+
+  CHECK_EQUAL(JS_GetGCParameter(cx, JSGC_LAST_LEVEL_CACHE_SIZE_KB),
+              uint32_t(gc::LastLevelCacheSize() / 1024));
+
+  CHECK(JS_GetGCParameter(cx, JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED));
+  JS_SetGCParameter(cx, JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED, false);
+  CHECK(!JS_GetGCParameter(cx, JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED));
+  JS_ResetGCParameter(cx, JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED);
+  CHECK(JS_GetGCParameter(cx, JSGC_NURSERY_CACHE_AWARE_SIZING_ENABLED));
+
+  // Each minor GC reports the nursery sizing decision it made.
+  EXEC("for (let i = 0; i < 1000; i++) { ({}); }");
+  cx->runtime()->gc.minorGC(JS::GCReason::API);
+
+  JS::UniqueChars json = JS::MinorGcToJSON(cx);
+  CHECK(json);
+  CHECK(strstr(json.get(), "\"sizing\""));
+  CHECK(strstr(json.get(), "\"limited_by\""));
+  CHECK(strstr(json.get(), "\"throughput_bytes_per_ms\""));
+  if (gc::LastLevelCacheSize() != 0) {
+    CHECK(strstr(json.get(), "\"cache_limit\""));
+  }
+
+  return true;
+}
+END_TEST(testGCNurserySizing)
@@ -0,0 +1,164 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/Utf8.h"  // mozilla::Utf8Unit
+
+#include <string.h>
+
+#include "jit/JitHints.h"
+#include "js/CompilationAndEvaluation.h"  // JS::Compile
+#include "js/SourceText.h"                // JS::Source{Ownership,Text}
+#include "js/Transcoding.h"               // JS::TranscodeBuffer
+#include "jsapi-tests/tests.h"
+#include "util/Text.h"
+#include "vm/BytecodeLocation.h"
+#include "vm/JSScript.h"
+
+#include "jit/JitHints-inl.h"
+
+using namespace js;
+
+static JSScript* CompileWithFilename(JSContext* cx, const char* filename) {
+  static const char code[] = "function f() { return 1; }";
+
+  JS::CompileOptions options(cx);
+  options.setFileAndLine(filename, 1);
+
+  JS::SourceText<mozilla::Utf8Unit> srcBuf;
+  if (!srcBuf.init(cx, code, js_strlen(code), JS::SourceOwnership::Borrowed)) {
+    return nullptr;
+  }
+
+  return JS::Compile(cx, options, srcBuf);
+}
+
+BEGIN_TEST(testJitHints_EncodeDecode) {
+  JS::RootedScript hinted(cx, CompileWithFilename(cx, "hinted.js"));
+  CHECK(hinted);
+  JS::RootedScript other(cx, CompileWithFilename(cx, "other.js"));
+  CHECK(other);
+
+  JS::TranscodeBuffer buffer;
+  {
+    jit::JitHintsMap hints;
+    hints.setEagerBaselineHint(hinted);
+    CHECK(hints.encode(buffer));
+  }
+
+  jit::JitHintsMap restored;
+  CHECK(!restored.mightHaveEagerBaselineHint(hinted));
+  CHECK(restored.decode(JS::TranscodeRange(buffer.begin(), buffer.length())) ==
+        jit::JitHintsMap::DecodeResult::Ok);
+  CHECK(restored.mightHaveEagerBaselineHint(hinted));
+  CHECK(!restored.mightHaveEagerBaselineHint(other));
+
+  return true;
+}
+END_TEST(testJitHints_EncodeDecode)
+
+BEGIN_TEST(testJitHints_DecodeRejectsMalformed) {
+  JS::RootedScript script(cx, CompileWithFilename(cx, "hinted.js"));
+  CHECK(script);
+
+  JS::TranscodeBuffer buffer;
+  {
+    jit::JitHintsMap hints;
+    hints.setEagerBaselineHint(script);
+    CHECK(hints.encode(buffer));
+  }
+
+  // Truncated data is rejected, and the bloom filter which precedes the
+  // missing data is not merged. The checks shared by all profiles are covered
+  // by testProfileTranscoding.
+  jit::JitHintsMap restored;
+  CHECK(restored.decode(
+            JS::TranscodeRange(buffer.begin(), buffer.length() - 1)) ==
+        jit::JitHintsMap::DecodeResult::Rejected);
+  CHECK(!restored.mightHaveEagerBaselineHint(script));
+
+  return true;
+}
+END_TEST(testJitHints_DecodeRejectsMalformed)
+
+// A saved Ion threshold above the current warmup threshold is clamped rather
+// than rejected, since the warmup options may differ between runs.
+BEGIN_TEST(testJitHints_DecodeClampsThreshold) {
+  JS::TranscodeBuffer buffer;
+  {
+    jit::JitHintsMap hints;
+    CHECK(hints.encode(buffer));
+  }
+
+  // Replace the trailing Ion hint count with a single hint.
+  const uint32_t tooHigh = jit::JitOptions.normalIonWarmUpThreshold + 1;
+  const uint32_t ionHint[] = {1, 1, tooHigh, 0};
+  buffer.shrinkBy(sizeof(uint32_t));
+  CHECK(buffer.append(reinterpret_cast<const uint8_t*>(ionHint),
+                      sizeof(ionHint)));
+
+  jit::JitHintsMap restored;
+  CHECK(restored.decode(JS::TranscodeRange(buffer.begin(), buffer.length())) ==
+        jit::JitHintsMap::DecodeResult::Ok);
+
+  JS::TranscodeBuffer reencoded;
+  CHECK(restored.encode(reencoded));
+  CHECK_EQUAL(reencoded.length(), buffer.length());
+
+  uint32_t threshold;
+  const uint8_t* thresholdBytes = reencoded.end() - 2 * sizeof(uint32_t);
+  memcpy(&threshold, thresholdBytes, sizeof(threshold));
+  CHECK_EQUAL(threshold, jit::JitOptions.normalIonWarmUpThreshold);
+
+  return true;
+}
+END_TEST(testJitHints_DecodeClampsThreshold)
+
+// Decoded Ion hints are less recently used than the hints collected by this
+// process, so a full set of decoded hints does not evict them.
+BEGIN_TEST(testJitHints_DecodeKeepsExistingHints) {
+  JS::RootedScript script(cx, CompileWithFilename(cx, "hinted.js"));
+  CHECK(script);
+
+  JS::TranscodeBuffer buffer;
+  {
+    jit::JitHintsMap hints;
+    CHECK(hints.encode(buffer));
+  }
+
+  // Replace the trailing Ion hint count with a full set of hints.
+  const uint32_t count = jit::JitHintsMap::IonHintMaxEntries;
+  buffer.shrinkBy(sizeof(uint32_t));
+  CHECK(buffer.append(reinterpret_cast<const uint8_t*>(&count),
+                      sizeof(count)));
+  for (uint32_t key = 1; key <= count; key++) {
+    const uint32_t ionHint[] = {key, 2, 0};
+    CHECK(buffer.append(reinterpret_cast<const uint8_t*>(ionHint),
+                        sizeof(ionHint)));
+  }
+
+  jit::JitHintsMap restored;
+  restored.setEagerBaselineHint(script);
+  CHECK(restored.addMonomorphicInlineLocation(
+      script, BytecodeLocation(script, script->code())));
+
+  CHECK(restored.decode(JS::TranscodeRange(buffer.begin(), buffer.length())) ==
+        jit::JitHintsMap::DecodeResult::Ok);
+  CHECK(restored.hasMonomorphicInlineHintAtOffset(script, 0));
+
+  // The existing hint is still the most recently used one.
+  JS::TranscodeBuffer reencoded;
+  CHECK(restored.encode(reencoded));
+  uint32_t lastHint[4];
+  CHECK(reencoded.length() >= sizeof(lastHint));
+  memcpy(lastHint, reencoded.end() - sizeof(lastHint), sizeof(lastHint));
+  CHECK_EQUAL(lastHint[1], 0u);
+  CHECK_EQUAL(lastHint[2], 1u);
+  CHECK_EQUAL(lastHint[3], 0u);
+
+  return true;
+}
+END_TEST(testJitHints_DecodeKeepsExistingHints)
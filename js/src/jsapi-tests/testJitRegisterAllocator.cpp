@@ -0,0 +1,62 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "mozilla/ScopeExit.h"
+
+#include "jit/IonOptimizationLevels.h"
+#include "jit/JitOptions.h"
+#include "jit/LIR.h"
+#include "js/Prefs.h"
+
+#include "jsapi-tests/testJitMinimalFunc.h"
+#include "jsapi-tests/tests.h"
+
+using namespace js;
+using namespace js::jit;
+
+// Large JS graphs fall back to the simple allocator, while wasm always uses
+// the default one.
+BEGIN_TEST(testJitRegisterAllocator_SizeFallback) {
+  // The fallback only applies to the default allocator.
+  if (JS::Prefs::ion_regalloc() != 0) {
+    return true;
+  }
+
+  MinimalFunc func;
+  LIRGraph lir(&func.graph);
+  for (size_t i = 0; i < 4; i++) {
+    lir.getVirtualRegister();
+    lir.getInstructionId();
+  }
+
+  const OptimizationInfo* jsInfo =
+      IonOptimizations.get(OptimizationLevel::Normal);
+  const OptimizationInfo* wasmInfo =
+      IonOptimizations.get(OptimizationLevel::Wasm);
+
+  uint32_t maxInstructions = JitOptions.ionBacktrackingMaxInstructions;
+  uint32_t maxVirtualRegisters = JitOptions.ionBacktrackingMaxVirtualRegisters;
+  auto restoreOptions = mozilla::MakeScopeExit([&] {
+    JitOptions.ionBacktrackingMaxInstructions = maxInstructions;
+    JitOptions.ionBacktrackingMaxVirtualRegisters = maxVirtualRegisters;
+  });
+
+  CHECK(jsInfo->registerAllocator(lir) == RegisterAllocator_Backtracking);
+  CHECK(wasmInfo->registerAllocator(lir) == RegisterAllocator_Backtracking);
+
+  JitOptions.ionBacktrackingMaxInstructions = 3;
+  CHECK(jsInfo->registerAllocator(lir) == RegisterAllocator_Simple);
+  CHECK(wasmInfo->registerAllocator(lir) == RegisterAllocator_Backtracking);
+
+  JitOptions.ionBacktrackingMaxInstructions = maxInstructions;
+  JitOptions.ionBacktrackingMaxVirtualRegisters = 3;
+  CHECK(jsInfo->registerAllocator(lir) == RegisterAllocator_Simple);
+  CHECK(wasmInfo->registerAllocator(lir) == RegisterAllocator_Backtracking);
+
+  return true;
+}
+END_TEST(testJitRegisterAllocator_SizeFallback)
@@ -0,0 +1,71 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "ds/LifoAlloc.h"
+#include "jsapi-tests/tests.h"
+
+using namespace js;
+
+static constexpr size_t ChunkSize = 64 * 1024;
+
+static bool AllocateAndFree(size_t chunkSize, size_t allocSize) {
+  LifoAlloc lifo(chunkSize, js::MallocArena);
+  return !!lifo.alloc(allocSize);
+}
+
+// Returns the address of an allocation made in a fresh LifoAlloc, whose chunk
+// has been freed by the time this returns.
+static uintptr_t AllocationAddress(arena_id_t arena) {
+  LifoAlloc lifo(ChunkSize, arena);
+  return uintptr_t(lifo.alloc(100));
+}
+
+// Check that chunks freed by one LifoAlloc are reused by the next one, and
+// that purging the cache frees them.
+BEGIN_TEST(testLifoChunkCache) {
+  PurgeLifoChunkCache();
+  CHECK_EQUAL(GetLifoChunkCacheStats().cachedBytes, 0u);
+
+  CHECK(AllocateAndFree(ChunkSize, 100));
+  LifoChunkCacheStats stats = GetLifoChunkCacheStats();
+  CHECK(stats.cachedBytes >= ChunkSize);
+
+  CHECK(AllocateAndFree(ChunkSize, 100));
+  LifoChunkCacheStats after = GetLifoChunkCacheStats();
+  CHECK(after.hits > stats.hits);
+  CHECK(after.cachedBytes >= ChunkSize);
+
+  PurgeLifoChunkCache();
+  CHECK_EQUAL(GetLifoChunkCacheStats().cachedBytes, 0u);
+
+  return true;
+}
+END_TEST(testLifoChunkCache)
+
+// Check that a cached chunk is only reused by a LifoAlloc of the same arena.
+BEGIN_TEST(testLifoChunkCache_arenas) {
+  if (js::MallocArena == js::BackgroundMallocArena) {
+    return true;
+  }
+
+  PurgeLifoChunkCache();
+
+  // While the chunk of the first LifoAlloc is cached, malloc cannot hand out
+  // its memory again, so a different address means the cache was bypassed.
+  uintptr_t background = AllocationAddress(js::BackgroundMallocArena);
+  CHECK(background);
+  uintptr_t foreground = AllocationAddress(js::MallocArena);
+  CHECK(foreground);
+  CHECK(foreground != background);
+
+  CHECK_EQUAL(AllocationAddress(js::BackgroundMallocArena), background);
+  CHECK_EQUAL(AllocationAddress(js::MallocArena), foreground);
+
+  PurgeLifoChunkCache();
+  return true;
+}
+END_TEST(testLifoChunkCache_arenas)
@@ -155,3 +155,70 @@ BEGIN_TEST(testSet) {
   return runTests(theSet);
 }
 END_TEST(testSet)
+
+// Tables with more than a few thousand entries switch from hash chains to a
+// probed layout. Check that lookups, removal, insertion order and live
+// iterators behave the same for large tables.
+BEGIN_TEST(testMapSetLargeTables) {
+  EXEC(
+      "function check(b, msg) { if (!b) throw new Error(msg); }     \n"
+      "var N = 50000;                                                 \n"
+      "var keys = [];                                                 \n"
+      "for (var i = 0; i < N; i++) {                                  \n"
+      "  keys.push(i % 4 == 0 ? i : i % 4 == 1 ? 'k' + i :            \n"
+      "            i % 4 == 2 ? {i} : i + 0.5);                       \n"
+      "}                                                              \n"
+      "var map = new Map();                                           \n"
+      "var set = new Set();                                           \n"
+      "var mapIter = map.keys();                                      \n"
+      "for (var i = 0; i < N; i++) {                                  \n"
+      "  map.set(keys[i], i);                                         \n"
+      "  set.add(keys[i]);                                            \n"
+      "}                                                              \n"
+      "check(map.size == N && set.size == N, 'size');                 \n");
+
+  // Move object keys, which changes their hash codes.
+  JS::PrepareForFullGC(cx);
+  JS::NonIncrementalGC(cx, JS::GCOptions::Shrink, JS::GCReason::API);
+
+  EXEC(
+      "for (var i = 0; i < N; i++) {                                  \n"
+      "  check(map.get(keys[i]) === i, 'get ' + i);                   \n"
+      "  check(set.has(keys[i]), 'has ' + i);                         \n"
+      "}                                                              \n"
+      "check(!map.has(-1) && !set.has('k-1') && !set.has({}), 'miss');\n"
+      "for (var i = 0; i < N; i += 2) {                               \n"
+      "  check(map.delete(keys[i]) && set.delete(keys[i]), 'delete'); \n"
+      "}                                                              \n"
+      "check(!map.delete(keys[0]), 'double delete');                  \n"
+      "var expected = 1;                                              \n"
+      "for (var k of mapIter) {                                       \n"
+      "  check(k === keys[expected], 'live iterator ' + expected);    \n"
+      "  expected += 2;                                               \n"
+      "}                                                              \n"
+      "check(expected == N + 1, 'live iterator end');                 \n"
+      "expected = 1;                                                  \n"
+      "for (var k of set) {                                           \n"
+      "  check(k === keys[expected], 'order ' + expected);            \n"
+      "  expected += 2;                                               \n"
+      "}                                                              \n"
+      "for (var i = 0; i < N; i++) {                                  \n"
+      "  check(map.has(keys[i]) == (i % 2 == 1), 'has after delete'); \n"
+      "}                                                              \n"
+      "for (var i = 0; i < N - 16; i++) {                             \n"
+      "  map.delete(keys[i]);                                         \n"
+      "}                                                              \n"
+      "check(map.size == 8 && map.get(keys[N - 1]) === N - 1, 'shrink');\n"
+      "set.clear();                                                   \n"
+      "check(set.size == 0 && !set.has(keys[1]), 'clear');            \n"
+      "for (var i = 0; i < N; i++) {                                  \n"
+      "  set.add(keys[N - 1 - i]);                                    \n"
+      "  check(set.has(keys[N - 1]) && set.has(keys[N - 1 - i]), 'readd');\n"
+      "}                                                              \n"
+      "for (var i = 0; i < N; i++) {                                  \n"
+      "  check(set.has(keys[i]), 'has after readd ' + i);             \n"
+      "}                                                              \n");
+
+  return true;
+}
+END_TEST(testMapSetLargeTables)
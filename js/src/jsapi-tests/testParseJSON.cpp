@@ -5,6 +5,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <initializer_list>
 #include <limits>
 #include <string.h>
 
@@ -15,7 +16,9 @@
 #include "js/MemoryFunctions.h"
 #include "js/Printf.h"
 #include "js/PropertyAndElement.h"  // JS_GetProperty
+#include "js/String.h"              // JS_StringEqualsAscii
 #include "jsapi-tests/tests.h"
+#include "vm/JSObject.h"  // JSObject::shape
 
 using namespace js;
 
@@ -355,3 +358,166 @@ inline bool TryParse(JSContext* cx, const char (&input)[N],
   return true;
 }
 END_TEST(testParseJSON_reviver)
+
+BEGIN_TEST(testParseJSON_recordShapes) {
+  // Records with the same keys share their shape, including when records of
+  // other types are interleaved.
+  JS::RootedValue v(cx);
+  EVAL(
+      "JSON.parse('[{\"a\":1,\"b\":2},{\"c\":3},{\"a\":4,\"b\":5},"
+      "{\"c\":6},{\"b\":7,\"a\":8},{\"a\":9,\"a\":10},"
+      "{\"a\":11,\"a\":12},{\"0\":13,\"a\":14},{\"0\":15,\"a\":16}]')",
+      &v);
+  CHECK(v.isObject());
+  JS::RootedObject array(cx, &v.toObject());
+
+  JS::RootedObjectVector records(cx);
+  for (uint32_t i = 0; i < 9; i++) {
+    JS::RootedValue elem(cx);
+    CHECK(JS_GetElement(cx, array, i, &elem));
+    CHECK(elem.isObject());
+    CHECK(records.append(&elem.toObject()));
+  }
+
+  CHECK(records[0]->shape() == records[2]->shape());
+  CHECK(records[1]->shape() == records[3]->shape());
+  CHECK(records[0]->shape() != records[4]->shape());
+
+  // The values of records created with a cached shape are in order.
+  JS::RootedObject record(cx, records[2]);
+  JS::RootedValue a(cx);
+  JS::RootedValue b(cx);
+  CHECK(JS_GetProperty(cx, record, "a", &a));
+  CHECK(JS_GetProperty(cx, record, "b", &b));
+  CHECK(a == JS::Int32Value(4));
+  CHECK(b == JS::Int32Value(5));
+
+  // Duplicate keys keep the last value.
+  record = records[6];
+  CHECK(JS_GetProperty(cx, record, "a", &a));
+  CHECK(a == JS::Int32Value(12));
+
+  // Integer keys are stored as elements.
+  record = records[8];
+  JS::RootedValue zero(cx);
+  CHECK(JS_GetElement(cx, record, 0, &zero));
+  CHECK(zero == JS::Int32Value(15));
+  CHECK(JS_GetProperty(cx, record, "a", &a));
+  CHECK(a == JS::Int32Value(16));
+
+  return true;
+}
+END_TEST(testParseJSON_recordShapes)
+
+BEGIN_TEST(testParseJSON_stream) {
+  AutoInflatedString str(cx);
+  str =
+      "{\"a\": [1, -2.5e3, true, false, null, \"x\\\"y\\u0041\"],\r\n"
+      " \"b\": {\"c\": {}, \"d\": [[]]}, \"\": 0.5} ";
+  const char* expected =
+      "{\"a\":[1,-2500,true,false,null,\"x\\\"yA\"],\"b\":{\"c\":{},"
+      "\"d\":[[]]},\"\":0.5}";
+
+  // Split the input in two at every position.
+  for (size_t i = 0; i <= str.length(); i++) {
+    JS::RootedObject parser(cx, JS::NewJSONStreamParser(cx));
+    CHECK(parser);
+    CHECK(JS::JSONStreamParserFeed(cx, parser, str.chars(), i));
+    CHECK(JS::JSONStreamParserFeed(cx, parser, str.chars() + i,
+                                   str.length() - i));
+    JS::RootedValue v(cx);
+    CHECK(JS::JSONStreamParserFinish(cx, parser, &v));
+    CHECK(StringifiesTo(v, expected));
+  }
+
+  // Feed one character at a time, collecting garbage in between such that
+  // the values of unfinished arrays and objects are moved.
+  {
+    JS::RootedObject parser(cx, JS::NewJSONStreamParser(cx));
+    CHECK(parser);
+    for (size_t i = 0; i < str.length(); i++) {
+      CHECK(JS::JSONStreamParserFeed(cx, parser, str.chars() + i, 1));
+      JS_GC(cx);
+    }
+    JS::RootedValue v(cx);
+    CHECK(JS::JSONStreamParserFinish(cx, parser, &v));
+    CHECK(StringifiesTo(v, expected));
+  }
+
+  // Escaped backslashes and quotes in a string literal cut off after every
+  // character, where the scan of the literal resumes in and out of escapes.
+  CHECK(StreamOneCharAtATime("[\"\\\\\\\"\\\\\", 1]",
+                             "[\"\\\\\\\"\\\\\",1]"));
+
+  // Errors are reported by the call which finds them, with their position in
+  // the whole input.
+  CHECK(StreamError({"[1,\n", " 2,", "]"}, 2, 4));
+  CHECK(StreamError({"[1, 2", " 3]"}, 1, 7));
+  CHECK(StreamError({"[1,\r", "\n]"}, 2, 1));
+  CHECK(StreamError({"{\"a", "b\" 1}"}, 1, 7));
+  CHECK(StreamError({"[1, 2"}, 1, 6));
+  CHECK(StreamError({"", "  "}, 1, 3));
+  CHECK(StreamError({"[tr", "ue] x"}, 1, 8));
+
+  return true;
+}
+
+bool StreamOneCharAtATime(const char* input, const char* expected) {
+  AutoInflatedString str(cx);
+  str = input;
+  JS::RootedObject parser(cx, JS::NewJSONStreamParser(cx));
+  CHECK(parser);
+  for (size_t i = 0; i < str.length(); i++) {
+    CHECK(JS::JSONStreamParserFeed(cx, parser, str.chars() + i, 1));
+  }
+  JS::RootedValue v(cx);
+  CHECK(JS::JSONStreamParserFinish(cx, parser, &v));
+  CHECK(StringifiesTo(v, expected));
+  return true;
+}
+
+bool StringifiesTo(JS::HandleValue v, const char* expected) {
+  CHECK(JS_SetProperty(cx, global, "streamResult", v));
+  JS::RootedValue str(cx);
+  EVAL("JSON.stringify(streamResult)", &str);
+  CHECK(str.isString());
+
+  bool match;
+  CHECK(JS_StringEqualsAscii(cx, str.toString(), expected, &match));
+  CHECK(match);
+  return true;
+}
+
+bool StreamError(std::initializer_list<const char*> chunks,
+                 uint32_t expectedLine, uint32_t expectedColumn) {
+  JS::RootedObject parser(cx, JS::NewJSONStreamParser(cx));
+  CHECK(parser);
+
+  bool ok = true;
+  for (const char* chunk : chunks) {
+    AutoInflatedString str(cx);
+    str = chunk;
+    ok = JS::JSONStreamParserFeed(cx, parser, str.chars(), str.length());
+    if (!ok) {
+      break;
+    }
+  }
+  if (ok) {
+    JS::RootedValue v(cx);
+    CHECK(!JS::JSONStreamParserFinish(cx, parser, &v));
+  }
+
+  JS::ExceptionStack exnStack(cx);
+  CHECK(StealPendingExceptionStack(cx, &exnStack));
+
+  JS::ErrorReportBuilder report(cx);
+  CHECK(report.init(cx, exnStack, JS::ErrorReportBuilder::WithSideEffects));
+  CHECK(report.report()->errorNumber == JSMSG_JSON_BAD_PARSE);
+
+  UniqueChars lineAndColumnASCII =
+      JS_smprintf("line %d column %d", expectedLine, expectedColumn);
+  CHECK(strstr(report.toStringResult().c_str(), lineAndColumnASCII.get()) !=
+        nullptr);
+  return true;
+}
+END_TEST(testParseJSON_stream)
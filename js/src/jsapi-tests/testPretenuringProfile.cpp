@@ -0,0 +1,149 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+
+#include "jsfriendapi.h"  // js::{Encode,Decode}PretenuringProfile
+
+#include "gc/Pretenuring.h"  // js::gc::{AllocSite,PretenuringProfile}
+#include "jit/JitScript.h"   // js::jit::{AutoKeepJitScripts,JitScript}
+#include "js/Transcoding.h"  // JS::TranscodeBuffer, JS::TranscodeRange
+#include "jsapi-tests/tests.h"
+#include "vm/JSFunction.h"
+#include "vm/JSScript.h"
+#include "vm/ProfileTranscoding.h"  // js::ProfileReader
+
+#include "jit/JitScript-inl.h"
+
+using namespace js;
+using namespace js::gc;
+
+BEGIN_TEST(testPretenuringProfile) {
+  JS::RootedValue v(cx);
+  EVAL("(function f() { return [{}, {}]; })", &v);
+  JS::RootedFunction fun(cx, &v.toObject().as<JSFunction>());
+  JS::RootedScript script(cx, JS_GetFunctionScript(cx, fun));
+  CHECK(script);
+
+  AllocSite site(cx->zone(), script, 1, JS::TraceKind::Object);
+  AllocSite otherSite(cx->zone(), script, 2, JS::TraceKind::Object);
+  PretenuringProfile::SiteKey key = PretenuringProfile::getSiteKey(&site);
+  CHECK(key != 0);
+  CHECK(PretenuringProfile::getSiteKey(&otherSite) != key);
+
+  // Sites start out in the nursery when there is no profile.
+  PretenuringProfile profile;
+  profile.maybeInitSite(&site);
+  CHECK(site.initialHeap() == Heap::Default);
+
+  uint32_t keyWords[2];
+  memcpy(keyWords, &key, sizeof(key));
+  const uint32_t encoded[] = {PretenuringProfile::EncodingMagic,
+                              PretenuringProfile::EncodingVersion, 1,
+                              keyWords[0], keyWords[1]};
+  JS::TranscodeRange range(reinterpret_cast<const uint8_t*>(encoded),
+                           sizeof(encoded));
+
+  // Malformed data is rejected without changing the profile. The checks
+  // shared by all profiles are covered by testProfileTranscoding.
+  CHECK(!profile.decode(JS::TranscodeRange(range.begin().get(),
+                                           range.length() - 1)));
+  CHECK_EQUAL(profile.count(), 0u);
+
+  // Sites recorded by a previous run start out tenured.
+  CHECK(profile.decode(range));
+  CHECK_EQUAL(profile.count(), 1u);
+  profile.maybeInitSite(&site);
+  profile.maybeInitSite(&otherSite);
+  CHECK(site.initialHeap() == Heap::Tenured);
+  CHECK(otherSite.initialHeap() == Heap::Default);
+
+  // Decoding the same sites again does not duplicate them.
+  CHECK(profile.decode(range));
+  CHECK_EQUAL(profile.count(), 1u);
+
+  // The encoding round-trips.
+  JS::TranscodeBuffer buffer;
+  CHECK(profile.encode(buffer));
+  CHECK_EQUAL(buffer.length(), sizeof(encoded));
+  CHECK(memcmp(buffer.begin(), encoded, sizeof(encoded)) == 0);
+
+  return true;
+}
+END_TEST(testPretenuringProfile)
+
+BEGIN_TEST(testPretenuringProfile_RuntimeAPI) {
+  JS::TranscodeBuffer buffer;
+  CHECK(js::EncodePretenuringProfile(cx, buffer));
+  JS::TranscodeRange range(buffer.begin(), buffer.length());
+  CHECK(js::DecodePretenuringProfile(cx, range));
+
+  return true;
+}
+END_TEST(testPretenuringProfile_RuntimeAPI)
+
+static bool ProfileHasSite(JSContext* cx, PretenuringProfile::SiteKey key) {
+  JS::TranscodeBuffer buffer;
+  MOZ_RELEASE_ASSERT(js::EncodePretenuringProfile(cx, buffer));
+
+  ProfileReader reader(JS::TranscodeRange(buffer.begin(), buffer.length()));
+  uint32_t count;
+  MOZ_RELEASE_ASSERT(reader.readHeader(PretenuringProfile::EncodingMagic,
+                                       PretenuringProfile::EncodingVersion));
+  MOZ_RELEASE_ASSERT(reader.readUint32(&count));
+  for (uint32_t i = 0; i < count; i++) {
+    uint64_t site;
+    MOZ_RELEASE_ASSERT(reader.readUint64(&site));
+    if (site == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// A site pretenured because of the profile is forgotten by the profile once
+// the engine resets it, as it does when pretenured sites cause too many
+// invalidations.
+BEGIN_TEST(testPretenuringProfile_ForgetResetSites) {
+  JS::RootedValue v(cx);
+  EVAL("(function g() { return {}; })", &v);
+  JS::RootedFunction fun(cx, &v.toObject().as<JSFunction>());
+  JS::RootedScript script(cx, JS_GetFunctionScript(cx, fun));
+  CHECK(script);
+
+  static constexpr uint32_t PCOffset = 1;
+  AllocSite keySite(cx->zone(), script, PCOffset, JS::TraceKind::Object);
+  PretenuringProfile::SiteKey key = PretenuringProfile::getSiteKey(&keySite);
+  CHECK(key != 0);
+
+  uint32_t keyWords[2];
+  memcpy(keyWords, &key, sizeof(key));
+  const uint32_t encoded[] = {PretenuringProfile::EncodingMagic,
+                              PretenuringProfile::EncodingVersion, 1,
+                              keyWords[0], keyWords[1]};
+  CHECK(js::DecodePretenuringProfile(
+      cx, JS::TranscodeRange(reinterpret_cast<const uint8_t*>(encoded),
+                             sizeof(encoded))));
+  CHECK(ProfileHasSite(cx, key));
+
+  jit::AutoKeepJitScripts keepJitScript(cx);
+  CHECK(script->ensureHasJitScript(cx, keepJitScript));
+  jit::JitScript* jitScript = script->jitScript();
+  AllocSite* site =
+      jitScript->icScript()->getOrCreateAllocSite(script, PCOffset);
+  CHECK(site);
+  CHECK(site->isNormal());
+  CHECK(site->initialHeap() == Heap::Tenured);
+
+  CHECK(jitScript->resetAllocSites(/* resetNurserySites = */ false,
+                                   /* resetPretenuredSites = */ true));
+  CHECK(site->initialHeap() == Heap::Default);
+  CHECK(!ProfileHasSite(cx, key));
+
+  return true;
+}
+END_TEST(testPretenuringProfile_ForgetResetSites)
@@ -0,0 +1,53 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "js/Transcoding.h"  // JS::TranscodeBuffer, JS::TranscodeRange
+#include "jsapi-tests/tests.h"
+#include "vm/ProfileTranscoding.h"  // js::ProfileReader, js::ProfileWriter
+
+using namespace js;
+
+static constexpr uint32_t Magic = 0x54534554;  // 'TEST'
+static constexpr uint32_t Version = 3;
+
+static bool ReadAll(const JS::TranscodeBuffer& buffer, size_t length,
+                    uint32_t magic = Magic, uint32_t version = Version) {
+  ProfileReader reader(JS::TranscodeRange(buffer.begin(), length));
+  uint32_t u32;
+  uint64_t u64;
+  const uint8_t* bytes;
+  return reader.readHeader(magic, version) && reader.readUint32(&u32) &&
+         u32 == 7 && reader.readUint64(&u64) && u64 == 0x123456789 &&
+         reader.readBytes(&bytes, 3) && bytes[2] == 'c' && reader.done();
+}
+
+BEGIN_TEST(testProfileTranscoding) {
+  JS::TranscodeBuffer buffer;
+  ProfileWriter writer(buffer, Magic, Version);
+  writer.writeUint32(7);
+  writer.writeUint64(0x123456789);
+  writer.writeBytes(reinterpret_cast<const uint8_t*>("abc"), 3);
+  CHECK(writer.ok());
+
+  CHECK(ReadAll(buffer, buffer.length()));
+
+  // Another kind of profile, or another version of the format.
+  CHECK(!ReadAll(buffer, buffer.length(), Magic + 1, Version));
+  CHECK(!ReadAll(buffer, buffer.length(), Magic, Version + 1));
+
+  // Every truncation is detected.
+  for (size_t length = 0; length < buffer.length(); length++) {
+    CHECK(!ReadAll(buffer, length));
+  }
+
+  // Trailing garbage.
+  CHECK(buffer.append(0));
+  CHECK(!ReadAll(buffer, buffer.length()));
+
+  return true;
+}
+END_TEST(testProfileTranscoding)
@@ -2,9 +2,19 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include "mozilla/Sprintf.h"
+
+#include <string.h>
+
+#include "js/GCAPI.h"
 #include "js/RegExp.h"
 #include "js/RegExpFlags.h"
 #include "jsapi-tests/tests.h"
+#include "vm/Caches.h"
+#include "vm/RegExpObject.h"
+#include "vm/RegExpShared.h"
+#include "vm/Runtime.h"
+#include "vm/StringType.h"
 
 BEGIN_TEST(testObjectIsRegExp) {
   JS::RootedValue val(cx);
@@ -63,3 +73,165 @@ BEGIN_TEST(testGetRegExpSource) {
   return true;
 }
 END_TEST(testGetRegExpSource)
+
+// Run the same regexps in two globals so that the second one can use bytecode
+// cached by the first, on both Latin1 and TwoByte input.
+BEGIN_TEST(testRegExpBytecodeCache_Globals) {
+  static const char source[] =
+      "function check(cond) { if (!cond) throw new Error('bad match'); }"
+      "var m = /(\\d+)-(\\d+)/.exec('x 12-34 y');"
+      "check(m && m.index === 2 && m[1] === '12' && m[2] === '34');"
+      "m = /(\\d+)-(\\d+)/.exec('x \\u263a 12-34 y');"
+      "check(m && m.index === 4 && m[1] === '12' && m[2] === '34');"
+      "check('aXbxc'.replace(/x/gi, '-') === 'a-b-c');"
+      "check('a\\u263aXbxc'.replace(/x/gi, '-') === 'a\\u263a-b-c');"
+      "var re = /a|b/y;"
+      "check(re.test('ab') && re.lastIndex === 1 && !re.test('ac'));"
+      "check(/^(?:a+)+$/.test('aaaa') && !/^(?:a+)+$/.test('aaab'));"
+      "check(String('ab12cd'.match(/[a-z]+/g)) === 'ab,cd');";
+
+  EXEC(source);
+
+  JS::RootedObject otherGlobal(cx, createGlobal(nullptr));
+  CHECK(otherGlobal);
+  {
+    JSAutoRealm ar(cx, otherGlobal);
+    EXEC(source);
+  }
+
+  return true;
+}
+END_TEST(testRegExpBytecodeCache_Globals)
+
+// The bytecode follows the ByteArrayData header.
+static uint8_t* BytecodeData(js::RegExpBytecodeCache::ByteCode* bytecode) {
+  return reinterpret_cast<uint8_t*>(bytecode + 1);
+}
+
+BEGIN_TEST(testRegExpBytecodeCache_LookupAndPurge) {
+  using js::RegExpBytecodeCache;
+
+  RegExpBytecodeCache& cache = cx->runtime()->caches().regExpBytecodeCache;
+
+  JS::RootedString str(cx, JS_AtomizeAndPinString(cx, "ab(c)d"));
+  CHECK(str);
+  JS::Rooted<JSAtom*> pattern(cx, &str->asAtom());
+  str = JS_AtomizeAndPinString(cx, "ab");
+  CHECK(str);
+  JS::Rooted<JSAtom*> prefix(cx, &str->asAtom());
+  JS::RegExpFlags flags(JS::RegExpFlag::Global);
+
+  static const uint8_t data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  size_t size = sizeof(RegExpBytecodeCache::ByteCode) + sizeof(data);
+  RegExpBytecodeCache::UniqueByteCode bytecode(
+      static_cast<RegExpBytecodeCache::ByteCode*>(js_malloc(size)));
+  CHECK(bytecode);
+  new (bytecode.get()) RegExpBytecodeCache::ByteCode(sizeof(data));
+  memcpy(BytecodeData(bytecode.get()), data, sizeof(data));
+
+  cache.maybePut(pattern, flags, true, 2, 6, prefix, bytecode.get());
+
+  // Only a lookup with the same pattern, flags and encoding hits.
+  RegExpBytecodeCache::Compilation result;
+  CHECK(!cache.lookup(pattern, JS::RegExpFlags(JS::RegExpFlag::NoFlags), true,
+                      &result));
+  CHECK(!cache.lookup(pattern, flags, false, &result));
+  CHECK(!cache.lookup(prefix, flags, true, &result));
+
+  CHECK(cache.lookup(pattern, flags, true, &result));
+  CHECK(result.byteCode);
+  CHECK(result.byteCode.get() != bytecode.get());
+  CHECK_EQUAL(result.byteCode->length(), sizeof(data));
+  CHECK(memcmp(BytecodeData(result.byteCode.get()), data, sizeof(data)) == 0);
+  CHECK_EQUAL(result.pairCount, 2u);
+  CHECK_EQUAL(result.maxRegisters, 6u);
+  CHECK_EQUAL(result.requiredPrefixLength, 2u);
+  CHECK(result.requiredPrefix[0] == 'a' && result.requiredPrefix[1] == 'b');
+
+  // Entries survive ordinary GCs but not shrinking ones.
+  JS_GC(cx);
+  CHECK(cache.lookup(pattern, flags, true, &result));
+
+  JS::PrepareForFullGC(cx);
+  JS::NonIncrementalGC(cx, JS::GCOptions::Shrink, JS::GCReason::API);
+  CHECK(!cache.lookup(pattern, flags, true, &result));
+
+  return true;
+}
+END_TEST(testRegExpBytecodeCache_LookupAndPurge)
+
+static JSAtom* RequiredPrefix(JSContext* cx, JS::HandleValue val) {
+  JS::Rooted<js::RegExpObject*> regexp(cx,
+                                       &val.toObject().as<js::RegExpObject>());
+  js::RegExpShared* shared = js::RegExpObject::getShared(cx, regexp);
+  if (!shared || shared->kind() != js::RegExpShared::Kind::RegExp) {
+    return nullptr;
+  }
+  return shared->requiredPrefix();
+}
+
+// Check which regexps get a required literal prefix, and that searching for it
+// before running the matcher finds the same matches.
+BEGIN_TEST(testRegExpRequiredPrefix) {
+  static const struct {
+    const char* regexp;
+    const char* prefix;  // UTF-8
+  } cases[] = {
+      {"/abc\\d+/", "abc"},
+      {"/(foo)\\d/g", "foo"},
+      {"/\\u263ax\\d/u", "\xe2\x98\xba" "x"},
+      {"/abc\\d+/i", nullptr},
+      {"/abc\\d/y", nullptr},
+      {"/\\d+abc/", nullptr},
+      {"/^abc\\d/", nullptr},
+      {"/abc|abd/", nullptr},
+  };
+
+  JS::RootedValue val(cx);
+  for (const auto& test : cases) {
+    char script[64];
+    SprintfLiteral(script, "var re = %s; re.exec('xabc1'); re", test.regexp);
+    EVAL(script, &val);
+
+    JS::Rooted<JSAtom*> prefix(cx, RequiredPrefix(cx, val));
+    if (!test.prefix) {
+      CHECK(!prefix);
+      continue;
+    }
+    CHECK(prefix);
+    JS::RootedString expected(
+        cx, JS_NewStringCopyUTF8Z(cx, JS::ConstUTF8CharsZ(test.prefix)));
+    CHECK(expected);
+    int32_t result;
+    CHECK(JS_CompareStrings(cx, prefix, expected, &result));
+    CHECK_EQUAL(result, 0);
+  }
+
+  EXEC(
+      "function check(cond) { if (!cond) throw new Error('bad match'); }"
+      "var m = /abc\\d+/.exec('xxabc123');"
+      "check(m && m.index === 2 && m[0] === 'abc123');"
+      "check(/abc\\d+/.exec('abd123 abcx') === null);"
+      "check(String('abc1 abc22 abcx abc3'.match(/abc\\d+/g)) ==="
+      "      'abc1,abc22,abc3');"
+      "var re = /abc\\d/g;"
+      "re.lastIndex = 1;"
+      "m = re.exec('abc1abc2');"
+      "check(m && m.index === 4 && re.lastIndex === 8);"
+      "check(re.exec('abc1abc2') === null && re.lastIndex === 0);"
+      "m = /abc(?<=xabc)\\d/.exec('abc1xabc2');"
+      "check(m && m.index === 5);"
+      "re = /a\\d/gu;"
+      "re.lastIndex = 1;"
+      "m = re.exec('\\ud83d\\ude00a1');"
+      "check(m && m.index === 2);"
+      "m = /\\u263ax(\\d)/.exec('\\u263a\\u263ax7');"
+      "check(m && m.index === 1 && m[1] === '7');"
+      "m = /abc\\d/.exec('x'.repeat(100000) + 'abc9');"
+      "check(m && m.index === 100000);"
+      "check('foo1 foo2 bar3'.replace(/(foo)\\d/g, '$1!') ==="
+      "      'foo! foo! bar3');");
+
+  return true;
+}
+END_TEST(testRegExpRequiredPrefix)
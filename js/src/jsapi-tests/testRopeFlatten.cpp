@@ -0,0 +1,82 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <iterator>
+
+#include "js/Vector.h"
+#include "jsapi-tests/tests.h"
+#include "vm/StringType.h"
+
+using namespace js;
+
+static size_t LeftSpineDepth(JSString* str) {
+  size_t depth = 0;
+  while (str->isRope()) {
+    depth++;
+    str = str->asRope().leftChild();
+  }
+  return depth;
+}
+
+// Check that appending in a loop keeps ropes shallow and that flattening
+// copies Latin1 and TwoByte leaves of every length correctly.
+BEGIN_TEST(testRopeFlatten_Append) {
+  static const char16_t twoByte[] = u"\u263a\u263b";
+  static const char latin1[] = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJ";
+
+  Vector<char16_t, 0, SystemAllocPolicy> expected;
+  JS::RootedString result(cx, JS_GetEmptyString(cx));
+  JS::RootedString piece(cx);
+
+  for (size_t i = 0; i < 2000; i++) {
+    if (i == 1000) {
+      piece = JS_NewUCStringCopyN(cx, twoByte, std::size(twoByte) - 1);
+      CHECK(piece);
+      CHECK(expected.append(twoByte, std::size(twoByte) - 1));
+    } else {
+      size_t length = i % (std::size(latin1) - 1) + 1;
+      piece = JS_NewStringCopyN(cx, latin1, length);
+      CHECK(piece);
+      for (size_t j = 0; j < length; j++) {
+        CHECK(expected.append(char16_t(latin1[j])));
+      }
+    }
+
+    result = ConcatStrings<CanGC>(cx, result, piece);
+    CHECK(result);
+    CHECK(LeftSpineDepth(result) < JSRope::EagerFlattenDepth);
+    if (result->isRope()) {
+      CHECK_EQUAL(result->asRope().leftSpineDepth(), LeftSpineDepth(result));
+    }
+  }
+
+  JS::RootedString expectedStr(
+      cx, JS_NewUCStringCopyN(cx, expected.begin(), expected.length()));
+  CHECK(expectedStr);
+
+  bool equal;
+  CHECK(EqualStrings(cx, result, expectedStr, &equal));
+  CHECK(equal);
+
+  return true;
+}
+END_TEST(testRopeFlatten_Append)
+
+BEGIN_TEST(testRopeFlatten_Script) {
+  JS::RootedValue v(cx);
+  EVAL(
+      "var s = '';"
+      "for (var i = 0; i < 20000; i++) { s += i % 10; }"
+      "var parts = [];"
+      "for (var i = 0; i < 20000; i++) { parts.push(i % 10); }"
+      "s === parts.join('')",
+      &v);
+  CHECK(v.isTrue());
+
+  return true;
+}
+END_TEST(testRopeFlatten_Script)
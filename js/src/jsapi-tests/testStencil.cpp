@@ -15,6 +15,7 @@
 #include "js/experimental/CompileScript.h"
 #include "js/experimental/JSStencil.h"
 #include "js/Modules.h"
+#include "js/Printer.h"  // js::Sprinter
 #include "js/PropertyAndElement.h"  // JS_GetProperty, JS_HasOwnProperty, JS_SetProperty
 #include "js/Transcoding.h"
 #include "jsapi-tests/tests.h"
@@ -352,3 +353,74 @@ static bool TestGetBuildId(JS::BuildIdCharVector* buildId) {
   return buildId->append(buildid, sizeof(buildid));
 }
 END_TEST(testStencil_TranscodeBorrowing)
+
+BEGIN_TEST(testStencil_TranscodeManyFunctions) {
+  JS::SetProcessBuildIdOp(TestGetBuildId);
+
+  // Enough non-lazy functions for the shared data to be decoded in parallel.
+  static const size_t FunctionCount = 1000;
+
+  js::Sprinter chars(cx);
+  CHECK(chars.init());
+  for (size_t i = 0; i < FunctionCount; i++) {
+    chars.printf("function f%zu() { return %zu; }\n", i, i);
+  }
+  chars.printf("f%zu();", FunctionCount - 1);
+  JS::UniqueChars source = chars.release();
+  CHECK(source);
+
+  JS::TranscodeBuffer buffer;
+  {
+    JS::SourceText<mozilla::Utf8Unit> srcBuf;
+    CHECK(srcBuf.init(cx, source.get(), strlen(source.get()),
+                      JS::SourceOwnership::Borrowed));
+
+    JS::CompileOptions options(cx);
+    options.setForceFullParse();
+    RefPtr<JS::Stencil> stencil =
+        JS::CompileGlobalScriptToStencil(cx, options, srcBuf);
+    CHECK(stencil);
+
+    JS::TranscodeResult res = JS::EncodeStencil(cx, stencil, buffer);
+    CHECK(res == JS::TranscodeResult::Ok);
+  }
+
+  RefPtr<JS::Stencil> stencil;
+  {
+    JS::DecodeOptions decodeOptions;
+    JS::TranscodeRange range(buffer.begin(), buffer.length());
+    JS::TranscodeResult res =
+        JS::DecodeStencil(cx, decodeOptions, range, getter_AddRefs(stencil));
+    CHECK(res == JS::TranscodeResult::Ok);
+  }
+
+  // A truncated buffer must be rejected.
+  {
+    RefPtr<JS::Stencil> truncated;
+    JS::DecodeOptions decodeOptions;
+    JS::TranscodeRange range(buffer.begin(), buffer.length() / 2);
+    JS::TranscodeResult res = JS::DecodeStencil(cx, decodeOptions, range,
+                                                getter_AddRefs(truncated));
+    CHECK(res != JS::TranscodeResult::Ok);
+    CHECK(!truncated);
+    JS_ClearPendingException(cx);
+  }
+
+  memset(buffer.begin(), 0, buffer.length());
+  buffer.clear();
+
+  JS::InstantiateOptions instantiateOptions;
+  JS::RootedScript script(
+      cx, JS::InstantiateGlobalStencil(cx, instantiateOptions, stencil));
+  CHECK(script);
+  JS::RootedValue rval(cx);
+  CHECK(JS_ExecuteScript(cx, script, &rval));
+  CHECK(rval.isNumber() && rval.toNumber() == double(FunctionCount - 1));
+
+  return true;
+}
+static bool TestGetBuildId(JS::BuildIdCharVector* buildId) {
+  const char buildid[] = "testXDR";
+  return buildId->append(buildid, sizeof(buildid));
+}
+END_TEST(testStencil_TranscodeManyFunctions)
@@ -0,0 +1,57 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jsapi-tests/tests.h"
+
+// Compare indexOf, includes, split and replaceAll against a naive search on
+// long haystacks with many candidates whose first and last characters match
+// the pattern. Both Latin1 and TwoByte texts and patterns are covered.
+BEGIN_TEST(testStringSearch) {
+  EXEC(
+      "function naiveIndexOf(text, pat, start) {"
+      "  outer: for (var i = start; i + pat.length <= text.length; i++) {"
+      "    for (var j = 0; j < pat.length; j++) {"
+      "      if (text[j + i] !== pat[j]) continue outer;"
+      "    }"
+      "    return i;"
+      "  }"
+      "  return -1;"
+      "}"
+      "function check(text, pat) {"
+      "  var count = 0;"
+      "  for (var start = 0;; start++) {"
+      "    var expected = naiveIndexOf(text, pat, start);"
+      "    if (text.indexOf(pat, start) !== expected) throw [text, pat, start];"
+      "    if (expected === -1) break;"
+      "    start = expected;"
+      "    count++;"
+      "  }"
+      "  if (text.includes(pat) !== count > 0) throw [text, pat];"
+      "  var pieces = text.split(pat);"
+      "  if (pieces.join(pat) !== text) throw [text, pat];"
+      "  var replaced = text.replaceAll(pat, '');"
+      "  if (pieces.join('') !== replaced) throw [text, pat];"
+      "}"
+      "var patterns = ['ab', 'aab', 'abba', 'a\\u263aa', 'abcdefghij',"
+      "                'aaaaaaaaaaaaaaaaaaab', '\\u263a\\u263b'];"
+      "var fillers = ['a', 'ab', 'abb', 'x\\u263a', 'abcdefghi'];"
+      "for (var filler of fillers) {"
+      "  var text = '';"
+      "  for (var i = 0; i < 300; i++) {"
+      "    text += filler;"
+      "    if (i % 37 === 0) text += patterns[i % patterns.length];"
+      "  }"
+      "  for (var pat of patterns) {"
+      "    check(text, pat);"
+      "    check(text.slice(1), pat);"
+      "    check(text + pat, pat);"
+      "  }"
+      "}");
+
+  return true;
+}
+END_TEST(testStringSearch)
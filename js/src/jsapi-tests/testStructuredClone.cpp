@@ -4,11 +4,13 @@
 
 #include "builtin/TestingFunctions.h"
 #include "js/ArrayBuffer.h"  // JS::{IsArrayBufferObject,GetArrayBufferLengthAndData,NewExternalArrayBuffer}
+#include "js/CallAndConstruct.h"     // JS_CallFunctionName
 #include "js/GlobalObject.h"        // JS_NewGlobalObject
-#include "js/PropertyAndElement.h"  // JS_GetProperty, JS_SetProperty
+#include "js/PropertyAndElement.h"  // JS_GetElement, JS_GetProperty, JS_SetProperty
 #include "js/StructuredClone.h"
 
 #include "jsapi-tests/tests.h"
+#include "vm/JSObject.h"
 
 using namespace js;
 
@@ -101,6 +103,137 @@ BEGIN_TEST(testStructuredClone_string) {
 }
 END_TEST(testStructuredClone_string)
 
+// Arrays of same-shaped plain objects are written with shape templates. Check
+// that they round-trip, including properties deleted during serialization.
+BEGIN_TEST(testStructuredClone_shapeTemplates) {
+  JS::RootedValue v1(cx);
+  EVAL(
+      "var records = [];"
+      "for (var i = 0; i < 100; i++) {"
+      "  records.push({id: i, name: 'r' + i, pos: {x: i, y: -i}});"
+      "}"
+      "records.push({id: 100, name: 'other'});"
+      "records.push(records[0]);"
+      "var parent = {a: {get g() { delete parent.b; return 1; }}, b: 2, c: 3};"
+      "records.push(parent, {a: 4, b: 5, c: 6});"
+      "records",
+      &v1);
+
+  JS::RootedValue v2(cx);
+  CHECK(JS_StructuredClone(cx, v1, &v2, nullptr, nullptr));
+  CHECK(v2.isObject());
+  CHECK(JS_SetProperty(cx, global, "cloned", v2));
+
+  JS::RootedValue result(cx);
+  EVAL(
+      "var expected = [];"
+      "for (var i = 0; i < 100; i++) {"
+      "  expected.push({id: i, name: 'r' + i, pos: {x: i, y: -i}});"
+      "}"
+      "expected.push({id: 100, name: 'other'}, expected[0],"
+      "              {a: {g: 1}, c: 3}, {a: 4, b: 5, c: 6});"
+      "JSON.stringify(cloned) === JSON.stringify(expected) &&"
+      "cloned[101] === cloned[0] && cloned[0] !== records[0]",
+      &result);
+  CHECK(result.isTrue());
+
+  // Objects read from the same template share their shape.
+  JS::RootedObject arr(cx, &v2.toObject());
+  JS::RootedValue first(cx);
+  JS::RootedValue second(cx);
+  CHECK(JS_GetElement(cx, arr, 0, &first));
+  CHECK(JS_GetElement(cx, arr, 99, &second));
+  CHECK(first.toObject().shape() == second.toObject().shape());
+
+  return true;
+}
+END_TEST(testStructuredClone_shapeTemplates)
+
+// ArrayBuffer contents are copied directly into uninitialized buffers when
+// read. Check inline and malloced buffer sizes, and buffers large enough to be
+// copied on helper threads.
+BEGIN_TEST(testStructuredClone_arrayBufferContents) {
+  EXEC(
+      "function makeBuffer(n) {"
+      "  var ta = new Uint8Array(n);"
+      "  for (var i = 0; i < n; i++) ta[i] = (i * 7 + 1) & 0xff;"
+      "  return ta.buffer;"
+      "}"
+      "function sameContents(a, b) {"
+      "  var x = new Uint8Array(a), y = new Uint8Array(b);"
+      "  if (a === b || x.length !== y.length) return false;"
+      "  for (var i = 0; i < x.length; i++) {"
+      "    if (x[i] !== y[i]) return false;"
+      "  }"
+      "  return true;"
+      "}");
+
+  static constexpr uint32_t MB = 1024 * 1024;
+  static const uint32_t sizes[] = {0,  1,  7,    8,      9,  63,
+                                   64, 65, 1000, 100000, MB, 3 * MB + 5};
+  for (uint32_t size : sizes) {
+    JS::RootedValue arg(cx, JS::NumberValue(size));
+    JS::RootedValue buffer(cx);
+    CHECK(JS_CallFunctionName(cx, global, "makeBuffer",
+                              JS::HandleValueArray(arg), &buffer));
+
+    JS::RootedValue clone(cx);
+    CHECK(JS_StructuredClone(cx, buffer, &clone, nullptr, nullptr));
+
+    JS::RootedValueArray<2> args(cx);
+    args[0].set(buffer);
+    args[1].set(clone);
+    JS::RootedValue result(cx);
+    CHECK(JS_CallFunctionName(cx, global, "sameContents", args, &result));
+    CHECK(result.isTrue());
+  }
+
+  return true;
+}
+END_TEST(testStructuredClone_arrayBufferContents)
+
+// Large buffers are still being copied while the rest of the clone is read.
+// Check that views, backreferences and other values read after them are
+// correct, and that the contents are complete once the read returns.
+BEGIN_TEST(testStructuredClone_largeArrayBufferGraph) {
+  EXEC(
+      "function fill(n, seed) {"
+      "  var ta = new Uint8Array(n);"
+      "  for (var i = 0; i < n; i++) ta[i] = (i * seed + 1) & 0xff;"
+      "  return ta;"
+      "}"
+      "var a = fill(2 * 1024 * 1024 + 3, 7);"
+      "var b = fill(5 * 1024 * 1024, 13);"
+      "var source = {"
+      "  a: a.buffer, b: b, c: new Int32Array(b.buffer, 8, 4), again: a.buffer,"
+      "  list: [1, 'two', {three: 3}]"
+      "};"
+      "function check(clone) {"
+      "  var ca = new Uint8Array(clone.a);"
+      "  if (ca.length !== a.length || clone.again !== clone.a) return false;"
+      "  if (clone.c.buffer !== clone.b.buffer || clone.c[1] !== "
+      "      new Int32Array(b.buffer, 8, 4)[1]) return false;"
+      "  for (var i = 0; i < a.length; i++) if (ca[i] !== a[i]) return false;"
+      "  for (var i = 0; i < b.length; i++) if (clone.b[i] !== b[i]) "
+      "    return false;"
+      "  return clone.list[1] === 'two' && clone.list[2].three === 3;"
+      "}");
+
+  JS::RootedValue source(cx);
+  CHECK(JS_GetProperty(cx, global, "source", &source));
+
+  JS::RootedValue clone(cx);
+  CHECK(JS_StructuredClone(cx, source, &clone, nullptr, nullptr));
+
+  JS::RootedValue result(cx);
+  CHECK(JS_CallFunctionName(cx, global, "check", JS::HandleValueArray(clone),
+                            &result));
+  CHECK(result.isTrue());
+
+  return true;
+}
+END_TEST(testStructuredClone_largeArrayBufferGraph)
+
 BEGIN_TEST(testStructuredClone_externalArrayBuffer) {
   ExternalData data("One two three four");
   auto dataPointer = data.pointer();
@@ -17,6 +17,7 @@
 #include "js/Object.h"           // JS::GetClass
 #include "js/shadow/Function.h"  // JS::shadow::Function
 #include "js/shadow/Object.h"    // JS::shadow::Object
+#include "js/Transcoding.h"        // JS::TranscodeBuffer, JS::TranscodeRange
 #include "js/TypeDecls.h"
 
 class JSJitInfo;
@@ -726,6 +727,62 @@ using JitExceptionHandler = long (*)(void* exceptionRecord,  // PEXECTION_RECORD
 extern JS_PUBLIC_API void SetJitExceptionHandler(JitExceptionHandler handler);
 #endif
 
+/**
+ * Serialize the JIT warm-up hints collected by this runtime (see the
+ * [SMDOC] JitHintsMap) into |buffer|, so that the embedder can store them and
+ * skip warm-up for the same scripts in a later process.  The buffer does not
+ * refer to any runtime state and can be written out on any thread.
+ *
+ * Returns true and leaves |buffer| untouched if JIT hints are disabled.
+ */
+extern JS_PUBLIC_API bool EncodeJitHints(JSContext* cx,
+                                         JS::TranscodeBuffer& buffer);
+
+/**
+ * Merge hints produced by EncodeJitHints into this runtime's hints.  This
+ * should be called early, before scripts run, e.g. right after
+ * JS::InitSelfHostedCode.  Returns false with no exception pending if the
+ * data could not be used, in which case the runtime is unaffected, and false
+ * with an exception pending on OOM.  Returns true without reading the data if
+ * JIT hints are disabled.
+ */
+extern JS_PUBLIC_API bool DecodeJitHints(JSContext* cx,
+                                         const JS::TranscodeRange& range);
+
+/**
+ * Append to |buffer| the order in which functions were first executed for the
+ * sources compiled with the ConcurrentProfileGuided delazification strategy.
+ * The profile is shared by all runtimes of the process.
+ */
+extern JS_PUBLIC_API bool EncodeDelazificationProfile(
+    JSContext* cx, JS::TranscodeBuffer& buffer);
+
+/**
+ * Merge a profile produced by EncodeDelazificationProfile into the profile of
+ * the process.  This should be called before compiling the sources it covers.
+ * Returns false if the data could not be used; no exception is reported in
+ * that case.
+ */
+extern JS_PUBLIC_API bool DecodeDelazificationProfile(
+    JSContext* cx, const JS::TranscodeRange& range);
+
+/**
+ * Append to |buffer| the allocation sites this runtime has decided to
+ * pretenure, so that the embedder can store them and have the same sites
+ * allocate in the tenured heap from the start in a later process.
+ */
+extern JS_PUBLIC_API bool EncodePretenuringProfile(JSContext* cx,
+                                                   JS::TranscodeBuffer& buffer);
+
+/**
+ * Merge a profile produced by EncodePretenuringProfile into this runtime's
+ * profile. This should be called before scripts run. Returns false if the data
+ * could not be used; no exception is reported in that case and the runtime is
+ * unaffected.
+ */
+extern JS_PUBLIC_API bool DecodePretenuringProfile(
+    JSContext* cx, const JS::TranscodeRange& range);
+
 extern JS_PUBLIC_API bool ReportIsNotFunction(JSContext* cx, JS::HandleValue v);
 
 class MOZ_STACK_CLASS JS_PUBLIC_API AutoAssertNoContentJS {
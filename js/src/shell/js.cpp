@@ -831,6 +831,9 @@ struct MOZ_STACK_CLASS EnvironmentPreparer
 
 const char* shell::selfHostedXDRPath = nullptr;
 bool shell::encodeSelfHostedCode = false;
+const char* shell::jitHintsPath = nullptr;
+const char* shell::delazificationProfilePath = nullptr;
+const char* shell::pretenuringProfilePath = nullptr;
 bool shell::enableCodeCoverage = false;
 bool shell::enableDisassemblyDumps = false;
 bool shell::offthreadBaselineCompilation = false;
@@ -12486,6 +12489,64 @@ static bool WriteSelfHostedXDRFile(JSContext* cx, JS::SelfHostedCache buffer) {
   return true;
 }
 
+// Profiles such as JIT hints are loaded from |path| at startup and written
+// back at exit. A missing file is not an error: it is expected on the first
+// run.
+using DecodeProfileFn = bool (*)(JSContext*, const JS::TranscodeRange&);
+using EncodeProfileFn = bool (*)(JSContext*, JS::TranscodeBuffer&);
+
+static void ReadProfileFile(JSContext* cx, const char* path,
+                            const char* description, DecodeProfileFn decode) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    return;
+  }
+  AutoCloseFile autoClose(file);
+
+  FileContents buffer(cx);
+  if (!ReadCompleteFile(cx, file, buffer)) {
+    JS_ClearPendingException(cx);
+    fprintf(stderr, "Unable to read %s file, ignoring it.\n", description);
+    return;
+  }
+
+  JS::TranscodeRange range(buffer.begin(), buffer.length());
+  if (!decode(cx, range)) {
+    if (JS_IsExceptionPending(cx)) {
+      JS_ClearPendingException(cx);
+      fprintf(stderr, "Unable to load %s file, ignoring it.\n", description);
+      return;
+    }
+    fprintf(stderr, "Invalid %s file, ignoring it.\n", description);
+  }
+}
+
+static bool WriteProfileFile(JSContext* cx, const char* path,
+                             const char* description, EncodeProfileFn encode) {
+  JS::TranscodeBuffer buffer;
+  if (!encode(cx, buffer)) {
+    return false;
+  }
+  if (buffer.empty()) {
+    return true;
+  }
+
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    fprintf(stderr, "Can't open %s file for writing.\n", description);
+    return false;
+  }
+  AutoCloseFile autoClose(file);
+
+  size_t cc = fwrite(buffer.begin(), 1, buffer.length(), file);
+  if (cc != buffer.length()) {
+    fprintf(stderr, "Short write on %s file.\n", description);
+    return false;
+  }
+
+  return true;
+}
+
 static bool SetGCParameterFromArg(JSContext* cx, char* arg) {
   char* c = strchr(arg, '=');
   if (!c) {
@@ -12696,6 +12757,18 @@ int main(int argc, char** argv) {
     return 1;
   }
 
+  if (jitHintsPath) {
+    ReadProfileFile(cx, jitHintsPath, "JIT hints", js::DecodeJitHints);
+  }
+  if (delazificationProfilePath) {
+    ReadProfileFile(cx, delazificationProfilePath, "delazification profile",
+                    js::DecodeDelazificationProfile);
+  }
+  if (pretenuringProfilePath) {
+    ReadProfileFile(cx, pretenuringProfilePath, "pretenuring profile",
+                    js::DecodePretenuringProfile);
+  }
+
   EnvironmentPreparer environmentPreparer(cx);
 
   JS::SetProcessLargeAllocationFailureCallback(my_LargeAllocFailCallback);
@@ -12715,6 +12788,22 @@ int main(int argc, char** argv) {
 
   result = Shell(cx, &op);
 
+  if (jitHintsPath && !WriteProfileFile(cx, jitHintsPath, "JIT hints",
+                                        js::EncodeJitHints)) {
+    JS_ClearPendingException(cx);
+  }
+  if (delazificationProfilePath &&
+      !WriteProfileFile(cx, delazificationProfilePath,
+                        "delazification profile",
+                        js::EncodeDelazificationProfile)) {
+    JS_ClearPendingException(cx);
+  }
+  if (pretenuringProfilePath &&
+      !WriteProfileFile(cx, pretenuringProfilePath, "pretenuring profile",
+                        js::EncodePretenuringProfile)) {
+    JS_ClearPendingException(cx);
+  }
+
 #ifdef DEBUG
   if (OOM_printAllocationCount) {
     printf("OOM max count: %" PRIu64 "\n", js::oom::simulator.counter());
@@ -12754,6 +12843,14 @@ bool InitOptionParser(OptionParser& op) {
       !op.addStringOption('\0', "selfhosted-xdr-mode", "(encode,decode,off)",
                           "Whether to encode/decode data of the file provided"
                           "with --selfhosted-xdr-path.") ||
+      !op.addStringOption('\0', "jit-hints-path", "[filename]",
+                          "Load JIT warm-up hints from the given file at "
+                          "startup and write the updated hints back to it at "
+                          "exit") ||
+      !op.addStringOption('\0', "pretenuring-profile", "[filename]",
+                          "Load the allocation sites pretenured by previous "
+                          "runs from the given file at startup and write the "
+                          "updated profile back to it at exit") ||
       !op.addBoolOption('i', "shell", "Enter prompt after running code") ||
       !op.addBoolOption('c', "compileonly",
                         "Only compile, don't run (syntax checking mode)") ||
@@ -12930,7 +13027,7 @@ bool InitOptionParser(OptionParser& op) {
           '\0', "ion-regalloc", "[mode]",
           "Specify Ion register allocation:\n"
           "  backtracking: Priority based backtracking register allocation "
-          "(default)\n"
+          "(default, except for very large functions)\n"
           "  simple: Simple register allocator optimized for compile time") ||
       !op.addBoolOption(
           '\0', "ion-eager",
@@ -12969,6 +13066,11 @@ bool InitOptionParser(OptionParser& op) {
       !op.addBoolOption(
           '\0', "enforce-aot-ics",
           "Enable enforcing only use of ahead-of-time-known ICs") ||
+      !op.addBoolOption(
+          '\0', "record-aot-ics",
+          "Record attached IC bodies and write new ones out as AOT corpus "
+          "files, along with a usage report, at exit (see "
+          "AOT_ICS_RECORD_DIR)") ||
 #endif
       !op.addIntOption(
           '\0', "baseline-warmup-threshold", "COUNT",
@@ -13153,9 +13255,15 @@ bool InitOptionParser(OptionParser& op) {
           '\0', "delazification-mode", "[option]",
           "Select one of the delazification mode for scripts given on the "
           "command line, valid options are: "
-          "'on-demand', 'concurrent-df', 'eager', 'concurrent-df+on-demand'. "
+          "'on-demand', 'concurrent-df', 'eager', 'concurrent-df+on-demand', "
+          "'concurrent-profile-guided'. "
           "Choosing 'concurrent-df+on-demand' will run both concurrent-df and "
           "on-demand delazification mode, and compare compilation outcome. ") ||
+      !op.addStringOption('\0', "delazification-profile", "[filename]",
+                          "Load the functions executed by previous runs from "
+                          "the given file at startup, for the "
+                          "concurrent-profile-guided delazification mode, and "
+                          "write the updated profile back to it at exit") ||
       !op.addBoolOption('\0', "wasm-compile-and-serialize",
                         "Compile the wasm bytecode from stdin and serialize "
                         "the results to stdout") ||
@@ -13480,6 +13588,15 @@ bool SetGlobalOptionsPostJSInit(const OptionParser& op) {
   if (const char* xdr = op.getStringOption("selfhosted-xdr-path")) {
     shell::selfHostedXDRPath = xdr;
   }
+  if (const char* path = op.getStringOption("jit-hints-path")) {
+    shell::jitHintsPath = path;
+  }
+  if (const char* path = op.getStringOption("delazification-profile")) {
+    shell::delazificationProfilePath = path;
+  }
+  if (const char* path = op.getStringOption("pretenuring-profile")) {
+    shell::pretenuringProfilePath = path;
+  }
   if (const char* opt = op.getStringOption("selfhosted-xdr-mode")) {
     if (strcmp(opt, "encode") == 0) {
       shell::encodeSelfHostedCode = true;
@@ -13572,6 +13689,9 @@ bool SetContextOptions(JSContext* cx, const OptionParser& op) {
                strcmp(mode, "on-demand+concurrent-df") == 0) {
       defaultDelazificationMode =
           JS::DelazificationOption::CheckConcurrentWithOnDemand;
+    } else if (strcmp(mode, "concurrent-profile-guided") == 0) {
+      defaultDelazificationMode =
+          JS::DelazificationOption::ConcurrentProfileGuided;
     } else {
       return OptionFailure("delazification-mode", mode);
     }
@@ -13953,6 +14073,9 @@ bool SetContextJITOptions(JSContext* cx, const OptionParser& op) {
   if (op.getBoolOption("enforce-aot-ics")) {
     jit::JitOptions.enableAOTICEnforce = true;
   }
+  if (op.getBoolOption("record-aot-ics")) {
+    jit::JitOptions.recordAOTICs = true;
+  }
 #endif
 
   if (op.getBoolOption("blinterp")) {
@@ -103,6 +103,9 @@ extern char** sArgv;
 // Shell state set once at startup.
 extern const char* selfHostedXDRPath;
 extern bool encodeSelfHostedCode;
+extern const char* jitHintsPath;
+extern const char* delazificationProfilePath;
+extern const char* pretenuringProfilePath;
 extern bool enableCodeCoverage;
 extern bool enableDisassemblyDumps;
 extern bool offthreadBaselineCompilation;
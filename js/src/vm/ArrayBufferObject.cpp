@@ -2816,6 +2816,21 @@ FixedLengthArrayBufferObject* ArrayBufferObject::createZeroed(
   return buffer;
 }
 
+FixedLengthArrayBufferObject* ArrayBufferObject::createUninitialized(
+    JSContext* cx, size_t nbytes) {
+  if (!CheckArrayBufferTooLarge(cx, nbytes)) {
+    MOZ_DIAGNOSTIC_ASSERT(!cx->brittleMode, "buffer too large");
+    return nullptr;
+  }
+
+  AutoSetNewObjectMetadata metadata(cx);
+  auto [buffer, toFill] = createBufferAndData<FixedLengthArrayBufferObject,
+                                              FillContents::Uninitialized>(
+      cx, nbytes, metadata);
+  (void)toFill;
+  return buffer;
+}
+
 ResizableArrayBufferObject* ResizableArrayBufferObject::createZeroed(
     JSContext* cx, size_t byteLength, size_t maxByteLength,
     HandleObject proto /* = nullptr */) {
@@ -2853,6 +2868,21 @@ ImmutableArrayBufferObject* ImmutableArrayBufferObject::createZeroed(
   return buffer;
 }
 
+ImmutableArrayBufferObject* ImmutableArrayBufferObject::createUninitialized(
+    JSContext* cx, size_t byteLength) {
+  if (!CheckArrayBufferTooLarge(cx, byteLength)) {
+    MOZ_DIAGNOSTIC_ASSERT(!cx->brittleMode, "buffer too large");
+    return nullptr;
+  }
+
+  AutoSetNewObjectMetadata metadata(cx);
+  auto [buffer, toFill] = createBufferAndData<ImmutableArrayBufferObject,
+                                              FillContents::Uninitialized>(
+      cx, byteLength, metadata);
+  (void)toFill;
+  return buffer;
+}
+
 FixedLengthArrayBufferObject* ArrayBufferObject::createEmpty(JSContext* cx) {
   AutoSetNewObjectMetadata metadata(cx);
   auto* obj = NewArrayBufferObject(cx);
@@ -504,6 +504,12 @@ class ArrayBufferObject : public ArrayBufferObjectMaybeShared {
   static FixedLengthArrayBufferObject* createZeroed(
       JSContext* cx, size_t nbytes, HandleObject proto = nullptr);
 
+  // Like createZeroed, but leaves the contents uninitialized. The caller must
+  // fill in all |nbytes| bytes before the buffer can be observed, e.g. when
+  // copying the contents in from another buffer.
+  static FixedLengthArrayBufferObject* createUninitialized(JSContext* cx,
+                                                           size_t nbytes);
+
   // Create an ArrayBufferObject that is safely finalizable and can later be
   // initialize()d to become a real, content-visible ArrayBufferObject.
   static FixedLengthArrayBufferObject* createEmpty(JSContext* cx);
@@ -839,6 +845,10 @@ class ImmutableArrayBufferObject : public ArrayBufferObject {
   static ImmutableArrayBufferObject* createZeroed(
       JSContext* cx, size_t byteLength, Handle<JSObject*> proto = nullptr);
 
+  // See ArrayBufferObject::createUninitialized.
+  static ImmutableArrayBufferObject* createUninitialized(JSContext* cx,
+                                                         size_t byteLength);
+
  private:
   uint8_t* inlineDataPointer() const;
 
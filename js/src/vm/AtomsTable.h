@@ -20,6 +20,14 @@
 /*
  * The atoms table is a mapping from strings to JSAtoms that supports
  * incremental sweeping.
+ *
+ * The table is only accessed from the thread that owns the runtime, so it is
+ * not protected by a lock. Helper threads never create JSAtoms: off-thread
+ * parsing atomizes into a frontend::ParserAtomsTable and the results are
+ * converted to JSAtoms when the stencil is instantiated on the main thread.
+ * The permanent atoms are shared by all runtimes in a FrozenAtomSet that is
+ * never modified after startup and so can be read from any thread without
+ * synchronization.
  */
 
 namespace js {
@@ -10,11 +10,14 @@
 #include "mozilla/Array.h"
 #include "mozilla/MathAlgorithms.h"
 #include "mozilla/Maybe.h"
+#include "mozilla/MemoryReporting.h"
 #include "mozilla/MruCache.h"
 #include "mozilla/UniquePtr.h"
 
 #include "frontend/ScopeBindingCache.h"
 #include "gc/Tracer.h"
+#include "irregexp/RegExpTypes.h"
+#include "js/RegExpFlags.h"
 #include "js/RootingAPI.h"
 #include "js/TypeDecls.h"
 #include "vm/JSScript.h"
@@ -522,6 +525,70 @@ class StringToAtomCache {
   }
 };
 
+// Runtime-wide cache of irregexp bytecode. RegExpShared cells belong to a
+// single zone, so every global that runs the same regexps (for example each
+// load of the same page) would otherwise parse and compile them again.
+//
+// Entries are keyed by the pattern's characters, its flags and the encoding of
+// the input the bytecode was compiled for. They own a copy of the pattern and
+// of the bytecode and hold no GC pointers, so the cache survives ordinary GCs
+// and is only purged by shrinking GCs. RegExps with named capture groups are
+// not cached, because their groups template object is zone-specific.
+class RegExpBytecodeCache {
+ public:
+  using ByteCode = irregexp::ByteArrayData;
+  using UniqueByteCode = UniquePtr<ByteCode, JS::FreePolicy>;
+
+  // The cache is direct-mapped: a new entry replaces whatever was in its slot.
+  static constexpr size_t NumEntries = 256;
+
+  // Don't keep copies of very large bytecode around.
+  static constexpr size_t MaxByteCodeLength = 16 * 1024;
+
+  // Bytecode together with the state RegExpShared needs to run it.
+  struct Compilation {
+    UniqueByteCode byteCode;
+    uint32_t pairCount = 0;
+    uint32_t maxRegisters = 0;
+    UniqueTwoByteChars requiredPrefix;
+    uint32_t requiredPrefixLength = 0;
+  };
+
+ private:
+  struct Entry {
+    HashNumber hash = 0;
+    JS::RegExpFlags flags;
+    bool latin1 = false;
+    uint32_t patternLength = 0;
+    UniqueTwoByteChars pattern;
+    Compilation compilation;
+
+    bool match(HashNumber lookupHash, JSAtom* atom,
+               JS::RegExpFlags lookupFlags, bool lookupLatin1) const;
+  };
+
+  mozilla::Array<Entry, NumEntries> entries_;
+
+  static HashNumber hash(JSAtom* pattern, JS::RegExpFlags flags, bool latin1);
+
+ public:
+  // Copy the compilation of |pattern| and |flags| for Latin1 or TwoByte input
+  // into |result|. Returns false if there is none. OOM is treated as a cache
+  // miss and is not reported.
+  bool lookup(JSAtom* pattern, JS::RegExpFlags flags, bool latin1,
+              Compilation* result);
+
+  // Store a copy of |byteCode| and |requiredPrefix|, which may be null. This is
+  // best effort and fails silently.
+  void maybePut(JSAtom* pattern, JS::RegExpFlags flags, bool latin1,
+                uint32_t pairCount, uint32_t maxRegisters,
+                JSAtom* requiredPrefix, ByteCode* byteCode);
+
+  void purge();
+
+  size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
+};
+
 #ifdef MOZ_EXECUTION_TRACING
 
 // Holds a handful of caches used for tracing JS execution. These effectively
@@ -614,6 +681,7 @@ class RuntimeCaches {
   UncompressedSourceCache uncompressedSourceCache;
   EvalCache evalCache;
   StringToAtomCache stringToAtomCache;
+  RegExpBytecodeCache regExpBytecodeCache;
 
 #ifdef MOZ_EXECUTION_TRACING
   TracingCaches tracingCaches;
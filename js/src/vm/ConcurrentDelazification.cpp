@@ -6,6 +6,8 @@
 
 #include "vm/ConcurrentDelazification.h"
 
+#include "jsfriendapi.h"  // js::EncodeDelazificationProfile, js::DecodeDelazificationProfile
+
 #include "mozilla/Assertions.h"       // MOZ_ASSERT, MOZ_CRASH
 #include "mozilla/RefPtr.h"           // RefPtr
 #include "mozilla/ReverseIterator.h"  // mozilla::Reversed
@@ -22,7 +24,11 @@
 #include "frontend/Stencil.h"  // TaggedScriptThingIndex, ScriptStencilExtra
 #include "js/AllocPolicy.h"    // ReportOutOfMemory
 #include "js/experimental/JSStencil.h"  // RefPtrTraits<JS::Stencil>
+#include "threading/ExclusiveData.h"    // ExclusiveData
 #include "vm/JSContext.h"               // JSContext
+#include "vm/JSScript.h"                // ScriptSource
+#include "vm/MutexIDs.h"                // mutexid
+#include "vm/ProfileTranscoding.h"      // ProfileReader, ProfileWriter
 
 using namespace js;
 
@@ -40,6 +46,136 @@ void const_swap(T& a, T& b) {
   temp->~T();
 }
 
+MOZ_RUNINIT static ExclusiveData<DelazificationProfile> gDelazificationProfile(
+    mutexid::DelazificationProfile);
+
+bool DelazificationProfile::SourceProfile::append(uint32_t sourceStart) {
+  auto p = recorded.lookupForAdd(sourceStart);
+  if (p) {
+    return true;
+  }
+  if (order.length() >= MaxFunctionsPerSource) {
+    return true;
+  }
+  return recorded.add(p, sourceStart) && order.append(sourceStart);
+}
+
+/* static */
+void DelazificationProfile::recordExecution(HashNumber sourceHash,
+                                            uint32_t sourceStart) {
+  MOZ_ASSERT(sourceHash);
+  auto profile = gDelazificationProfile.lock();
+  auto p = profile->sources_.lookupForAdd(sourceHash);
+  if (!p) {
+    if (profile->sources_.count() >= MaxSources ||
+        !profile->sources_.add(p, sourceHash, SourceProfile())) {
+      return;
+    }
+  }
+  (void)p->value().append(sourceStart);
+}
+
+/* static */
+bool DelazificationProfile::lookup(HashNumber sourceHash,
+                                   FunctionList& functions) {
+  MOZ_ASSERT(sourceHash);
+  MOZ_ASSERT(functions.empty());
+  auto profile = gDelazificationProfile.lock();
+  auto p = profile->sources_.lookup(sourceHash);
+  if (!p) {
+    return true;
+  }
+  return functions.appendAll(p->value().order);
+}
+
+// The encoding is:
+//
+//   uint32_t magic, version
+//   uint32_t sourceCount
+//   sourceCount * {
+//     uint32_t sourceHash, functionCount
+//     uint32_t sourceStarts[functionCount]
+//   }
+/* static */
+bool DelazificationProfile::encode(JS::TranscodeBuffer& buffer) {
+  auto profile = gDelazificationProfile.lock();
+  ProfileWriter writer(buffer, EncodingMagic, EncodingVersion);
+
+  writer.writeUint32(profile->sources_.count());
+  for (auto iter = profile->sources_.iter(); !iter.done(); iter.next()) {
+    const FunctionList& order = iter.get().value().order;
+    writer.writeUint32(iter.get().key());
+    writer.writeUint32(order.length());
+    for (uint32_t sourceStart : order) {
+      writer.writeUint32(sourceStart);
+    }
+  }
+
+  return writer.ok();
+}
+
+/* static */
+bool DelazificationProfile::decode(const JS::TranscodeRange& range) {
+  // Validate the whole buffer before touching the profile, so that a truncated
+  // or corrupted file never leaves partially merged sources behind.
+  uint32_t sourceCount;
+  {
+    ProfileReader reader(range);
+    if (!reader.readHeader(EncodingMagic, EncodingVersion) ||
+        !reader.readUint32(&sourceCount) || sourceCount > MaxSources) {
+      return false;
+    }
+
+    for (uint32_t i = 0; i < sourceCount; i++) {
+      uint32_t sourceHash, functionCount;
+      if (!reader.readUint32(&sourceHash) || sourceHash == 0 ||
+          !reader.readUint32(&functionCount) ||
+          functionCount > MaxFunctionsPerSource) {
+        return false;
+      }
+      for (uint32_t j = 0; j < functionCount; j++) {
+        uint32_t sourceStart;
+        if (!reader.readUint32(&sourceStart)) {
+          return false;
+        }
+      }
+    }
+
+    if (!reader.done()) {
+      return false;
+    }
+  }
+
+  auto profile = gDelazificationProfile.lock();
+  ProfileReader reader(range);
+  MOZ_ALWAYS_TRUE(reader.readHeader(EncodingMagic, EncodingVersion));
+  MOZ_ALWAYS_TRUE(reader.readUint32(&sourceCount));
+  for (uint32_t i = 0; i < sourceCount; i++) {
+    uint32_t sourceHash, functionCount;
+    MOZ_ALWAYS_TRUE(reader.readUint32(&sourceHash));
+    MOZ_ALWAYS_TRUE(reader.readUint32(&functionCount));
+
+    // Sources which no longer fit in the profile are skipped.
+    auto p = profile->sources_.lookupForAdd(sourceHash);
+    if (!p && profile->sources_.count() < MaxSources &&
+        !profile->sources_.add(p, sourceHash, SourceProfile())) {
+      return false;
+    }
+
+    // Functions recorded by this process come first, and the decoded ones
+    // which are not yet recorded are appended in their recorded order.
+    for (uint32_t j = 0; j < functionCount; j++) {
+      uint32_t sourceStart;
+      MOZ_ALWAYS_TRUE(reader.readUint32(&sourceStart));
+      if (p && !p->value().append(sourceStart)) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 bool DelazifyStrategy::add(FrontendContext* fc, ScriptStencilRef& ref) {
   using namespace js::frontend;
 
@@ -85,7 +221,10 @@ bool DelazifyStrategy::add(FrontendContext* fc, ScriptStencilRef& ref) {
   return true;
 }
 
-frontend::ScriptStencilRef LargeFirstDelazification::next() {
+// Pop the root of a heap of (priority, ScriptStencilRef) pairs, which is the
+// entry with the highest priority.
+template <typename Heap>
+static frontend::ScriptStencilRef HeapPop(Heap& heap) {
   const_swap(heap.back(), heap[0]);
   ScriptStencilRef result = heap.popCopy().second;
 
@@ -130,10 +269,11 @@ frontend::ScriptStencilRef LargeFirstDelazification::next() {
   return result;
 }
 
-bool LargeFirstDelazification::insert(frontend::ScriptStencilRef& ref) {
-  const frontend::ScriptStencilExtra& extra = ref.scriptExtra();
-  SourceSize size = extra.extent.sourceEnd - extra.extent.sourceStart;
-  if (!heap.append(std::pair(size, ref))) {
+// Push an entry in a heap of (priority, ScriptStencilRef) pairs.
+template <typename Heap>
+[[nodiscard]] static bool HeapPush(Heap& heap, uint32_t priority,
+                                   frontend::ScriptStencilRef& ref) {
+  if (!heap.append(std::pair(priority, ref))) {
     return false;
   }
 
@@ -153,6 +293,46 @@ bool LargeFirstDelazification::insert(frontend::ScriptStencilRef& ref) {
   return true;
 }
 
+frontend::ScriptStencilRef LargeFirstDelazification::next() {
+  return HeapPop(heap);
+}
+
+bool LargeFirstDelazification::insert(frontend::ScriptStencilRef& ref) {
+  const frontend::ScriptStencilExtra& extra = ref.scriptExtra();
+  SourceSize size = extra.extent.sourceEnd - extra.extent.sourceStart;
+  return HeapPush(heap, size, ref);
+}
+
+bool ProfileGuidedDelazification::init(
+    const DelazificationProfile::FunctionList& functions) {
+  if (!executionOrder.reserve(functions.length())) {
+    return false;
+  }
+  for (uint32_t i = 0; i < functions.length(); i++) {
+    // Functions are unique within a profile.
+    executionOrder.putNewInfallible(functions[i], i);
+  }
+  return true;
+}
+
+frontend::ScriptStencilRef ProfileGuidedDelazification::next() {
+  return HeapPop(heap);
+}
+
+bool ProfileGuidedDelazification::insert(frontend::ScriptStencilRef& ref) {
+  const frontend::ScriptStencilExtra& extra = ref.scriptExtra();
+  auto p = executionOrder.lookup(extra.extent.sourceStart);
+  if (!p) {
+    // This function did not run in the recorded executions.
+    return true;
+  }
+
+  // The heap bubbles up the highest priority, while the first executed
+  // function has the lowest index.
+  Priority priority = UINT32_MAX - p->value();
+  return HeapPush(heap, priority, ref);
+}
+
 bool DelazificationContext::init(
     const JS::ReadOnlyCompileOptions& options,
     frontend::InitialStencilAndDelazifications* stencils) {
@@ -189,6 +369,33 @@ bool DelazificationContext::init(
       // largest function first.
       strategy_ = fc_.getAllocator()->make_unique<LargeFirstDelazification>();
       break;
+    case JS::DelazificationOption::ConcurrentProfileGuided: {
+      // ConcurrentProfileGuided visit the functions executed by previous
+      // executions of the same source, in the order of their first execution.
+      // Without any recorded execution, fallback to ConcurrentDepthFirst.
+      DelazificationProfile::FunctionList functions;
+      ScriptSource* source = stencils->getInitial()->source;
+      HashNumber sourceHash = source->profileSourceHash();
+      if (sourceHash && !DelazificationProfile::lookup(sourceHash, functions)) {
+        ReportOutOfMemory(&fc_);
+        return false;
+      }
+      if (functions.empty()) {
+        strategy_ = fc_.getAllocator()->make_unique<DepthFirstDelazification>();
+        break;
+      }
+      auto profileGuided =
+          fc_.getAllocator()->make_unique<ProfileGuidedDelazification>();
+      if (!profileGuided) {
+        return false;
+      }
+      if (!profileGuided->init(functions)) {
+        ReportOutOfMemory(&fc_);
+        return false;
+      }
+      strategy_ = std::move(profileGuided);
+      break;
+    }
     case JS::DelazificationOption::ParseEverythingEagerly:
       // ParseEverythingEagerly parse all functions eagerly, thus leaving no
       // functions to be parsed on demand.
@@ -274,3 +481,17 @@ size_t DelazificationContext::sizeOfExcludingThis(
   size_t size = stencils_->sizeOfIncludingThis(mallocSizeOf);
   return size;
 }
+
+JS_PUBLIC_API bool js::EncodeDelazificationProfile(
+    JSContext* cx, JS::TranscodeBuffer& buffer) {
+  if (!DelazificationProfile::encode(buffer)) {
+    ReportOutOfMemory(cx);
+    return false;
+  }
+  return true;
+}
+
+JS_PUBLIC_API bool js::DecodeDelazificationProfile(
+    JSContext* cx, const JS::TranscodeRange& range) {
+  return DelazificationProfile::decode(range);
+}
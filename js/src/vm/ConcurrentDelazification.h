@@ -7,10 +7,12 @@
 #ifndef vm_ConcurrentDelazification_h
 #define vm_ConcurrentDelazification_h
 
+#include "mozilla/HashFunctions.h"    // mozilla::HashBytes, mozilla::AddToHash
 #include "mozilla/Maybe.h"            // mozilla::Maybe
 #include "mozilla/MemoryReporting.h"  // mozilla::MallocSizeOf
 
 #include <stddef.h>  // size_t
+#include <stdint.h>  // uint32_t
 #include <utility>   // std::pair
 
 #include "frontend/CompilationStencil.h"  // frontend::{InitialStencilAndDelazifications, CompilationStencil, ScriptStencilRef, CompilationStencilMerger}
@@ -18,13 +20,78 @@
 #include "js/AllocPolicy.h"               // SystemAllocPolicy
 #include "js/CompileOptions.h"  // JS::PrefableCompileOptions, JS::ReadOnlyCompileOptions
 #include "js/experimental/JSStencil.h"  // RefPtrTraits for InitialStencilAndDelazifications
-#include "js/UniquePtr.h"               // UniquePtr
-#include "js/Vector.h"                  // Vector
+#include "js/HashTable.h"               // HashMap, HashSet
+#include "js/Transcoding.h"  // JS::TranscodeBuffer, JS::TranscodeRange
+#include "js/UniquePtr.h"    // UniquePtr
+#include "js/Vector.h"       // Vector
 
 namespace js {
 
 class FrontendContext;
 
+// Process-wide record of the functions executed by the sources compiled with
+// the ConcurrentProfileGuided delazification mode.
+//
+// A source is identified by the hash of its text, see
+// ScriptSource::profileSourceHash, and a function by the offset at which it
+// starts in the source. The functions of each source are kept in the order in
+// which they were first executed, which is the order in which
+// ProfileGuidedDelazification delazifies them for the next compilations of
+// the same source.
+//
+// The profile is filled when lazy functions are delazified on the main thread,
+// and can be carried across processes with js::EncodeDelazificationProfile
+// and js::DecodeDelazificationProfile.
+class DelazificationProfile {
+ public:
+  using FunctionList = Vector<uint32_t, 0, SystemAllocPolicy>;
+
+  static constexpr uint32_t EncodingMagic = 0x5a4c4450;
+  static constexpr uint32_t EncodingVersion = 1;
+
+  // Upper bounds on the number of sources and on the number of functions
+  // recorded for a single source. Once the profile holds MaxSources sources,
+  // new sources are neither recorded nor merged.
+  static constexpr uint32_t MaxSources = 1024;
+  static constexpr uint32_t MaxFunctionsPerSource = 1 << 16;
+
+  template <typename Unit>
+  static HashNumber hashSource(const Unit* units, size_t length) {
+    HashNumber hash = mozilla::HashBytes(units, length * sizeof(Unit));
+    hash = mozilla::AddToHash(hash, length);
+    // Zero is used by ScriptSource for sources without profile.
+    return hash ? hash : 1;
+  }
+
+  // Record the first execution of the function starting at |sourceStart|.
+  // Recording is best effort, and silently stops on OOM.
+  static void recordExecution(HashNumber sourceHash, uint32_t sourceStart);
+
+  // Fill |functions| with the functions recorded for the source, in the order
+  // of their first execution. Returns false on OOM.
+  [[nodiscard]] static bool lookup(HashNumber sourceHash,
+                                   FunctionList& functions);
+
+  [[nodiscard]] static bool encode(JS::TranscodeBuffer& buffer);
+
+  // Merge an encoded profile. Functions already recorded by this process are
+  // kept first. Returns false on OOM, or if the buffer is malformed in which
+  // case the profile is left unchanged.
+  [[nodiscard]] static bool decode(const JS::TranscodeRange& range);
+
+ private:
+  struct SourceProfile {
+    FunctionList order;
+    HashSet<uint32_t, DefaultHasher<uint32_t>, SystemAllocPolicy> recorded;
+
+    [[nodiscard]] bool append(uint32_t sourceStart);
+  };
+  using SourceMap = HashMap<HashNumber, SourceProfile,
+                            DefaultHasher<HashNumber>, SystemAllocPolicy>;
+
+  SourceMap sources_;
+};
+
 // Base class for implementing the various strategies to iterate over the
 // functions to be delazified, or to decide when to stop doing any
 // delazification.
@@ -103,6 +170,31 @@ struct LargeFirstDelazification final : public DelazifyStrategy {
   bool insert(frontend::ScriptStencilRef&) override;
 };
 
+// Delazify the functions recorded in the DelazificationProfile of the source,
+// in the order in which they were first executed. Functions which are not part
+// of the profile are skipped, as they are not expected to run.
+//
+// A function can only be executed after its enclosing function, thus enclosing
+// functions always precede their inner functions in the profile, and are
+// delazified first, which exposes the inner functions to `insert`.
+struct ProfileGuidedDelazification final : public DelazifyStrategy {
+  // Position of each function in the first-execution order, keyed by the
+  // offset at which the function starts in the source.
+  HashMap<uint32_t, uint32_t, DefaultHasher<uint32_t>, SystemAllocPolicy>
+      executionOrder;
+
+  // Heap of functions to be delazified, prioritizing the earliest executed.
+  using Priority = uint32_t;
+  Vector<std::pair<Priority, ScriptStencilRef>, 0, SystemAllocPolicy> heap;
+
+  [[nodiscard]] bool init(const DelazificationProfile::FunctionList& functions);
+
+  bool done() const override { return heap.empty(); }
+  ScriptStencilRef next() override;
+  void clear() override { return heap.clear(); }
+  bool insert(frontend::ScriptStencilRef&) override;
+};
+
 class DelazificationContext {
   const JS::PrefableCompileOptions initialPrefableOptions_;
   using Stencils = frontend::InitialStencilAndDelazifications;
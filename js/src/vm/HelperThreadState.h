@@ -27,6 +27,8 @@
 
 #include "ds/Fifo.h"                      // Fifo
 #include "frontend/CompilationStencil.h"  // frontend::InitialStencilAndDelazifications
+#include "frontend/FrontendContext.h"     // FrontendContext
+#include "frontend/StencilXdr.h"          // frontend::XDRSharedDataEntrySpan
 #include "gc/GCRuntime.h"                 // gc::GCRuntime
 #include "js/AllocPolicy.h"               // SystemAllocPolicy
 #include "js/CompileOptions.h"            // JS::ReadOnlyCompileOptions
@@ -56,6 +58,8 @@ struct DelazifyTask;
 struct FreeDelazifyTask;
 struct PromiseHelperTask;
 class PromiseObject;
+struct StencilDecodeTask;
+struct ArrayBufferCopyTask;
 
 namespace jit {
 class BaselineCompileTask;
@@ -128,6 +132,10 @@ class GlobalHelperThreadState {
       Vector<UniquePtr<SourceCompressionTask>, 0, SystemAllocPolicy>;
   using PromiseHelperTaskVector =
       Vector<PromiseHelperTask*, 0, SystemAllocPolicy>;
+  using StencilDecodeTaskVector =
+      Vector<StencilDecodeTask*, 0, SystemAllocPolicy>;
+  using ArrayBufferCopyTaskVector =
+      Vector<ArrayBufferCopyTask*, 0, SystemAllocPolicy>;
 
   // Count of running task by each threadType.
   mozilla::EnumeratedArray<ThreadType, size_t,
@@ -179,6 +187,13 @@ class GlobalHelperThreadState {
   // risk.
   FreeDelazifyTaskVector freeDelazifyTaskVector_;
 
+  // Chunks of a stencil being decoded by a thread which is waiting for them.
+  StencilDecodeTaskVector stencilDecodeWorklist_;
+
+  // Parts of the contents of large ArrayBuffers being read from structured
+  // clone data.
+  ArrayBufferCopyTaskVector arrayBufferCopyWorklist_;
+
   // Source compression worklist of tasks that we do not yet know can start.
   SourceCompressionTaskVector compressionPendingList_;
 
@@ -230,6 +245,8 @@ class GlobalHelperThreadState {
   size_t maxWasmPartialTier2CompileThreads() const;
   size_t maxPromiseHelperThreads() const;
   size_t maxDelazifyThreads() const;
+  size_t maxStencilDecodeThreads() const;
+  size_t maxArrayBufferCopyThreads() const;
   size_t maxCompressionThreads() const;
   size_t maxGCParallelThreads() const;
 
@@ -352,6 +369,16 @@ class GlobalHelperThreadState {
     return freeDelazifyTaskVector_;
   }
 
+  StencilDecodeTaskVector& stencilDecodeWorklist(
+      const AutoLockHelperThreadState&) {
+    return stencilDecodeWorklist_;
+  }
+
+  ArrayBufferCopyTaskVector& arrayBufferCopyWorklist(
+      const AutoLockHelperThreadState&) {
+    return arrayBufferCopyWorklist_;
+  }
+
   SourceCompressionTaskVector& compressionPendingList(
       const AutoLockHelperThreadState&) {
     return compressionPendingList_;
@@ -389,6 +416,8 @@ class GlobalHelperThreadState {
   bool canStartIonFreeTask(const AutoLockHelperThreadState& lock);
   bool canStartFreeDelazifyTask(const AutoLockHelperThreadState& lock);
   bool canStartDelazifyTask(const AutoLockHelperThreadState& lock);
+  bool canStartStencilDecodeTask(const AutoLockHelperThreadState& lock);
+  bool canStartArrayBufferCopyTask(const AutoLockHelperThreadState& lock);
   bool canStartCompressionTask(const AutoLockHelperThreadState& lock);
   bool canStartGCParallelTask(const AutoLockHelperThreadState& lock);
 
@@ -415,6 +444,10 @@ class GlobalHelperThreadState {
   HelperThreadTask* maybeGetFreeDelazifyTask(
       const AutoLockHelperThreadState& lock);
   HelperThreadTask* maybeGetDelazifyTask(const AutoLockHelperThreadState& lock);
+  HelperThreadTask* maybeGetStencilDecodeTask(
+      const AutoLockHelperThreadState& lock);
+  HelperThreadTask* maybeGetArrayBufferCopyTask(
+      const AutoLockHelperThreadState& lock);
   HelperThreadTask* maybeGetCompressionTask(
       const AutoLockHelperThreadState& lock);
   HelperThreadTask* maybeGetGCParallelTask(
@@ -470,6 +503,13 @@ class GlobalHelperThreadState {
   void cancelOffThreadCompressions(JSRuntime* runtime,
                                    AutoLockHelperThreadState& lock);
 
+  // Remove |task| from the worklist if no helper thread picked it up yet, in
+  // which case the caller is responsible for running it.
+  bool removePendingStencilDecodeTask(StencilDecodeTask* task,
+                                      const AutoLockHelperThreadState& lock);
+  bool removePendingArrayBufferCopyTask(ArrayBufferCopyTask* task,
+                                        const AutoLockHelperThreadState& lock);
+
   void triggerFreeUnusedMemory();
 
   bool submitTask(wasm::UniqueCompleteTier2GeneratorTask task);
@@ -487,6 +527,10 @@ class GlobalHelperThreadState {
   bool submitTask(UniquePtr<FreeDelazifyTask> task,
                   const AutoLockHelperThreadState& locked);
   bool submitTask(PromiseHelperTask* task);
+  bool submitTask(StencilDecodeTask* task,
+                  const AutoLockHelperThreadState& locked);
+  bool submitTask(ArrayBufferCopyTask* task,
+                  const AutoLockHelperThreadState& locked);
   bool submitTask(GCParallelTask* task,
                   const AutoLockHelperThreadState& locked);
 
@@ -586,6 +630,62 @@ struct FreeDelazifyTask : public HelperThreadTask {
   const char* getName() override { return "FreeDelazifyTask"; }
 };
 
+// Decode a chunk of the SharedImmutableScriptData of a large stencil, while
+// the thread decoding the rest of the stencil waits for it.
+//
+// The task is owned by the decoding thread, which removes it from the worklist
+// and runs it itself if no helper thread has started it yet. It only waits for
+// |done| on tasks which are already running.
+struct StencilDecodeTask : public HelperThreadTask {
+  frontend::XDRSharedDataEntrySpan entries;
+  FrontendContext fc_;
+  JS::TranscodeResult result = JS::TranscodeResult::Ok;
+
+  // Set under the helper thread lock once the entries are decoded.
+  bool done = false;
+
+  explicit StencilDecodeTask(frontend::XDRSharedDataEntrySpan entries)
+      : entries(entries) {}
+
+  void runTask();
+  void runHelperThreadTask(AutoLockHelperThreadState& locked) override;
+  ThreadType threadType() override {
+    return ThreadType::THREAD_TYPE_STENCIL_DECODE;
+  }
+
+  const char* getName() override { return "StencilDecodeTask"; }
+};
+
+// Copy part of the contents of a large ArrayBuffer out of structured clone
+// data, while the thread reading the clone carries on with the rest of it.
+//
+// The task is owned by the reading thread, which removes it from the worklist
+// and runs it itself if no helper thread has started it yet. It only waits for
+// |done| on tasks which are already running.
+struct ArrayBufferCopyTask : public HelperThreadTask {
+  struct Range {
+    uint8_t* dest;
+    const char* src;
+    size_t length;
+  };
+  Vector<Range, 1, SystemAllocPolicy> ranges;
+
+  // Set under the helper thread lock once the ranges are copied.
+  bool done = false;
+
+  [[nodiscard]] bool addRange(uint8_t* dest, const char* src, size_t length) {
+    return ranges.append(Range{dest, src, length});
+  }
+
+  void runTask();
+  void runHelperThreadTask(AutoLockHelperThreadState& locked) override;
+  ThreadType threadType() override {
+    return ThreadType::THREAD_TYPE_ARRAY_BUFFER_COPY;
+  }
+
+  const char* getName() override { return "ArrayBufferCopyTask"; }
+};
+
 // It is not desirable to eagerly compress: if lazy functions that are tied to
 // the ScriptSource were to be executed relatively soon after parsing, they
 // would need to block on decompression, which hurts responsiveness.
@@ -19,6 +19,8 @@ struct DelazifyTask;
 struct FreeDelazifyTask;
 class GlobalHelperThreadState;
 class SourceCompressionTask;
+struct StencilDecodeTask;
+struct ArrayBufferCopyTask;
 
 namespace jit {
 class BaselineCompileTask;
@@ -64,6 +66,16 @@ struct MapTypeToThreadType<FreeDelazifyTask> {
   static const ThreadType threadType = THREAD_TYPE_DELAZIFY_FREE;
 };
 
+template <>
+struct MapTypeToThreadType<StencilDecodeTask> {
+  static const ThreadType threadType = THREAD_TYPE_STENCIL_DECODE;
+};
+
+template <>
+struct MapTypeToThreadType<ArrayBufferCopyTask> {
+  static const ThreadType threadType = THREAD_TYPE_ARRAY_BUFFER_COPY;
+};
+
 template <>
 struct MapTypeToThreadType<SourceCompressionTask> {
   static const ThreadType threadType = THREAD_TYPE_COMPRESS;
@@ -475,6 +475,20 @@ size_t GlobalHelperThreadState::maxDelazifyThreads() const {
   return std::min(cpuCount, threadCount);
 }
 
+size_t GlobalHelperThreadState::maxStencilDecodeThreads() const {
+  if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_STENCIL_DECODE)) {
+    return 1;
+  }
+  return std::min(cpuCount, threadCount);
+}
+
+size_t GlobalHelperThreadState::maxArrayBufferCopyThreads() const {
+  if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_ARRAY_BUFFER_COPY)) {
+    return 1;
+  }
+  return std::min(cpuCount, threadCount);
+}
+
 size_t GlobalHelperThreadState::maxCompressionThreads() const {
   if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_COMPRESS)) {
     return 1;
@@ -580,6 +594,8 @@ const GlobalHelperThreadState::Selector GlobalHelperThreadState::selectors[] = {
     &GlobalHelperThreadState::maybeGetIonCompileTask,
     &GlobalHelperThreadState::maybeGetWasmTier1CompileTask,
     &GlobalHelperThreadState::maybeGetPromiseHelperTask,
+    &GlobalHelperThreadState::maybeGetStencilDecodeTask,
+    &GlobalHelperThreadState::maybeGetArrayBufferCopyTask,
     &GlobalHelperThreadState::maybeGetFreeDelazifyTask,
     &GlobalHelperThreadState::maybeGetDelazifyTask,
     &GlobalHelperThreadState::maybeGetCompressionTask,
@@ -593,7 +609,8 @@ bool GlobalHelperThreadState::canStartTasks(
     const AutoLockHelperThreadState& lock) {
   return canStartGCParallelTask(lock) || canStartBaselineCompileTask(lock) ||
          canStartIonCompileTask(lock) || canStartWasmTier1CompileTask(lock) ||
-         canStartPromiseHelperTask(lock) || canStartFreeDelazifyTask(lock) ||
+         canStartPromiseHelperTask(lock) || canStartStencilDecodeTask(lock) ||
+         canStartArrayBufferCopyTask(lock) || canStartFreeDelazifyTask(lock) ||
          canStartDelazifyTask(lock) || canStartCompressionTask(lock) ||
          canStartIonFreeTask(lock) || canStartWasmTier2CompileTask(lock) ||
          canStartWasmCompleteTier2GeneratorTask(lock) ||
@@ -1505,6 +1522,118 @@ void FreeDelazifyTask::runHelperThreadTask(AutoLockHelperThreadState& locked) {
   js_delete(this);
 }
 
+//== StencilDecodeTask ====================================================
+
+bool GlobalHelperThreadState::canStartStencilDecodeTask(
+    const AutoLockHelperThreadState& lock) {
+  return !stencilDecodeWorklist(lock).empty() &&
+         checkTaskThreadLimit(THREAD_TYPE_STENCIL_DECODE,
+                              maxStencilDecodeThreads(), lock);
+}
+
+HelperThreadTask* GlobalHelperThreadState::maybeGetStencilDecodeTask(
+    const AutoLockHelperThreadState& lock) {
+  auto& worklist = stencilDecodeWorklist(lock);
+  if (worklist.empty()) {
+    return nullptr;
+  }
+  return worklist.popCopy();
+}
+
+bool GlobalHelperThreadState::submitTask(
+    StencilDecodeTask* task, const AutoLockHelperThreadState& locked) {
+  if (!stencilDecodeWorklist(locked).append(task)) {
+    return false;
+  }
+  dispatch(locked);
+  return true;
+}
+
+bool GlobalHelperThreadState::removePendingStencilDecodeTask(
+    StencilDecodeTask* task, const AutoLockHelperThreadState& lock) {
+  auto& worklist = stencilDecodeWorklist(lock);
+  for (size_t i = 0; i < worklist.length(); i++) {
+    if (worklist[i] == task) {
+      worklist.erase(&worklist[i]);
+      return true;
+    }
+  }
+  return false;
+}
+
+void StencilDecodeTask::runTask() {
+  result = frontend::StencilXDR::decodeSharedDataEntries(&fc_, entries);
+}
+
+void StencilDecodeTask::runHelperThreadTask(
+    AutoLockHelperThreadState& locked) {
+  {
+    AutoUnlockHelperThreadState unlock(locked);
+    runTask();
+  }
+
+  // The owner is waiting on the helper thread lock, and is woken up by the
+  // notification which follows the completion of any task.
+  done = true;
+}
+
+//== ArrayBufferCopyTask ==================================================
+
+bool GlobalHelperThreadState::canStartArrayBufferCopyTask(
+    const AutoLockHelperThreadState& lock) {
+  return !arrayBufferCopyWorklist(lock).empty() &&
+         checkTaskThreadLimit(THREAD_TYPE_ARRAY_BUFFER_COPY,
+                              maxArrayBufferCopyThreads(), lock);
+}
+
+HelperThreadTask* GlobalHelperThreadState::maybeGetArrayBufferCopyTask(
+    const AutoLockHelperThreadState& lock) {
+  auto& worklist = arrayBufferCopyWorklist(lock);
+  if (worklist.empty()) {
+    return nullptr;
+  }
+  return worklist.popCopy();
+}
+
+bool GlobalHelperThreadState::submitTask(
+    ArrayBufferCopyTask* task, const AutoLockHelperThreadState& locked) {
+  if (!arrayBufferCopyWorklist(locked).append(task)) {
+    return false;
+  }
+  dispatch(locked);
+  return true;
+}
+
+bool GlobalHelperThreadState::removePendingArrayBufferCopyTask(
+    ArrayBufferCopyTask* task, const AutoLockHelperThreadState& lock) {
+  auto& worklist = arrayBufferCopyWorklist(lock);
+  for (size_t i = 0; i < worklist.length(); i++) {
+    if (worklist[i] == task) {
+      worklist.erase(&worklist[i]);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ArrayBufferCopyTask::runTask() {
+  for (const Range& range : ranges) {
+    memcpy(range.dest, range.src, range.length);
+  }
+}
+
+void ArrayBufferCopyTask::runHelperThreadTask(
+    AutoLockHelperThreadState& locked) {
+  {
+    AutoUnlockHelperThreadState unlock(locked);
+    runTask();
+  }
+
+  // The owner is waiting on the helper thread lock, and is woken up by the
+  // notification which follows the completion of any task.
+  done = true;
+}
+
 //== PromiseHelperTask ====================================================
 
 bool GlobalHelperThreadState::canStartPromiseHelperTask(
@@ -18,6 +18,7 @@
 
 #include "builtin/AtomicsObject.h"
 #include "builtin/TestingFunctions.h"
+#include "ds/LifoAlloc.h"
 #include "gc/Statistics.h"
 #include "jit/Assembler.h"
 #include "jit/Ion.h"
@@ -159,6 +160,8 @@ JS_PUBLIC_API const char* JS::detail::InitWithFailureDiagnostic(
 
   RETURN_IF_FAIL(js::Mutex::Init());
 
+  RETURN_IF_FAIL(js::InitLifoChunkCache());
+
   js::gc::InitMemorySubsystem();  // Ensure gc::SystemPageSize() works.
 
   RETURN_IF_FAIL(js::wasm::Init());
@@ -289,6 +292,8 @@ static void ShutdownImpl(JS::detail::FrontendOnly frontendOnly) {
 
   MOZ_ASSERT_IF(!JSRuntime::hasLiveRuntimes(), !js::WasmReservedBytes());
 
+  js::ShutDownLifoChunkCache();
+
   js::ShutDownMallocAllocator();
 
   if (!JSRuntime::hasLiveRuntimes()) {
@@ -6,25 +6,29 @@
 
 #include "vm/JSONParser.h"
 
-#include "mozilla/Assertions.h"  // MOZ_ASSERT
-#include "mozilla/Attributes.h"  // MOZ_STACK_CLASS
-#include "mozilla/Range.h"       // mozilla::Range
-#include "mozilla/RangedPtr.h"   // mozilla::RangedPtr
+#include "mozilla/Assertions.h"     // MOZ_ASSERT
+#include "mozilla/Attributes.h"     // MOZ_STACK_CLASS
+#include "mozilla/HashFunctions.h"  // mozilla::{AddToHash,HashGeneric}
+#include "mozilla/Range.h"          // mozilla::Range
+#include "mozilla/RangedPtr.h"      // mozilla::RangedPtr
+#include "mozilla/SIMD.h"           // mozilla::SIMD
 
 #include "mozilla/Sprintf.h"    // SprintfLiteral
 #include "mozilla/TextUtils.h"  // mozilla::AsciiAlphanumericToNumber, mozilla::IsAsciiDigit, mozilla::IsAsciiHexDigit
 
-#include <stddef.h>  // size_t
-#include <stdint.h>  // uint32_t
-#include <utility>   // std::move
+#include <algorithm>  // std::copy, std::max
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint32_t
+#include <utility>    // std::move
 
 #include "jsnum.h"  // ParseDecimalNumber, GetFullInteger, FullStringToDouble
 
 #include "builtin/Array.h"              // NewDenseCopiedArray
 #include "builtin/ParseRecordObject.h"  // js::ParseRecordObject
 #include "ds/IdValuePair.h"             // IdValuePair
+#include "gc/Cell.h"                    // gc::PreWriteBarrier
 #include "gc/GCEnum.h"                  // CanGC
-#include "gc/Tracer.h"                  // JS::TraceRoot
+#include "gc/Tracer.h"                  // JS::TraceRoot, TraceManuallyBarrieredEdge
 #include "js/AllocPolicy.h"             // ReportOutOfMemory
 #include "js/CharacterEncoding.h"       // JS::ConstUTF8CharsZ
 #include "js/ColumnNumber.h"            // JS::ColumnNumberOneOrigin
@@ -48,7 +52,9 @@
 #include "vm/Realm.h"  // JS::Realm
 #include "vm/StringType.h"  // JSString, JSAtom, JSLinearString, NewStringCopyN, NameToId
 
+#include "gc/StoreBuffer-inl.h"  // StoreBuffer::putWholeCell
 #include "vm/JSAtomUtils-inl.h"  // AtomToId
+#include "vm/JSObject-inl.h"     // NewTenuredObjectWithGivenProto
 
 using namespace js;
 
@@ -56,6 +62,7 @@ using mozilla::AsciiAlphanumericToNumber;
 using mozilla::IsAsciiDigit;
 using mozilla::IsAsciiHexDigit;
 using mozilla::RangedPtr;
+using mozilla::SIMD;
 
 template <typename CharT, typename ParserT>
 void JSONTokenizer<CharT, ParserT>::getTextPosition(uint32_t* column,
@@ -349,6 +356,26 @@ JSONToken JSONTokenizer<CharT, ParserT>::numberToken(double d) {
   return JSONToken::Number;
 }
 
+// Return a pointer to the first character of [cur, end) which cannot be
+// copied verbatim out of a string literal, i.e. the closing quote, a backslash
+// or a control character, or |end| if there is none.
+//
+// String literals make up most of the bytes of typical JSON payloads, thus
+// they are scanned in blocks of 16 or 32 bytes when SIMD is available.
+static inline const Latin1Char* FindStringLiteralSpecial(
+    const Latin1Char* cur, const Latin1Char* end) {
+  const char* result = SIMD::memchr2OrBelow8(
+      reinterpret_cast<const char*>(cur), '"', '\\', 0x20, end - cur);
+  return result ? reinterpret_cast<const Latin1Char*>(result) : end;
+}
+
+static inline const char16_t* FindStringLiteralSpecial(const char16_t* cur,
+                                                       const char16_t* end) {
+  const char16_t* result =
+      SIMD::memchr2OrBelow16(cur, u'"', u'\\', 0x20, end - cur);
+  return result ? result : end;
+}
+
 template <typename CharT, typename ParserT>
 template <JSONStringType ST>
 JSONToken JSONTokenizer<CharT, ParserT>::readString() {
@@ -370,18 +397,16 @@ JSONToken JSONTokenizer<CharT, ParserT>::readString() {
    * string directly from the source text.
    */
   CharPtr start = current;
-  for (; current < end; current++) {
+  current += FindStringLiteralSpecial(current.get(), end.get()) - current.get();
+  if (current < end) {
     if (*current == '"') {
       size_t length = current - start;
       current++;
       return stringToken<ST>(start, length);
     }
 
-    if (*current == '\\') {
-      break;
-    }
-
-    if (*current <= 0x001F) {
+    if (*current != '\\') {
+      MOZ_ASSERT(*current <= 0x001F);
       error("bad control character in string literal");
       return token(JSONToken::Error);
     }
@@ -481,11 +506,8 @@ JSONToken JSONTokenizer<CharT, ParserT>::readString() {
     }
 
     start = current;
-    for (; current < end; current++) {
-      if (*current == '"' || *current == '\\' || *current <= 0x001F) {
-        break;
-      }
-    }
+    current +=
+        FindStringLiteralSpecial(current.get(), end.get()) - current.get();
   } while (current < end);
 
   error("unterminated string");
@@ -618,6 +640,42 @@ static void ReportJSONSyntaxError(FrontendContext* fc, ErrorMetadata&& metadata,
 // big the resulting data structure will be but after two nursery
 // collections then at least half of it will end up tenured.
 
+/* static */
+HashNumber JSONObjectShapeCache::hashKeys(
+    JS::Handle<IdValueVector> properties) {
+  HashNumber hash = mozilla::HashGeneric(properties.length());
+  for (const IdValuePair& prop : properties) {
+    hash = mozilla::AddToHash(hash, prop.id.asRawBits());
+  }
+  return hash;
+}
+
+SharedShape* JSONObjectShapeCache::lookup(
+    JS::Handle<IdValueVector> properties) const {
+  if (shapes_.empty()) {
+    return nullptr;
+  }
+  auto p = shapes_.lookup(hashKeys(properties));
+  if (!p || !PlainObjectShapeMatches(properties, p->value())) {
+    return nullptr;
+  }
+  return p->value();
+}
+
+void JSONObjectShapeCache::add(JS::Handle<IdValueVector> properties,
+                               SharedShape* shape) {
+  if (shapes_.count() >= MaxEntries) {
+    return;
+  }
+  (void)shapes_.put(hashKeys(properties), shape);
+}
+
+void JSONObjectShapeCache::trace(JSTracer* trc) {
+  for (auto iter = shapes_.modIter(); !iter.done(); iter.next()) {
+    TraceRoot(trc, &iter.get().value(), "JSONObjectShapeCache shape");
+  }
+}
+
 JSONFullParseHandlerAnyChar::JSONFullParseHandlerAnyChar(JSContext* cx)
     : cx(cx), gcHeap(cx, 1), freeElements(cx), freeProperties(cx) {}
 
@@ -628,7 +686,8 @@ JSONFullParseHandlerAnyChar::JSONFullParseHandlerAnyChar(
       parseType(other.parseType),
       gcHeap(cx, 1),
       freeElements(std::move(other.freeElements)),
-      freeProperties(std::move(other.freeProperties)) {}
+      freeProperties(std::move(other.freeProperties)),
+      shapeCache(std::move(other.shapeCache)) {}
 
 JSONFullParseHandlerAnyChar::~JSONFullParseHandlerAnyChar() {
   for (size_t i = 0; i < freeElements.length(); i++) {
@@ -701,10 +760,26 @@ inline bool JSONFullParseHandlerAnyChar::finishObject(
     newKind = TenuredObject;
   }
   // properties is traced in the parser; see JSONParser<CharT>::trace()
-  JSObject* obj = NewPlainObjectWithMaybeDuplicateKeys(
-      cx, Handle<IdValueVector>::fromMarkedLocation(properties), newKind);
-  if (!obj) {
-    return false;
+  Handle<IdValueVector> props =
+      Handle<IdValueVector>::fromMarkedLocation(properties);
+
+  // Objects with the same keys as a previous object of this parse get its
+  // shape directly.
+  PlainObject* obj;
+  if (SharedShape* cached = shapeCache.lookup(props)) {
+    Rooted<SharedShape*> shape(cx, cached);
+    obj = NewPlainObjectWithShapeAndValues(cx, shape, props, newKind);
+    if (!obj) {
+      return false;
+    }
+  } else {
+    obj = NewPlainObjectWithMaybeDuplicateKeys(cx, props, newKind);
+    if (!obj) {
+      return false;
+    }
+    if (SharedShape* shape = ReusablePlainObjectShape(obj, props)) {
+      shapeCache.add(props, shape);
+    }
   }
 
   vp.setObject(*obj);
@@ -774,6 +849,7 @@ inline void JSONFullParseHandlerAnyChar::freeStackEntry(StackEntry& entry) {
 
 void JSONFullParseHandlerAnyChar::trace(JSTracer* trc) {
   JS::TraceRoot(trc, &v, "JSONFullParseHandlerAnyChar current value");
+  shapeCache.trace(trc);
 }
 
 template <typename CharT>
@@ -1607,3 +1683,654 @@ JS_PUBLIC_API bool JS::ParseJSONWithHandler(const char16_t* chars, uint32_t len,
                                             JS::JSONParseHandler* handler) {
   return ParseJSONWithHandlerImpl(chars, len, handler);
 }
+
+namespace {
+
+// The next token expected by an incremental parse. These are the points at
+// which JSONPerHandlerParser::parseImpl can be interrupted by the end of a
+// chunk.
+enum class JSONStreamState : uint8_t {
+  // Any value.
+  Value,
+
+  // Any value or ']', right after '['.
+  ValueOrArrayClose,
+
+  // ',' or ']' after an array element.
+  AfterArrayElement,
+
+  // A property name or '}', right after '{'.
+  PropertyNameOrObjectClose,
+
+  // A property name after ','.
+  PropertyName,
+
+  // ':' after a property name.
+  Colon,
+
+  // ',' or '}' after a property value.
+  AfterProperty,
+
+  // The top-level value has been parsed.
+  Done,
+
+  // A previous chunk failed to parse.
+  Failed
+};
+
+// How far a token cut off by the end of a chunk has been scanned for its end,
+// so that the next chunk resumes the scan instead of starting over.
+struct JSONTokenScan {
+  // Number of characters from the start of the token known not to end it.
+  size_t offset = 0;
+
+  // Whether the last of these characters is a backslash starting an escape
+  // sequence in a string literal.
+  bool inEscape = false;
+};
+
+// Parse state kept alive between the chunks of an incremental parse, owned by
+// a JSONStreamParserObject.
+class JSONStreamParserData {
+ public:
+  using StackEntry = JSONFullParseHandlerAnyChar::StackEntry;
+
+  // All in progress arrays and objects, as in JSONPerHandlerParser.
+  Vector<StackEntry, 10> stack;
+
+  JS::Value result = JS::UndefinedValue();
+
+  JSONStreamState state = JSONStreamState::Value;
+
+  // The last consumed character, followed by the start of a token which was
+  // cut off by the end of the previous chunk. The tokenizer asserts on the
+  // character preceding the current token, so it is kept across chunks. The
+  // initial space stands for the start of the input.
+  Vector<char16_t, 32, SystemAllocPolicy> carry;
+
+  // Scan state of the token at the start of |carry|.
+  JSONTokenScan tokenScan;
+
+  // Position of the second character of |carry| in the whole input, for error
+  // messages.
+  uint32_t line = 1;
+  uint32_t column = 1;
+
+  // Whether the consumed input ends with \r, such that a \n at the start of
+  // the next chunk is part of the same newline.
+  bool afterCR = false;
+
+  explicit JSONStreamParserData(JSContext* cx) : stack(cx) {
+    MOZ_ALWAYS_TRUE(carry.append(' '));
+  }
+
+  ~JSONStreamParserData() {
+    for (StackEntry& entry : stack) {
+      if (entry.state == JSONParserState::FinishArrayElement) {
+        js_delete(&entry.elements());
+      } else {
+        js_delete(&entry.properties());
+      }
+    }
+  }
+
+  void advancePosition(const char16_t* ptr, const char16_t* end) {
+    for (; ptr < end; ptr++) {
+      // \r\n is treated as a single newline.
+      if (*ptr == '\n' && afterCR) {
+        afterCR = false;
+        continue;
+      }
+      afterCR = *ptr == '\r';
+      if (*ptr == '\n' || *ptr == '\r') {
+        line++;
+        column = 1;
+      } else {
+        column++;
+      }
+    }
+  }
+
+  void trace(JSTracer* trc) {
+    for (StackEntry& entry : stack) {
+      if (entry.state == JSONParserState::FinishArrayElement) {
+        for (JS::Value& elem : entry.elements()) {
+          TraceManuallyBarrieredEdge(trc, &elem, "JSON stream parser element");
+        }
+      } else {
+        for (IdValuePair& prop : entry.properties()) {
+          TraceManuallyBarrieredEdge(trc, &prop.id,
+                                     "JSON stream parser property key");
+          TraceManuallyBarrieredEdge(trc, &prop.value,
+                                     "JSON stream parser property value");
+        }
+      }
+    }
+    TraceManuallyBarrieredEdge(trc, &result, "JSON stream parser result");
+  }
+};
+
+class JSONStreamParserObject : public NativeObject {
+  static constexpr size_t DataSlot = 0;
+
+  static const JSClassOps classOps_;
+
+  static void finalize(JS::GCContext* gcx, JSObject* obj);
+  static void trace(JSTracer* trc, JSObject* obj);
+
+ public:
+  static const JSClass class_;
+
+  static JSONStreamParserObject* create(JSContext* cx);
+
+  JSONStreamParserData* data() const {
+    return maybePtrFromReservedSlot<JSONStreamParserData>(DataSlot);
+  }
+};
+
+const JSClassOps JSONStreamParserObject::classOps_ = {
+    nullptr,   // addProperty
+    nullptr,   // delProperty
+    nullptr,   // enumerate
+    nullptr,   // newEnumerate
+    nullptr,   // resolve
+    nullptr,   // mayResolve
+    finalize,  // finalize
+    nullptr,   // call
+    nullptr,   // construct
+    trace,     // trace
+};
+
+const JSClass JSONStreamParserObject::class_ = {
+    "JSONStreamParser",
+    JSCLASS_HAS_RESERVED_SLOTS(1) | JSCLASS_FOREGROUND_FINALIZE,
+    &classOps_,
+};
+
+/* static */
+JSONStreamParserObject* JSONStreamParserObject::create(JSContext* cx) {
+  // Objects with a finalizer are always tenured, which the post barrier in
+  // ParseJSONStreamChunk relies on.
+  NativeObject* obj = NewTenuredObjectWithGivenProto(cx, &class_, nullptr);
+  if (!obj) {
+    return nullptr;
+  }
+
+  JSONStreamParserData* data = cx->new_<JSONStreamParserData>(cx);
+  if (!data) {
+    return nullptr;
+  }
+  obj->initReservedSlot(DataSlot, JS::PrivateValue(data));
+  return &obj->as<JSONStreamParserObject>();
+}
+
+/* static */
+void JSONStreamParserObject::finalize(JS::GCContext* gcx, JSObject* obj) {
+  js_delete(obj->as<JSONStreamParserObject>().data());
+}
+
+/* static */
+void JSONStreamParserObject::trace(JSTracer* trc, JSObject* obj) {
+  if (JSONStreamParserData* data = obj->as<JSONStreamParserObject>().data()) {
+    data->trace(trc);
+  }
+}
+
+// Whether the string literal starting at |start| ends before |end|. The scan
+// resumes from |scan|, which is updated if the literal is incomplete.
+static bool IsCompleteStringLiteral(const char16_t* start, const char16_t* end,
+                                    JSONTokenScan* scan) {
+  MOZ_ASSERT(*start == '"');
+  const char16_t* ptr = start + std::max(scan->offset, size_t(1));
+  if (scan->inEscape) {
+    if (ptr == end) {
+      return false;
+    }
+    ptr++;
+    scan->inEscape = false;
+  }
+
+  while (true) {
+    ptr = FindStringLiteralSpecial(ptr, end);
+    if (ptr == end) {
+      scan->offset = ptr - start;
+      return false;
+    }
+    if (*ptr != '\\') {
+      // The closing quote, or a control character which is a syntax error.
+      return true;
+    }
+    ptr++;
+    if (ptr == end) {
+      scan->offset = ptr - start;
+      scan->inEscape = true;
+      return false;
+    }
+    ptr++;
+  }
+}
+
+// Whether the value token starting at |start| ends before |end|. Malformed
+// tokens are reported complete, for the tokenizer to report the error. The
+// scan resumes from |scan|, which is updated if the token is incomplete.
+static bool IsCompleteValueToken(const char16_t* start, const char16_t* end,
+                                 JSONTokenScan* scan) {
+  switch (*start) {
+    case '"':
+      return IsCompleteStringLiteral(start, end, scan);
+    case 't':
+    case 'n':
+      return end - start >= 4;
+    case 'f':
+      return end - start >= 5;
+    default:
+      break;
+  }
+
+  if (*start != '-' && !IsAsciiDigit(*start)) {
+    return true;
+  }
+
+  // A number is only known to have ended once a character which can't be part
+  // of it has been seen.
+  const char16_t* ptr = start + std::max(scan->offset, size_t(1));
+  for (; ptr < end; ptr++) {
+    if (!IsAsciiDigit(*ptr) && *ptr != '.' && *ptr != 'e' && *ptr != 'E' &&
+        *ptr != '+' && *ptr != '-') {
+      return true;
+    }
+  }
+  scan->offset = ptr - start;
+  return false;
+}
+
+// Parser for the part of the input currently held in JSONStreamParserData's
+// carry buffer, which resumes from and leaves its state in the
+// JSONStreamParserData.
+class MOZ_STACK_CLASS JSONStreamChunkParser {
+  using CharPtr = RangedPtr<const char16_t>;
+  using Tokenizer = JSONTokenizer<char16_t, JSONStreamChunkParser>;
+  using HandlerT = JSONFullParseHandler<char16_t>;
+
+ public:
+  using JSONStringBuilder = HandlerT::JSONStringBuilder;
+
+  HandlerT handler;
+  Tokenizer tokenizer;
+
+ private:
+  JSONStreamParserData& data;
+  const char16_t* end;
+
+ public:
+  JSONStreamChunkParser(JSContext* cx, JSONStreamParserData& data)
+      : handler(cx),
+        tokenizer(CharPtr(data.carry.begin() + 1, data.carry.begin(),
+                          data.carry.length()),
+                  CharPtr(data.carry.begin() + 1, data.carry.begin(),
+                          data.carry.length()),
+                  CharPtr(data.carry.end(), data.carry.begin(),
+                          data.carry.length()),
+                  this),
+        data(data),
+        end(data.carry.end()) {}
+
+  JSONStreamChunkParser(const JSONStreamChunkParser& other) = delete;
+  void operator=(const JSONStreamChunkParser& other) = delete;
+
+  // Parse as many tokens as are complete. If |isFinal|, the input ends here
+  // and has to hold a whole JSON text.
+  bool parse(bool isFinal);
+
+  void outOfMemory() { ReportOutOfMemory(handler.context()); }
+
+  void error(const char* msg);
+
+  void trace(JSTracer* trc) {
+    handler.trace(trc);
+    data.trace(trc);
+  }
+
+ private:
+  bool nextTokenIsComplete();
+  bool propertyName(JSONToken token);
+  bool finishValue(JS::Handle<JS::Value> value);
+};
+
+void JSONStreamChunkParser::error(const char* msg) {
+  uint32_t column = 1, line = 1;
+  tokenizer.getTextPosition(&column, &line);
+
+  // The position is relative to the start of this chunk.
+  if (line == 1) {
+    column += data.column - 1;
+  }
+  line += data.line - 1;
+
+  handler.reportError(msg, line, column);
+}
+
+bool JSONStreamChunkParser::nextTokenIsComplete() {
+  const char16_t* ptr = tokenizer.position().get();
+
+  // The scan state saved by the previous chunk belongs to the token it cut
+  // off, which now starts the carry buffer.
+  JSONTokenScan scan;
+  if (ptr == data.carry.begin() + 1) {
+    scan = data.tokenScan;
+  }
+  data.tokenScan = JSONTokenScan();
+
+  while (ptr < end && IsJSONWhitespace(*ptr)) {
+    ptr++;
+  }
+  if (ptr == end) {
+    return false;
+  }
+
+  bool complete;
+  switch (data.state) {
+    case JSONStreamState::Value:
+    case JSONStreamState::ValueOrArrayClose:
+      complete = IsCompleteValueToken(ptr, end, &scan);
+      break;
+    case JSONStreamState::PropertyNameOrObjectClose:
+    case JSONStreamState::PropertyName:
+      complete = *ptr != '"' || IsCompleteStringLiteral(ptr, end, &scan);
+      break;
+    default:
+      // All other tokens are a single character.
+      complete = true;
+      break;
+  }
+
+  if (!complete) {
+    data.tokenScan = scan;
+  }
+  return complete;
+}
+
+bool JSONStreamChunkParser::propertyName(JSONToken token) {
+  if (token == JSONToken::String) {
+    bool isProtoInEval;
+    if (!handler.objectPropertyName(data.stack, &isProtoInEval)) {
+      return false;
+    }
+    MOZ_ASSERT(!isProtoInEval);
+    data.state = JSONStreamState::Colon;
+    return true;
+  }
+  if (token != JSONToken::OOM && token != JSONToken::Error) {
+    error("property names must be double-quoted strings");
+  }
+  return false;
+}
+
+bool JSONStreamChunkParser::finishValue(JS::Handle<JS::Value> value) {
+  if (data.stack.empty()) {
+    data.result = value;
+    data.state = JSONStreamState::Done;
+    return true;
+  }
+
+  if (data.stack.back().state == JSONParserState::FinishArrayElement) {
+    HandlerT::ElementVector* elements;
+    if (!handler.arrayElement(data.stack, value, &elements)) {
+      return false;
+    }
+    data.state = JSONStreamState::AfterArrayElement;
+    return true;
+  }
+
+  HandlerT::PropertyVector* properties;
+  if (!handler.finishObjectMember(data.stack, value, &properties)) {
+    return false;
+  }
+  data.state = JSONStreamState::AfterProperty;
+  return true;
+}
+
+bool JSONStreamChunkParser::parse(bool isFinal) {
+  JS::Rooted<JS::Value> value(handler.context());
+  auto& stack = data.stack;
+
+  while (data.state != JSONStreamState::Done) {
+    if (!isFinal && !nextTokenIsComplete()) {
+      return true;
+    }
+
+    JSONToken token;
+    switch (data.state) {
+      case JSONStreamState::Value:
+      case JSONStreamState::ValueOrArrayClose:
+        token = tokenizer.advance();
+        switch (token) {
+          case JSONToken::String:
+            value = handler.stringValue();
+            break;
+          case JSONToken::Number:
+            value = handler.numberValue();
+            break;
+          case JSONToken::True:
+            value = handler.booleanValue(true);
+            break;
+          case JSONToken::False:
+            value = handler.booleanValue(false);
+            break;
+          case JSONToken::Null:
+            value = handler.nullValue();
+            break;
+
+          case JSONToken::ArrayOpen: {
+            HandlerT::ElementVector* elements;
+            if (!handler.arrayOpen(stack, &elements)) {
+              return false;
+            }
+            data.state = JSONStreamState::ValueOrArrayClose;
+            continue;
+          }
+
+          case JSONToken::ObjectOpen: {
+            HandlerT::PropertyVector* properties;
+            if (!handler.objectOpen(stack, &properties)) {
+              return false;
+            }
+            data.state = JSONStreamState::PropertyNameOrObjectClose;
+            continue;
+          }
+
+          case JSONToken::ArrayClose:
+            if (data.state == JSONStreamState::ValueOrArrayClose) {
+              if (!handler.finishArray(stack, &value,
+                                       &stack.back().elements())) {
+                return false;
+              }
+              break;
+            }
+            [[fallthrough]];
+          case JSONToken::ObjectClose:
+          case JSONToken::Colon:
+          case JSONToken::Comma:
+            // Move the current pointer backwards so that the position
+            // reported in the error message is correct.
+            tokenizer.unget();
+            error("unexpected character");
+            return false;
+
+          case JSONToken::OOM:
+          case JSONToken::Error:
+            return false;
+        }
+        break;
+
+      case JSONStreamState::AfterArrayElement:
+        token = tokenizer.advanceAfterArrayElement();
+        if (token == JSONToken::Comma) {
+          data.state = JSONStreamState::Value;
+          continue;
+        }
+        if (token != JSONToken::ArrayClose) {
+          MOZ_ASSERT(token == JSONToken::Error);
+          return false;
+        }
+        if (!handler.finishArray(stack, &value, &stack.back().elements())) {
+          return false;
+        }
+        break;
+
+      case JSONStreamState::PropertyNameOrObjectClose:
+        token = tokenizer.advanceAfterObjectOpen();
+        if (token == JSONToken::ObjectClose) {
+          if (!handler.finishObject(stack, &value,
+                                    &stack.back().properties())) {
+            return false;
+          }
+          break;
+        }
+        if (!propertyName(token)) {
+          return false;
+        }
+        continue;
+
+      case JSONStreamState::PropertyName:
+        if (!propertyName(tokenizer.advancePropertyName())) {
+          return false;
+        }
+        continue;
+
+      case JSONStreamState::Colon:
+        if (tokenizer.advancePropertyColon() != JSONToken::Colon) {
+          return false;
+        }
+        data.state = JSONStreamState::Value;
+        continue;
+
+      case JSONStreamState::AfterProperty:
+        token = tokenizer.advanceAfterProperty();
+        if (token == JSONToken::Comma) {
+          data.state = JSONStreamState::PropertyName;
+          continue;
+        }
+        if (token != JSONToken::ObjectClose) {
+          MOZ_ASSERT(token == JSONToken::Error);
+          return false;
+        }
+        if (!handler.finishObject(stack, &value, &stack.back().properties())) {
+          return false;
+        }
+        break;
+
+      case JSONStreamState::Done:
+      case JSONStreamState::Failed:
+        MOZ_CRASH("Unexpected JSON stream parser state");
+    }
+
+    // A value has been completed, so add it to its parent.
+    if (!finishValue(value)) {
+      return false;
+    }
+  }
+
+  if (!tokenizer.consumeTrailingWhitespaces()) {
+    error("unexpected non-whitespace character after JSON data");
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+static bool ParseJSONStreamChunk(JSContext* cx,
+                                 JS::Handle<JSObject*> parserObj,
+                                 const char16_t* chars, size_t len,
+                                 bool isFinal) {
+  JSONStreamParserData& data =
+      *parserObj->as<JSONStreamParserObject>().data();
+  if (data.state == JSONStreamState::Failed) {
+    JS_ReportErrorASCII(cx, "JSON stream parser used after an error");
+    return false;
+  }
+
+  // Parsing mutates the stack of the parser in place.
+  gc::PreWriteBarrier(parserObj->zone(), &data);
+
+  // Append the new chunk to the token cut off by the previous one, and parse
+  // as much as possible.
+  bool ok = data.carry.append(chars, len);
+  if (!ok) {
+    ReportOutOfMemory(cx);
+  } else {
+    if (data.afterCR && data.carry.length() > 1) {
+      // A \r\n newline split by the chunks has already been counted.
+      if (data.carry[1] == '\n') {
+        data.carry.erase(&data.carry[1]);
+      }
+      data.afterCR = false;
+    }
+
+    JS::Rooted<JSONStreamChunkParser> parser(cx, cx, data);
+    ok = parser.get().parse(isFinal);
+
+    if (ok && !isFinal) {
+      // Keep the last consumed character and the remaining input, without the
+      // whitespace preceding it.
+      const char16_t* begin = data.carry.begin();
+      const char16_t* end = data.carry.end();
+      const char16_t* pos = parser.get().tokenizer.position().get();
+      const char16_t* rest = pos;
+      while (rest < end && IsJSONWhitespace(*rest)) {
+        rest++;
+      }
+      data.advancePosition(begin + 1, rest);
+
+      data.carry[0] = pos[-1];
+      size_t restLength = end - rest;
+      std::copy(rest, end, data.carry.begin() + 1);
+      data.carry.shrinkTo(restLength + 1);
+    }
+  }
+
+  if (!ok) {
+    data.state = JSONStreamState::Failed;
+  }
+
+  // The stack and the result may now hold nursery things.
+  MOZ_ASSERT(parserObj->isTenured());
+  cx->runtime()->gc.storeBuffer().putWholeCell(parserObj);
+  return ok;
+}
+
+JS_PUBLIC_API JSObject* JS::NewJSONStreamParser(JSContext* cx) {
+  AssertHeapIsIdle();
+  CHECK_THREAD(cx);
+
+  return JSONStreamParserObject::create(cx);
+}
+
+JS_PUBLIC_API bool JS::JSONStreamParserFeed(JSContext* cx,
+                                            JS::Handle<JSObject*> parser,
+                                            const char16_t* chars,
+                                            size_t len) {
+  AssertHeapIsIdle();
+  CHECK_THREAD(cx);
+  MOZ_ASSERT(parser->is<JSONStreamParserObject>());
+
+  return ParseJSONStreamChunk(cx, parser, chars, len, /* isFinal = */ false);
+}
+
+JS_PUBLIC_API bool JS::JSONStreamParserFinish(
+    JSContext* cx, JS::Handle<JSObject*> parser,
+    JS::MutableHandle<JS::Value> vp) {
+  AssertHeapIsIdle();
+  CHECK_THREAD(cx);
+  MOZ_ASSERT(parser->is<JSONStreamParserObject>());
+
+  if (!ParseJSONStreamChunk(cx, parser, nullptr, 0, /* isFinal = */ true)) {
+    return false;
+  }
+
+  JSONStreamParserData& data = *parser->as<JSONStreamParserObject>().data();
+  MOZ_ASSERT(data.state == JSONStreamState::Done);
+  vp.set(data.result);
+  return true;
+}
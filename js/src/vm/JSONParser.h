@@ -20,7 +20,9 @@
 #include "builtin/ParseRecordObject.h"  // js::ParseRecordObject
 #include "ds/IdValuePair.h"             // IdValuePair
 #include "gc/GC.h"                      // AutoSelectGCHeap
+#include "js/AllocPolicy.h"             // SystemAllocPolicy
 #include "js/GCVector.h"                // JS::GCVector
+#include "js/HashTable.h"               // HashMap, HashNumber
 #include "js/RootingAPI.h"  // JS::Handle, JS::MutableHandle, MutableWrappedPtrOperations
 #include "js/Value.h"            // JS::Value, JS::BooleanValue, JS::NullValue
 #include "js/Vector.h"           // Vector
@@ -33,6 +35,7 @@ class JSTracer;
 namespace js {
 
 class FrontendContext;
+class SharedShape;
 
 enum class JSONToken {
   String,
@@ -107,6 +110,8 @@ class MOZ_STACK_CLASS JSONTokenizer {
 
   void unget() { --current; }
 
+  CharPtr position() const { return current; }
+
 #ifdef DEBUG
   bool finished() { return end == current; }
 #endif
@@ -149,6 +154,35 @@ enum class JSONParserState {
   JSONValue
 };
 
+// Shapes of the objects created by a JSON parse, keyed by their sequence of
+// property keys. Arrays of records produce many objects with identical keys,
+// which can then be allocated directly with their final shape and slot count
+// instead of adding their properties one at a time.
+//
+// This complements the realm's NewPlainObjectWithPropsCache, which only holds
+// a handful of shapes and is purged on GC, and thus thrashes when a document
+// interleaves more record types, or when a large parse triggers GCs.
+class JSONObjectShapeCache {
+  // Entries are keyed by a hash of the property keys, and the shape is checked
+  // against the keys on lookup, such that a collision only causes a miss.
+  using Map = HashMap<HashNumber, SharedShape*, DefaultHasher<HashNumber>,
+                      SystemAllocPolicy>;
+  Map shapes_;
+
+  // Bound the number of shapes kept alive by a parse.
+  static constexpr uint32_t MaxEntries = 256;
+
+  static HashNumber hashKeys(JS::Handle<IdValueVector> properties);
+
+ public:
+  SharedShape* lookup(JS::Handle<IdValueVector> properties) const;
+
+  // Adding is best effort, and silently does nothing on OOM.
+  void add(JS::Handle<IdValueVector> properties, SharedShape* shape);
+
+  void trace(JSTracer* trc);
+};
+
 // Character-type-agnostic base class for JSONFullParseHandler.
 // JSONParser is templatized to work on either Latin1
 // or TwoByte input strings, JSONFullParseHandlerAnyChar holds all state and
@@ -225,6 +259,8 @@ class MOZ_STACK_CLASS JSONFullParseHandlerAnyChar {
   Vector<ElementVector*, 5> freeElements;
   Vector<PropertyVector*, 5> freeProperties;
 
+  JSONObjectShapeCache shapeCache;
+
  public:
   explicit JSONFullParseHandlerAnyChar(JSContext* cx);
   ~JSONFullParseHandlerAnyChar();
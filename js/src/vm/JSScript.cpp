@@ -64,6 +64,7 @@
 #include "vm/BytecodeLocation.h"
 #include "vm/BytecodeUtil.h"  // Disassemble
 #include "vm/Compression.h"
+#include "vm/ConcurrentDelazification.h"  // js::DelazificationProfile
 #include "vm/HelperThreadState.h"  // js::RunPendingSourceCompressions
 #include "vm/JSFunction.h"
 #include "vm/JSObject.h"
@@ -1681,6 +1682,12 @@ bool ScriptSource::assignSource(FrontendContext* fc,
   mutedErrors_ = options.mutedErrors();
   delazificationMode_ = options.eagerDelazificationStrategy();
 
+  if (delazificationMode_ ==
+      JS::DelazificationOption::ConcurrentProfileGuided) {
+    profileSourceHash_ = DelazificationProfile::hashSource(srcBuf.get(),
+                                                           srcBuf.length());
+  }
+
   if (options.discardSource) {
     return true;
   }
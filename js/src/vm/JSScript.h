@@ -613,6 +613,12 @@ class ScriptSource {
   JS::DelazificationOption delazificationMode_ =
       JS::DelazificationOption::OnDemandOnly;
 
+  // Hash of the source text, used to identify this source across processes in
+  // the DelazificationProfile. Only computed for sources compiled with the
+  // ConcurrentProfileGuided delazification mode, 0 otherwise. Decoded sources
+  // keep the hash of the source they were encoded from.
+  HashNumber profileSourceHash_ = 0;
+
   // True if an associated SourceCompressionTask was ever created.
   bool hadCompressionTask_ = false;
 
@@ -1103,6 +1109,7 @@ class ScriptSource {
   JS::DelazificationOption delazificationMode() const {
     return delazificationMode_;
   }
+  HashNumber profileSourceHash() const { return profileSourceHash_; }
 
   bool hasIntroductionOffset() const { return introductionOffset_.isSome(); }
   uint32_t introductionOffset() const { return introductionOffset_.value(); }
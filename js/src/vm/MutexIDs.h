@@ -62,6 +62,7 @@
   _(GCDelayedMarkingLock, 500)        \
   _(BufferAllocator, 500)             \
   _(GeckoProfilerScriptSources, 500)  \
+  _(DelazificationProfile, 500)       \
                                       \
   _(SharedImmutableStringsCache, 600) \
   _(IrregexpLazyStatic, 600)          \
@@ -70,7 +71,9 @@
   _(WasmInliningBudget, 600)          \
   _(VTuneLock, 600)                   \
   _(ShellTelemetry, 600)              \
-  _(ShellUseCounters, 600)
+  _(ShellUseCounters, 600)            \
+                                      \
+  _(LifoChunkCache, 700)
 
 namespace js {
 namespace mutexid {
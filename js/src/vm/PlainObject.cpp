@@ -207,7 +207,8 @@ void js::NewPlainObjectWithPropsCache::add(SharedShape* shape) {
   entries_[0] = shape;
 }
 
-static bool ShapeMatches(Handle<IdValueVector> properties, SharedShape* shape) {
+bool js::PlainObjectShapeMatches(Handle<IdValueVector> properties,
+                                 SharedShape* shape) {
   if (shape->slotSpan() != properties.length()) {
     return false;
   }
@@ -228,13 +229,43 @@ SharedShape* js::NewPlainObjectWithPropsCache::lookup(
     Handle<IdValueVector> properties) const {
   for (size_t i = 0; i < NumEntries; i++) {
     SharedShape* shape = entries_[i];
-    if (shape && ShapeMatches(properties, shape)) {
+    if (shape && PlainObjectShapeMatches(properties, shape)) {
       return shape;
     }
   }
   return nullptr;
 }
 
+PlainObject* js::NewPlainObjectWithShapeAndValues(
+    JSContext* cx, Handle<SharedShape*> shape, Handle<IdValueVector> properties,
+    NewObjectKind newKind) {
+  MOZ_ASSERT(PlainObjectShapeMatches(properties, shape));
+
+  PlainObject* obj = PlainObject::createWithShape(cx, shape, newKind);
+  if (!obj) {
+    return nullptr;
+  }
+  MOZ_ASSERT(obj->slotSpan() == properties.length());
+  for (size_t i = 0; i < properties.length(); i++) {
+    obj->initSlot(i, properties[i].get().value);
+  }
+  return obj;
+}
+
+SharedShape* js::ReusablePlainObjectShape(PlainObject* obj,
+                                          Handle<IdValueVector> properties) {
+  // Objects with integer keys or duplicate keys do not have one slot per
+  // entry, and dictionary shapes are not shared.
+  if (properties.empty() || obj->inDictionaryMode() ||
+      obj->getDenseInitializedLength() != 0 ||
+      obj->slotSpan() != properties.length()) {
+    return nullptr;
+  }
+  SharedShape* shape = obj->sharedShape();
+  MOZ_ASSERT(PlainObjectShapeMatches(properties, shape));
+  return shape;
+}
+
 enum class KeysKind { UniqueNames, Unknown };
 
 template <KeysKind Kind>
@@ -246,15 +277,7 @@ static PlainObject* NewPlainObjectWithProperties(
   // Shape directly.
   if (SharedShape* shape = cache.lookup(properties)) {
     Rooted<SharedShape*> shapeRoot(cx, shape);
-    PlainObject* obj = PlainObject::createWithShape(cx, shapeRoot, newKind);
-    if (!obj) {
-      return nullptr;
-    }
-    MOZ_ASSERT(obj->slotSpan() == properties.length());
-    for (size_t i = 0; i < properties.length(); i++) {
-      obj->initSlot(i, properties[i].get().value);
-    }
-    return obj;
+    return NewPlainObjectWithShapeAndValues(cx, shapeRoot, properties, newKind);
   }
 
   gc::AllocKind allocKind = gc::GetGCObjectKind(properties.length());
@@ -108,6 +108,23 @@ extern PlainObject* NewPlainObjectWithMaybeDuplicateKeys(
     JSContext* cx, Handle<IdValueVector> properties,
     NewObjectKind newKind = GenericObject);
 
+// Return true if |shape| has exactly the keys of |properties|, in order, as
+// default data properties.
+extern bool PlainObjectShapeMatches(Handle<IdValueVector> properties,
+                                    SharedShape* shape);
+
+// Create a plain object with the given shape and initialize its slots with the
+// values of |properties|. |shape| must match |properties|, see
+// PlainObjectShapeMatches.
+extern PlainObject* NewPlainObjectWithShapeAndValues(
+    JSContext* cx, Handle<SharedShape*> shape, Handle<IdValueVector> properties,
+    NewObjectKind newKind = GenericObject);
+
+// Return the shape of an object created by NewPlainObjectWith*Keys/Names from
+// |properties|, if it can be reused for objects with the same keys, or nullptr.
+extern SharedShape* ReusablePlainObjectShape(PlainObject* obj,
+                                             Handle<IdValueVector> properties);
+
 }  // namespace js
 
 #endif  // vm_PlainObject_h
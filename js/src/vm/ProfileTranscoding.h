@@ -0,0 +1,93 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+ * vim: set ts=8 sts=2 et sw=2 tw=80:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_ProfileTranscoding_h
+#define vm_ProfileTranscoding_h
+
+#include <stddef.h>  // size_t
+#include <stdint.h>  // uint8_t, uint32_t, uint64_t
+#include <string.h>  // memcpy
+
+#include "js/Transcoding.h"  // JS::TranscodeBuffer, JS::TranscodeRange
+
+namespace js {
+
+// Flat encoding shared by the profiles which can be carried over to a later
+// process of the same build: JIT hints, the delazification profile and the
+// pretenuring profile. An encoding starts with a magic number and a version
+// identifying the kind of profile and its format, followed by values in the
+// native byte order.
+
+class ProfileWriter {
+  JS::TranscodeBuffer& buffer_;
+  bool ok_ = true;
+
+ public:
+  ProfileWriter(JS::TranscodeBuffer& buffer, uint32_t magic, uint32_t version)
+      : buffer_(buffer) {
+    writeUint32(magic);
+    writeUint32(version);
+  }
+
+  void writeBytes(const uint8_t* bytes, size_t length) {
+    ok_ = ok_ && buffer_.append(bytes, length);
+  }
+  void writeUint32(uint32_t value) {
+    writeBytes(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+  }
+  void writeUint64(uint64_t value) {
+    writeBytes(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+  }
+
+  // Returns false if any of the writes ran out of memory.
+  bool ok() const { return ok_; }
+};
+
+// Reads an encoding produced by ProfileWriter. Reads past the end of the range
+// fail, so that decoders can validate a whole buffer before merging anything.
+class ProfileReader {
+  const uint8_t* cur_;
+  const uint8_t* end_;
+
+  template <typename T>
+  [[nodiscard]] bool readValue(T* value) {
+    const uint8_t* bytes;
+    if (!readBytes(&bytes, sizeof(T))) {
+      return false;
+    }
+    memcpy(value, bytes, sizeof(T));
+    return true;
+  }
+
+ public:
+  explicit ProfileReader(const JS::TranscodeRange& range)
+      : cur_(range.begin().get()), end_(range.end().get()) {}
+
+  // Returns false if the magic number or the version do not match.
+  [[nodiscard]] bool readHeader(uint32_t magic, uint32_t version) {
+    uint32_t value;
+    return readUint32(&value) && value == magic && readUint32(&value) &&
+           value == version;
+  }
+
+  [[nodiscard]] bool readBytes(const uint8_t** bytes, size_t length) {
+    if (size_t(end_ - cur_) < length) {
+      return false;
+    }
+    *bytes = cur_;
+    cur_ += length;
+    return true;
+  }
+  [[nodiscard]] bool readUint32(uint32_t* value) { return readValue(value); }
+  [[nodiscard]] bool readUint64(uint64_t* value) { return readValue(value); }
+
+  const uint8_t* position() const { return cur_; }
+  bool done() const { return cur_ == end_; }
+};
+
+}  // namespace js
+
+#endif /* vm_ProfileTranscoding_h */
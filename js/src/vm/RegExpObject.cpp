@@ -622,6 +622,7 @@ void RegExpShared::traceChildren(JSTracer* trc) {
       TraceNullableEdge(trc, &comp.jitCode, "RegExpShared code");
     }
     TraceNullableEdge(trc, &groupsTemplate_, "RegExpShared groups template");
+    TraceNullableEdge(trc, &requiredPrefix_, "RegExpShared required prefix");
   }
 }
 
@@ -724,6 +725,16 @@ RegExpRunStatus RegExpShared::execute(JSContext* cx,
     return RegExpRunStatus::Error;
   }
 
+  // Skip to the first occurrence of the required prefix, if any. Matches can
+  // only start there, so if there is none the regexp cannot match.
+  if (JSAtom* prefix = re->requiredPrefix()) {
+    int index = StringFindPattern(input, prefix, start);
+    if (index < 0) {
+      return RegExpRunStatus::Success_NotFound;
+    }
+    start = size_t(index);
+  }
+
   uint32_t interruptRetries = 0;
   const uint32_t maxInterruptRetries = 4;
   do {
@@ -792,10 +803,12 @@ void RegExpShared::useAtomMatch(Handle<JSAtom*> pattern) {
   pairCount_ = 1;
 }
 
-void RegExpShared::useRegExpMatch(size_t pairCount) {
+void RegExpShared::useRegExpMatch(size_t pairCount, JSAtom* requiredPrefix) {
   MOZ_ASSERT(kind() == RegExpShared::Kind::Unparsed);
+  MOZ_ASSERT_IF(requiredPrefix, !ignoreCase() && !sticky());
   kind_ = RegExpShared::Kind::RegExp;
   pairCount_ = pairCount;
+  requiredPrefix_ = requiredPrefix;
   ticks_ = jit::JitOptions.regexpWarmUpThreshold;
 }
 
@@ -1067,6 +1080,150 @@ size_t RegExpZone::sizeOfIncludingThis(
 
 RegExpZone::RegExpZone(Zone* zone) : set_(zone, zone) {}
 
+/* RegExpBytecodeCache */
+
+/* static */
+HashNumber RegExpBytecodeCache::hash(JSAtom* pattern, RegExpFlags flags,
+                                     bool latin1) {
+  return mozilla::AddToHash(pattern->hash(), flags.value(), latin1);
+}
+
+bool RegExpBytecodeCache::Entry::match(HashNumber lookupHash, JSAtom* atom,
+                                       RegExpFlags lookupFlags,
+                                       bool lookupLatin1) const {
+  if (!compilation.byteCode || hash != lookupHash || flags != lookupFlags ||
+      latin1 != lookupLatin1 || patternLength != atom->length()) {
+    return false;
+  }
+
+  AutoCheckCannotGC nogc;
+  return atom->hasLatin1Chars()
+             ? EqualChars(atom->latin1Chars(nogc), pattern.get(), patternLength)
+             : EqualChars(atom->twoByteChars(nogc), pattern.get(),
+                          patternLength);
+}
+
+static RegExpBytecodeCache::UniqueByteCode CopyByteCode(
+    RegExpBytecodeCache::ByteCode* byteCode) {
+  size_t size = sizeof(RegExpBytecodeCache::ByteCode) + byteCode->length();
+  RegExpBytecodeCache::UniqueByteCode copy(
+      static_cast<RegExpBytecodeCache::ByteCode*>(js_malloc(size)));
+  if (copy) {
+    memcpy(copy.get(), byteCode, size);
+  }
+  return copy;
+}
+
+static UniqueTwoByteChars CopyTwoByteChars(const char16_t* chars,
+                                           size_t length) {
+  UniqueTwoByteChars copy(js_pod_malloc<char16_t>(length));
+  if (copy) {
+    PodCopy(copy.get(), chars, length);
+  }
+  return copy;
+}
+
+static UniqueTwoByteChars CopyTwoByteChars(JSLinearString* str) {
+  UniqueTwoByteChars copy(js_pod_malloc<char16_t>(str->length()));
+  if (copy) {
+    CopyChars(copy.get(), *str);
+  }
+  return copy;
+}
+
+bool RegExpBytecodeCache::lookup(JSAtom* pattern, RegExpFlags flags,
+                                 bool latin1, Compilation* result) {
+  HashNumber h = hash(pattern, flags, latin1);
+  const Entry& entry = entries_[h % NumEntries];
+  if (!entry.match(h, pattern, flags, latin1)) {
+    return false;
+  }
+
+  const Compilation& compilation = entry.compilation;
+  result->byteCode = CopyByteCode(compilation.byteCode.get());
+  if (!result->byteCode) {
+    return false;
+  }
+  if (compilation.requiredPrefix) {
+    result->requiredPrefix =
+        CopyTwoByteChars(compilation.requiredPrefix.get(),
+                         compilation.requiredPrefixLength);
+    if (!result->requiredPrefix) {
+      return false;
+    }
+  }
+  result->requiredPrefixLength = compilation.requiredPrefixLength;
+  result->pairCount = compilation.pairCount;
+  result->maxRegisters = compilation.maxRegisters;
+  return true;
+}
+
+void RegExpBytecodeCache::maybePut(JSAtom* pattern, RegExpFlags flags,
+                                   bool latin1, uint32_t pairCount,
+                                   uint32_t maxRegisters,
+                                   JSAtom* requiredPrefix,
+                                   ByteCode* byteCode) {
+  if (byteCode->length() > MaxByteCodeLength) {
+    return;
+  }
+
+  HashNumber h = hash(pattern, flags, latin1);
+  Entry& entry = entries_[h % NumEntries];
+  if (entry.match(h, pattern, flags, latin1)) {
+    return;
+  }
+
+  UniqueTwoByteChars chars = CopyTwoByteChars(pattern);
+  if (!chars) {
+    return;
+  }
+
+  Compilation compilation;
+  compilation.byteCode = CopyByteCode(byteCode);
+  if (!compilation.byteCode) {
+    return;
+  }
+  if (requiredPrefix) {
+    compilation.requiredPrefix = CopyTwoByteChars(requiredPrefix);
+    if (!compilation.requiredPrefix) {
+      return;
+    }
+    compilation.requiredPrefixLength = requiredPrefix->length();
+  }
+  compilation.pairCount = pairCount;
+  compilation.maxRegisters = maxRegisters;
+
+  entry.hash = h;
+  entry.flags = flags;
+  entry.latin1 = latin1;
+  entry.patternLength = pattern->length();
+  entry.pattern = std::move(chars);
+  entry.compilation = std::move(compilation);
+}
+
+void RegExpBytecodeCache::purge() {
+  for (Entry& entry : entries_) {
+    entry.pattern.reset();
+    entry.compilation = Compilation();
+  }
+}
+
+size_t RegExpBytecodeCache::sizeOfExcludingThis(
+    mozilla::MallocSizeOf mallocSizeOf) const {
+  size_t n = 0;
+  for (const Entry& entry : entries_) {
+    if (!entry.pattern) {
+      continue;
+    }
+    n += mallocSizeOf(entry.pattern.get());
+    n += mallocSizeOf(entry.compilation.byteCode.get());
+    if (entry.compilation.requiredPrefix) {
+      n += mallocSizeOf(entry.compilation.requiredPrefix.get());
+    }
+  }
+  return n;
+}
+
 /* Functions */
 
 JSObject* js::CloneRegExpObject(JSContext* cx, Handle<RegExpObject*> regex) {
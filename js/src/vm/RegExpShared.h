@@ -118,6 +118,12 @@ class RegExpShared
 
   RegExpShared::Kind kind_ = Kind::Unparsed;
   GCPtr<JSAtom*> patternAtom_;
+
+  // For Kind::RegExp, a literal string that every match starts with, if there
+  // is one. Execution searches for it to skip ahead to the first candidate
+  // position, or to fail without running the matcher.
+  GCPtr<JSAtom*> requiredPrefix_;
+
   uint32_t maxRegisters_ = 0;
   uint32_t ticks_ = 0;
 
@@ -185,8 +191,9 @@ class RegExpShared
   // Use simple string matching for this regexp.
   void useAtomMatch(Handle<JSAtom*> pattern);
 
-  // Use the regular expression engine for this regexp.
-  void useRegExpMatch(size_t parenCount);
+  // Use the regular expression engine for this regexp. |requiredPrefix| may
+  // be null.
+  void useRegExpMatch(size_t parenCount, JSAtom* requiredPrefix);
 
   static void InitializeNamedCaptures(JSContext* cx, HandleRegExpShared re,
                                       uint32_t numNamedCaptures,
@@ -247,6 +254,7 @@ class RegExpShared
   }
 
   JSAtom* patternAtom() const { return patternAtom_; }
+  JSAtom* requiredPrefix() const { return requiredPrefix_; }
 
   JS::RegExpFlags getFlags() const { return flags; }
 
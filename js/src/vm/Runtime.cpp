@@ -21,10 +21,12 @@
 #include "jsmath.h"
 
 #include "builtin/String.h"
+#include "ds/LifoAlloc.h"  // js::SizeOfLifoChunkCache
 #include "frontend/CompilationStencil.h"
 #include "frontend/ParserAtom.h"  // frontend::WellKnownParserAtoms
 #include "gc/GC.h"
 #include "gc/PublicIterators.h"
+#include "jit/CacheIRAOT.h"
 #include "jit/IonCompileTask.h"
 #include "jit/JitRuntime.h"
 #include "jit/Simulator.h"
@@ -274,6 +276,14 @@ void JSRuntime::destroyRuntime() {
   defaultLocale = nullptr;
   js_delete(jitRuntime_.ref());
 
+#ifdef ENABLE_JS_AOT_ICS
+  if (aotICRecorder) {
+    aotICRecorder->finish();
+    js_delete(aotICRecorder.ref());
+  }
+  aotICRecorder = nullptr;
+#endif
+
 #ifdef DEBUG
   initialized_ = false;
 #endif
@@ -331,6 +341,8 @@ void JSRuntime::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
       cx->interpreterStack().sizeOfExcludingThis(mallocSizeOf);
   rtSizes->uncompressedSourceCache +=
       caches().uncompressedSourceCache.sizeOfExcludingThis(mallocSizeOf);
+  rtSizes->regExpBytecodeCache +=
+      caches().regExpBytecodeCache.sizeOfExcludingThis(mallocSizeOf);
 
   rtSizes->gc.nurseryCommitted += gc.nursery().totalCommitted();
   rtSizes->gc.nurseryMallocedBuffers +=
@@ -344,6 +356,7 @@ void JSRuntime::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
     rtSizes->atomsTable +=
         js::frontend::WellKnownParserAtoms::getSingleton().sizeOfExcludingThis(
             mallocSizeOf);
+    rtSizes->lifoChunkCache += js::SizeOfLifoChunkCache(mallocSizeOf);
   }
 
 #ifdef JS_HAS_INTL_API
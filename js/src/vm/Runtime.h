@@ -99,6 +99,7 @@ class Shape;
 class SourceHook;
 
 namespace jit {
+class AOTICRecorder;
 class JitRuntime;
 class JitActivation;
 struct PcScriptCache;
@@ -708,6 +709,11 @@ struct JSRuntime {
       JS::GCVector<js::PlainObject*, 0, js::SystemAllocPolicy>>;
   js::MainThreadData<js::UniquePtr<RootedPlainObjVec>> watchtowerTestingLog;
 
+#ifdef ENABLE_JS_AOT_ICS
+  /* Attached IC bodies recorded with --record-aot-ics, created lazily. */
+  js::MainThreadData<js::jit::AOTICRecorder*> aotICRecorder{nullptr};
+#endif
+
  private:
   /* Code coverage output. */
   js::UnprotectedData<js::coverage::LCovRuntime> lcovOutput_;
@@ -865,6 +871,7 @@ struct JSRuntime {
 
   js::AtomsTable& atoms() {
     MOZ_ASSERT(atoms_);
+    MOZ_ASSERT(js::CurrentThreadCanAccessRuntime(this));
     return *atoms_;
   }
 
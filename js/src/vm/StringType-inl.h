@@ -353,10 +353,18 @@ inline JSRope::JSRope(JSString* left, JSString* right, size_t length) {
   MOZ_ASSERT_IF(!isLatin1, !JSInlineString::lengthFits<char16_t>(length));
   MOZ_ASSERT_IF(isLatin1, !JSInlineString::lengthFits<JS::Latin1Char>(length));
 
+  size_t depth = 1;
+  if (left->isRope()) {
+    depth = std::min(left->asRope().leftSpineDepth() + 1, EagerFlattenDepth);
+  }
+  static_assert((EagerFlattenDepth << ROPE_DEPTH_SHIFT) <= ROPE_DEPTH_MASK,
+                "Rope flags must be able to hold the left spine depth");
+  uint32_t flags = INIT_ROPE_FLAGS | (uint32_t(depth) << ROPE_DEPTH_SHIFT);
+
   if (isLatin1) {
-    setLengthAndFlags(length, INIT_ROPE_FLAGS | LATIN1_CHARS_BIT);
+    setLengthAndFlags(length, flags | LATIN1_CHARS_BIT);
   } else {
-    setLengthAndFlags(length, INIT_ROPE_FLAGS);
+    setLengthAndFlags(length, flags);
   }
   d.s.u2.left = left;
   d.s.u3.right = right;
@@ -349,6 +349,10 @@ const char* RepresentationToString(const JSString* s) {
 template <typename KnownF, typename UnknownF>
 void ForEachStringFlag(const JSString* str, uint32_t flags, KnownF known,
                        UnknownF unknown) {
+  if (str->isRope()) {
+    // Not a flag, see JSRope::leftSpineDepth.
+    flags &= ~JSString::ROPE_DEPTH_MASK;
+  }
   for (uint32_t i = js::Bit(3); i < js::Bit(17); i = i << 1) {
     if (!(flags & i)) {
       continue;
@@ -867,6 +871,8 @@ bool JSRope::hash(uint32_t* outHash) const {
 
 #if defined(DEBUG) || defined(JS_JITSPEW) || defined(JS_CACHEIR_SPEW)
 void JSRope::dumpOwnRepresentationFields(js::JSONPrinter& json) const {
+  json.property("leftSpineDepth", leftSpineDepth());
+
   json.beginObjectProperty("leftChild");
   leftChild()->dumpRepresentationFields(json);
   json.endObject();
@@ -879,14 +885,29 @@ void JSRope::dumpOwnRepresentationFields(js::JSONPrinter& json) const {
 
 namespace js {
 
+// Latin1 strings shorter than this are inflated with a simple loop. The
+// vectorized conversion in CopyAndInflateChars has a fixed call overhead that
+// dominates for the short leaves of ropes built by repeated concatenation.
+static constexpr size_t MinLengthForVectorInflate = 32;
+
 template <>
 void CopyChars(char16_t* dest, const JSLinearString& str) {
   AutoCheckCannotGC nogc;
+  size_t len = str.length();
   if (str.hasTwoByteChars()) {
-    PodCopy(dest, str.twoByteChars(nogc), str.length());
-  } else {
-    CopyAndInflateChars(dest, str.latin1Chars(nogc), str.length());
+    PodCopy(dest, str.twoByteChars(nogc), len);
+    return;
+  }
+
+  const Latin1Char* chars = str.latin1Chars(nogc);
+  if (len < MinLengthForVectorInflate) {
+    for (size_t i = 0; i < len; i++) {
+      dest[i] = chars[i];
+    }
+    return;
   }
+
+  CopyAndInflateChars(dest, chars, len);
 }
 
 template <>
@@ -1365,7 +1386,15 @@ JSString* js::ConcatStrings(
     return str;
   }
 
-  return JSRope::new_<allowGC>(cx, left, right, wholeLength, heap);
+  JSRope* rope = JSRope::new_<allowGC>(cx, left, right, wholeLength, heap);
+  if (rope && MOZ_UNLIKELY(rope->hasDeepLeftSpine())) {
+    // Flattening is only an optimization here, so keep the rope if we can't
+    // allocate the buffer.
+    if (JSLinearString* linear = rope->tryFlatten()) {
+      return linear;
+    }
+  }
+  return rope;
 }
 
 template JSString* js::ConcatStrings<CanGC>(JSContext* cx, HandleString left,
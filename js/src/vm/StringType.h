@@ -390,6 +390,7 @@ class JSString : public js::gc::CellWithLengthAndFlags {
    *   Bit 6: IsInline (Inline, FatInline, ThinInlineAtom, FatInlineAtom)
    *
    * If INDEX_VALUE_BIT is set, bits 16 and up will also hold an integer index.
+   * Ropes use bits 16 and up for the depth of their left spine instead.
    */
 
   // The low bits of flag word are reserved by GC.
@@ -448,6 +449,11 @@ class JSString : public js::gc::CellWithLengthAndFlags {
   static const uint32_t INDEX_VALUE_BIT = js::Bit(11);
   static const uint32_t INDEX_VALUE_SHIFT = 16;
 
+  // Ropes store the number of ropes on their left spine, including the rope
+  // itself, in the bits above the flags. See JSRope::leftSpineDepth.
+  static const uint32_t ROPE_DEPTH_SHIFT = 16;
+  static const uint32_t ROPE_DEPTH_MASK = js::BitMask(5) << ROPE_DEPTH_SHIFT;
+
   // Whether this is a non-inline linear string with a refcounted
   // mozilla::StringBuffer.
   //
@@ -1037,6 +1043,27 @@ class JSRope : public JSString {
     return d.s.u3.right;
   }
 
+  // Appending to the same string in a loop builds a rope whose left children
+  // are ropes all the way down. ConcatStrings flattens such a rope once its
+  // left spine is this many ropes deep. Each flatten reuses the buffer of the
+  // previous one, so appended characters are copied about once and the rope
+  // stays shallow.
+  static constexpr size_t EagerFlattenDepth = 16;
+
+  // The number of ropes on the left spine, including this one, saturated at
+  // EagerFlattenDepth. This is set when the rope is created and is not
+  // updated when a child is flattened, so it is an upper bound.
+  size_t leftSpineDepth() const {
+    return (flags() & ROPE_DEPTH_MASK) >> ROPE_DEPTH_SHIFT;
+  }
+
+  bool hasDeepLeftSpine() const {
+    return leftSpineDepth() >= EagerFlattenDepth;
+  }
+
+  // Flatten without reporting OOM. On failure the rope is left unchanged.
+  JSLinearString* tryFlatten() { return flattenInternal(); }
+
   void traceChildren(JSTracer* trc);
 
 #if defined(DEBUG) || defined(JS_JITSPEW) || defined(JS_CACHEIR_SPEW)
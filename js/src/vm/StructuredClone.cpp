@@ -43,6 +43,7 @@
 
 #include "builtin/DataViewObject.h"
 #include "builtin/MapObject.h"
+#include "ds/IdValuePair.h"  // js::IdValuePair, js::IdValueVector
 #include "gc/GC.h"           // AutoSelectGCHeap
 #include "js/Array.h"        // JS::GetArrayLength, JS::IsArrayObject
 #include "js/ArrayBuffer.h"  // JS::{ArrayBufferHasData,DetachArrayBuffer,IsArrayBufferObject,New{,Mapped}ArrayBufferWithContents,ReleaseMappedArrayBufferContents}
@@ -61,6 +62,8 @@
 #include "util/DifferentialTesting.h"
 #include "vm/BigIntType.h"
 #include "vm/ErrorObject.h"
+#include "vm/HelperThreadState.h"  // ArrayBufferCopyTask, HelperThreadState, IsHelperThreadStateInitialized
+#include "vm/HelperThreads.h"  // AutoLockHelperThreadState, AutoUnlockHelperThreadState
 #include "vm/JSContext.h"
 #include "vm/PlainObject.h"  // js::PlainObject
 #include "vm/RegExpObject.h"
@@ -72,10 +75,12 @@
 #include "vm/ArrayObject-inl.h"
 #include "vm/Compartment-inl.h"
 #include "vm/ErrorObject-inl.h"
+#include "vm/JSAtomUtils-inl.h"  // AtomToId
 #include "vm/JSContext-inl.h"
 #include "vm/JSObject-inl.h"
 #include "vm/NativeObject-inl.h"
 #include "vm/ObjectOperations-inl.h"
+#include "vm/PlainObject-inl.h"
 #include "vm/Realm-inl.h"
 #include "vm/StringType-inl.h"
 
@@ -151,6 +156,11 @@ enum StructuredDataType : uint32_t {
   SCTAG_GROWABLE_SHARED_ARRAY_BUFFER_OBJECT,
   SCTAG_IMMUTABLE_ARRAY_BUFFER_OBJECT,
 
+  // Plain objects sharing a shape. See traverseObject.
+  SCTAG_SHAPE_TEMPLATE_OBJECT,
+  SCTAG_SHAPED_OBJECT,
+  SCTAG_SHAPED_OBJECT_HOLE,
+
   SCTAG_TYPED_ARRAY_V1_MIN = 0xFFFF0100,
   SCTAG_TYPED_ARRAY_V1_INT8 = SCTAG_TYPED_ARRAY_V1_MIN + Scalar::Int8,
   SCTAG_TYPED_ARRAY_V1_UINT8 = SCTAG_TYPED_ARRAY_V1_MIN + Scalar::Uint8,
@@ -262,6 +272,29 @@ struct BufferIterator {
     return mBuffer.ReadBytes(mIter, outData, size);
   }
 
+  bool hasBytesAvailable(size_t size) const {
+    return mIter.HasBytesAvailable(mBuffer, size);
+  }
+
+  // Like readBytes, but calls |f(data, length)| for each contiguous range of
+  // the next |size| bytes instead of copying them. Returns false without
+  // calling |f| if fewer than |size| bytes remain, or if |f| returns false.
+  template <typename F>
+  [[nodiscard]] bool forEachRange(size_t size, F&& f) {
+    if (!hasBytesAvailable(size)) {
+      return false;
+    }
+    while (size) {
+      size_t length = std::min(mIter.RemainingInSegment(), size);
+      if (!f(mIter.Data(), length)) {
+        return false;
+      }
+      mIter.Advance(mBuffer, length);
+      size -= length;
+    }
+    return true;
+  }
+
   void write(const T& data) {
     MOZ_ASSERT(mIter.HasRoomFor(sizeof(T)));
     *reinterpret_cast<T*>(mIter.Data()) = data;
@@ -413,6 +446,14 @@ class SCInput {
   template <class T>
   [[nodiscard]] bool readArray(T* p, size_t nelems);
 
+  // Skip over the next |nbytes| bytes, which were written by writeBytes, and
+  // call |f(data, length)| for each contiguous range of the buffer that they
+  // occupy. The ranges remain valid for the lifetime of the buffer. Returns
+  // false if the input is truncated, which is reported, or if |f| returns
+  // false.
+  template <typename F>
+  [[nodiscard]] bool readByteRanges(size_t nbytes, F&& f);
+
   bool reportTruncated() {
     JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr,
                               JSMSG_SC_BAD_SERIALIZED_DATA, "truncated");
@@ -470,6 +511,12 @@ struct JSStructuredCloneReader {
   [[nodiscard]] bool readV1ArrayBuffer(uint32_t arrayType, uint32_t nelems,
                                        MutableHandleValue vp);
 
+  // Fill in the contents of an ArrayBuffer, copying large ones on helper
+  // threads. The buffer must not be observed until finishArrayBufferCopies()
+  // has been called.
+  [[nodiscard]] bool readArrayBufferContents(uint8_t* dest, size_t nbytes);
+  void finishArrayBufferCopies();
+
   [[nodiscard]] bool readSharedArrayBuffer(StructuredDataType type,
                                            MutableHandleValue vp);
 
@@ -492,6 +539,12 @@ struct JSStructuredCloneReader {
 
   [[nodiscard]] bool readObjectField(HandleObject obj, HandleValue key);
 
+  // Plain objects written with a shape template contain only property values,
+  // which are stored directly into the slots of the template's shape.
+  [[nodiscard]] bool readShapeTemplate(uint32_t nkeys, MutableHandleValue vp);
+  [[nodiscard]] bool readShapedObject(uint32_t index, MutableHandleValue vp);
+  [[nodiscard]] bool readShapedObjectField(HandleObject obj, uint32_t tag);
+
   [[nodiscard]] bool startRead(
       MutableHandleValue vp,
       ShouldAtomizeStrings atomizeStrings = DontAtomizeStrings);
@@ -525,6 +578,27 @@ struct JSStructuredCloneReader {
   // have been read yet.
   Rooted<GCVector<std::pair<HeapPtr<JSObject*>, bool>, 8>> objState;
 
+  // Shapes of the shape templates read so far, by template index.
+  Rooted<GCVector<SharedShape*>> shapeTemplates;
+
+  // Like objState, a stack of state for the objects on the `objs` stack that
+  // were written with a shape template: the template's shape and the slot for
+  // the next property value.
+  struct ShapedObjectState {
+    HeapPtr<JSObject*> obj;
+    HeapPtr<SharedShape*> shape;
+    uint32_t nextSlot = 0;
+
+    ShapedObjectState(JSObject* obj, SharedShape* shape)
+        : obj(obj), shape(shape) {}
+
+    void trace(JSTracer* trc) {
+      TraceEdge(trc, &obj, "ShapedObjectState::obj");
+      TraceEdge(trc, &shape, "ShapedObjectState::shape");
+    }
+  };
+  Rooted<GCVector<ShapedObjectState, 8>> shapedObjState;
+
   // Array of all objects read during this deserialization, for resolving
   // backreferences.
   //
@@ -555,6 +629,14 @@ struct JSStructuredCloneReader {
   // and a couple of others.
   AutoSelectGCHeap gcHeap;
 
+  // Copies of large ArrayBuffer contents that may still be running on helper
+  // threads. The buffers are kept alive by |allObjs| until the copies finish.
+  Vector<UniquePtr<ArrayBufferCopyTask>, 0, SystemAllocPolicy> copyTasks;
+
+  // Whether a read callback is running. The embedding may look at the contents
+  // of any buffers it reads, so these are copied immediately.
+  bool inReadCallback = false;
+
   friend bool JS_ReadString(JSStructuredCloneReader* r,
                             JS::MutableHandleString str);
   friend bool JS_ReadTypedArray(JSStructuredCloneReader* r,
@@ -582,9 +664,11 @@ struct JSStructuredCloneWriter {
         closure(cbClosure),
         objs(cx),
         counts(cx),
+        shapedObjDepths(cx),
         objectEntries(cx),
         otherEntries(cx),
         memory(cx),
+        shapeTemplates(cx),
         transferable(cx, tVal),
         transferableObjects(cx, TransferableObjectsList(cx)),
         cloneDataPolicy(cloneDataPolicy) {
@@ -624,6 +708,11 @@ struct JSStructuredCloneWriter {
   bool writePrimitive(HandleValue v);
   bool startWrite(HandleValue v);
   bool traverseObject(HandleObject obj, ESClass cls);
+  bool writeShapedObjectHeader(HandleObject obj, size_t count);
+  bool isShapedObjectOnTop() const {
+    return !shapedObjDepths.empty() &&
+           shapedObjDepths.back() == objs.length() - 1;
+  }
   bool traverseMap(HandleObject obj);
   bool traverseSet(HandleObject obj);
   bool traverseSavedFrame(HandleObject obj);
@@ -656,6 +745,11 @@ struct JSStructuredCloneWriter {
   // counts.length() == objs.length() and sum(counts) == entries.length().
   Vector<size_t> counts;
 
+  // Indices into objs of the objects written with a shape template, innermost
+  // last. Only the property values of these objects are written, since their
+  // keys are given by the template.
+  Vector<size_t> shapedObjDepths;
+
   // For JSObject: Property IDs as value
   RootedIdVector objectEntries;
 
@@ -672,6 +766,12 @@ struct JSStructuredCloneWriter {
                                 StableCellHasher<JSObject*>, SystemAllocPolicy>;
   Rooted<CloneMemory> memory;
 
+  // Shapes of the plain objects written with a shape template, mapped to the
+  // index of their template in the serialized data.
+  using ShapeTemplateMap = GCHashMap<Shape*, uint32_t, StableCellHasher<Shape*>,
+                                     SystemAllocPolicy>;
+  Rooted<ShapeTemplateMap> shapeTemplates;
+
   // Set of transferable objects
   RootedValue transferable;
   using TransferableObjectsList = GCVector<JSObject*>;
@@ -926,6 +1026,19 @@ bool SCInput::readBytes(void* p, size_t nbytes) {
   return readArray((uint8_t*)p, nbytes);
 }
 
+template <typename F>
+bool SCInput::readByteRanges(size_t nbytes, F&& f) {
+  if (!point.hasBytesAvailable(nbytes)) {
+    return reportTruncated();
+  }
+  if (!point.forEachRange(nbytes, std::forward<F>(f))) {
+    return false;
+  }
+
+  point += ComputePadding(nbytes, sizeof(uint8_t));
+  return true;
+}
+
 bool SCInput::readChars(Latin1Char* p, size_t nchars) {
   static_assert(sizeof(Latin1Char) == sizeof(uint8_t),
                 "Latin1Char must fit in 1 byte");
@@ -1694,6 +1807,32 @@ static bool TryAppendNativeProperties(JSContext* cx, HandleObject obj,
 // This nests nicely (ie, an entire recursive value starts with its tag and
 // ends with its end-of-children marker) and so it can be presented indented.
 // But see traverseMap below for how this looks different for Maps.
+//
+// Plain objects with a shared shape and no elements are common when cloning
+// arrays of records, so their keys are only written once per shape. The first
+// such object with a given shape is written as a template with its keys, and
+// later objects with the same shape only refer to the template by index:
+//
+//     arr = [{ x: 1, y: 2 }, { x: 3, y: 4 }]
+//
+// would be stored as:
+//
+//     <Array tag for arr>
+//       <0>
+//       <Shape template tag (2 keys) for arr[0]>
+//         <x> <y>
+//         <1>
+//         <2>
+//       <end-of-children marker for arr[0]>
+//       <1>
+//       <Shaped object tag (template 0) for arr[1]>
+//         <3>
+//         <4>
+//       <end-of-children marker for arr[1]>
+//     <end-of-children marker for arr>
+//
+// A property deleted while the object is being written is stored as a hole
+// marker in place of its value.
 bool JSStructuredCloneWriter::traverseObject(HandleObject obj, ESClass cls) {
   size_t count;
   bool optimized = false;
@@ -1724,10 +1863,19 @@ bool JSStructuredCloneWriter::traverseObject(HandleObject obj, ESClass cls) {
     count = properties.length();
   }
 
+  // Only plain objects whose keys are all taken from their shape can share a
+  // template. Dictionary shapes are never shared, so don't bother with them.
+  bool shaped = optimized && count > 0 && obj->is<PlainObject>() &&
+                !obj->as<PlainObject>().inDictionaryMode() &&
+                obj->as<PlainObject>().getDenseInitializedLength() == 0;
+
   // Push obj and count to the stack.
   if (!objs.append(ObjectValue(*obj)) || !counts.append(count)) {
     return false;
   }
+  if (shaped && !shapedObjDepths.append(objs.length() - 1)) {
+    return false;
+  }
 
   checkStack();
 
@@ -1750,9 +1898,47 @@ bool JSStructuredCloneWriter::traverseObject(HandleObject obj, ESClass cls) {
                          NativeEndian::swapToLittleEndian(length));
   }
 
+  if (shaped) {
+    return writeShapedObjectHeader(obj, count);
+  }
+
   return out.writePair(SCTAG_OBJECT_OBJECT, 0);
 }
 
+bool JSStructuredCloneWriter::writeShapedObjectHeader(HandleObject obj,
+                                                      size_t count) {
+  MOZ_ASSERT(isShapedObjectOnTop());
+
+  Shape* shape = obj->shape();
+  ShapeTemplateMap::AddPtr p = shapeTemplates.lookupForAdd(shape);
+  if (p) {
+    return out.writePair(SCTAG_SHAPED_OBJECT, p->value());
+  }
+
+  if (!shapeTemplates.add(p, shape, shapeTemplates.count())) {
+    ReportOutOfMemory(context());
+    return false;
+  }
+
+  if (!out.writePair(SCTAG_SHAPE_TEMPLATE_OBJECT,
+                     AssertedCast<uint32_t>(count))) {
+    return false;
+  }
+
+  // The keys were pushed onto objectEntries in reverse order.
+  MOZ_ASSERT(objectEntries.length() >= count);
+  for (size_t i = objectEntries.length(); i > objectEntries.length() - count;
+       i--) {
+    jsid id = objectEntries[i - 1];
+    MOZ_ASSERT(id.isAtom());
+    if (!writeString(SCTAG_STRING, id.toAtom())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 // Use the same basic setup as for traverseObject, but now keys can themselves
 // be complex objects. Keys and values are visited first via startWrite(), then
 // the key's children (if any) are handled, then the value's children.
@@ -2516,11 +2702,19 @@ bool JSStructuredCloneWriter::write(HandleValue v) {
         key = IdToValue(id);
         checkStack();
 
+        // Objects written with a shape template omit their keys, and must
+        // write a hole for properties deleted since the template was written.
+        bool shaped = isShapedObjectOnTop();
+
         // If obj still has an own property named id, write it out.
         bool found;
         if (GetOwnPropertyPure(context(), obj, id, val.address(), &found)) {
           if (found) {
-            if (!writePrimitive(key) || !startWrite(val)) {
+            if ((!shaped && !writePrimitive(key)) || !startWrite(val)) {
+              return false;
+            }
+          } else if (shaped) {
+            if (!out.writePair(SCTAG_SHAPED_OBJECT_HOLE, 0)) {
               return false;
             }
           }
@@ -2531,6 +2725,12 @@ bool JSStructuredCloneWriter::write(HandleValue v) {
           return false;
         }
 
+        if (!found && shaped) {
+          if (!out.writePair(SCTAG_SHAPED_OBJECT_HOLE, 0)) {
+            return false;
+          }
+        }
+
         if (found) {
 #if FUZZING_JS_FUZZILLI
           // supress calls into user code
@@ -2540,7 +2740,7 @@ bool JSStructuredCloneWriter::write(HandleValue v) {
           }
 #endif
 
-          if (!writePrimitive(key) ||
+          if ((!shaped && !writePrimitive(key)) ||
               !GetProperty(context(), obj, obj, id, &val) || !startWrite(val)) {
             return false;
           }
@@ -2550,12 +2750,16 @@ bool JSStructuredCloneWriter::write(HandleValue v) {
       if (!out.writePair(SCTAG_END_OF_KEYS, 0)) {
         return false;
       }
+      if (isShapedObjectOnTop()) {
+        shapedObjDepths.popBack();
+      }
       objs.popBack();
       counts.popBack();
     }
   }
 
   memory.clear();
+  shapeTemplates.clear();
   return transferOwnership();
 }
 
@@ -2568,6 +2772,8 @@ JSStructuredCloneReader::JSStructuredCloneReader(
       cloneDataPolicy(cloneDataPolicy),
       objs(in.context()),
       objState(in.context(), in.context()),
+      shapeTemplates(in.context(), in.context()),
+      shapedObjState(in.context(), in.context()),
       allObjs(in.context()),
       numItemsRead(0),
       callbacks(cb),
@@ -2872,16 +3078,20 @@ bool JSStructuredCloneReader::readArrayBuffer(StructuredDataType type,
     return false;
   }
 
+  // The contents are copied in from the clone buffer below, so don't zero them
+  // first. readArrayBufferContents() zeroes them if the copy fails. Resizable
+  // buffers still need their bytes past |nbytes| to be zeroed.
   JSObject* obj;
   if (type == SCTAG_RESIZABLE_ARRAY_BUFFER_OBJECT) {
     obj = ResizableArrayBufferObject::createZeroed(context(), size_t(nbytes),
                                                    size_t(maxbytes));
   } else if (type == SCTAG_IMMUTABLE_ARRAY_BUFFER_OBJECT) {
     MOZ_ASSERT(maxbytes == 0);
-    obj = ImmutableArrayBufferObject::createZeroed(context(), size_t(nbytes));
+    obj = ImmutableArrayBufferObject::createUninitialized(context(),
+                                                          size_t(nbytes));
   } else {
     MOZ_ASSERT(maxbytes == 0);
-    obj = ArrayBufferObject::createZeroed(context(), size_t(nbytes));
+    obj = ArrayBufferObject::createUninitialized(context(), size_t(nbytes));
   }
   if (!obj) {
     return false;
@@ -2889,7 +3099,113 @@ bool JSStructuredCloneReader::readArrayBuffer(StructuredDataType type,
   vp.setObject(*obj);
   ArrayBufferObject& buffer = obj->as<ArrayBufferObject>();
   MOZ_ASSERT(buffer.byteLength() == nbytes);
-  return in.readArray(buffer.dataPointer(), nbytes);
+  return readArrayBufferContents(buffer.dataPointer(), size_t(nbytes));
+}
+
+// ArrayBuffers at least this large have their contents copied on helper
+// threads, split into parts of at least ParallelCopyMinPartBytes.
+static constexpr size_t ParallelCopyMinBytes = 1024 * 1024;
+static constexpr size_t ParallelCopyMinPartBytes = 256 * 1024;
+
+bool JSStructuredCloneReader::readArrayBufferContents(uint8_t* dest,
+                                                      size_t nbytes) {
+  if (nbytes < ParallelCopyMinBytes || inReadCallback ||
+      !CanUseExtraThreads() || !IsHelperThreadStateInitialized()) {
+    return in.readArray(dest, nbytes);
+  }
+
+  // Split the copy between the helper threads. Each part may span several
+  // segments of the clone buffer.
+  size_t partCount =
+      std::max(std::min(nbytes / ParallelCopyMinPartBytes,
+                        HelperThreadState().maxArrayBufferCopyThreads()),
+               size_t(1));
+  size_t partBytes = (nbytes + partCount - 1) / partCount;
+
+  UniquePtr<ArrayBufferCopyTask> task;
+  size_t offset = 0;
+  bool outOfMemory = false;
+  auto addRange = [&](const char* src, size_t length) {
+    while (length) {
+      if (!task) {
+        task = MakeUnique<ArrayBufferCopyTask>();
+        if (!task) {
+          outOfMemory = true;
+          return false;
+        }
+      }
+
+      size_t partEnd = std::min((offset / partBytes + 1) * partBytes, nbytes);
+      size_t n = std::min(length, partEnd - offset);
+      if (!task->addRange(dest + offset, src, n)) {
+        outOfMemory = true;
+        return false;
+      }
+      offset += n;
+      src += n;
+      length -= n;
+
+      if (offset == partEnd) {
+        if (!copyTasks.append(std::move(task))) {
+          outOfMemory = true;
+          return false;
+        }
+        ArrayBufferCopyTask* copy = copyTasks.back().get();
+        AutoLockHelperThreadState lock;
+        if (!HelperThreadState().submitTask(copy, lock)) {
+          {
+            AutoUnlockHelperThreadState unlock(lock);
+            copy->runTask();
+          }
+          copy->done = true;
+        }
+      }
+    }
+    return true;
+  };
+
+  if (!in.readByteRanges(nbytes, addRange)) {
+    // Parts of the buffer may have been copied. To avoid any way in which
+    // uninitialized data could escape, zero all of it once they finish.
+    finishArrayBufferCopies();
+    std::uninitialized_fill_n(dest, nbytes, 0);
+    if (outOfMemory) {
+      ReportOutOfMemory(context());
+    }
+    return false;
+  }
+
+  MOZ_ASSERT(offset == nbytes);
+  MOZ_ASSERT(!task);
+  return true;
+}
+
+void JSStructuredCloneReader::finishArrayBufferCopies() {
+  if (copyTasks.empty()) {
+    return;
+  }
+
+  AutoLockHelperThreadState lock;
+
+  // Take back the tasks which no helper thread has started and copy them
+  // here, then wait for the ones which are running.
+  for (auto& task : copyTasks) {
+    if (HelperThreadState().removePendingArrayBufferCopyTask(task.get(),
+                                                              lock)) {
+      {
+        AutoUnlockHelperThreadState unlock(lock);
+        task->runTask();
+      }
+      task->done = true;
+    }
+  }
+  for (auto& task : copyTasks) {
+    while (!task->done) {
+      HelperThreadState().wait(lock);
+    }
+  }
+
+  copyTasks.clear();
 }
 
 bool JSStructuredCloneReader::readSharedArrayBuffer(StructuredDataType type,
@@ -3057,7 +3373,9 @@ bool JSStructuredCloneReader::readV1ArrayBuffer(uint32_t arrayType,
     return false;
   }
 
-  JSObject* obj = ArrayBufferObject::createZeroed(context(), nbytes.value());
+  // The contents are filled in by readArray() below, as in readArrayBuffer.
+  JSObject* obj =
+      ArrayBufferObject::createUninitialized(context(), nbytes.value());
   if (!obj) {
     return false;
   }
@@ -3245,6 +3563,24 @@ bool JSStructuredCloneReader::startRead(MutableHandleValue vp,
       break;
     }
 
+    case SCTAG_SHAPE_TEMPLATE_OBJECT:
+      if (!readShapeTemplate(data, vp)) {
+        return false;
+      }
+      break;
+
+    case SCTAG_SHAPED_OBJECT:
+      if (!readShapedObject(data, vp)) {
+        return false;
+      }
+      break;
+
+    case SCTAG_SHAPED_OBJECT_HOLE:
+      JS_ReportErrorNumberASCII(context(), GetErrorMessage, nullptr,
+                                JSMSG_SC_BAD_SERIALIZED_DATA,
+                                "unexpected property hole");
+      return false;
+
     case SCTAG_BACK_REFERENCE_OBJECT: {
       if (data >= allObjs.length() || !allObjs[data].isObject()) {
         JS_ReportErrorNumberASCII(context(), GetErrorMessage, nullptr,
@@ -3397,8 +3733,11 @@ bool JSStructuredCloneReader::startRead(MutableHandleValue vp,
       if (!allObjs.append(dummy)) {
         return false;
       }
+      finishArrayBufferCopies();
+      inReadCallback = true;
       JSObject* obj =
           callbacks->read(context(), this, cloneDataPolicy, tag, data, closure);
+      inReadCallback = false;
       if (!obj) {
         return false;
       }
@@ -3968,8 +4307,140 @@ bool JSStructuredCloneReader::readObjectField(HandleObject obj,
   return DefineDataProperty(context(), obj, id, val);
 }
 
+bool JSStructuredCloneReader::readShapeTemplate(uint32_t nkeys,
+                                                MutableHandleValue vp) {
+  // The keys are written as strings directly after the tag, before any of
+  // the object's values.
+  Rooted<IdValueVector> properties(context(), IdValueVector(context()));
+  for (uint32_t i = 0; i < nkeys; i++) {
+    uint32_t tag, data;
+    if (!in.readPair(&tag, &data)) {
+      return false;
+    }
+    if (tag != SCTAG_STRING) {
+      JS_ReportErrorNumberASCII(context(), GetErrorMessage, nullptr,
+                                JSMSG_SC_BAD_SERIALIZED_DATA,
+                                "property key expected");
+      return false;
+    }
+    JSString* str = readString(data, AtomizeStrings);
+    if (!str) {
+      return false;
+    }
+    if (!properties.append(IdValuePair(AtomToId(&str->asAtom())))) {
+      return false;
+    }
+  }
+
+  NewObjectKind kind =
+      gcHeap == gc::Heap::Tenured ? TenuredObject : GenericObject;
+  Rooted<PlainObject*> obj(
+      context(),
+      NewPlainObjectWithMaybeDuplicateKeys(context(), properties, kind));
+  if (!obj) {
+    return false;
+  }
+
+  // The writer only uses templates for objects with one slot per key, so
+  // anything else (duplicate or integer keys) is corrupt or malicious data.
+  SharedShape* shape = ReusablePlainObjectShape(obj, properties);
+  if (!shape) {
+    JS_ReportErrorNumberASCII(context(), GetErrorMessage, nullptr,
+                              JSMSG_SC_BAD_SERIALIZED_DATA,
+                              "invalid shape template");
+    return false;
+  }
+
+  if (!shapeTemplates.append(shape) || !objs.append(ObjectValue(*obj)) ||
+      !shapedObjState.emplaceBack(obj, shape)) {
+    return false;
+  }
+
+  vp.setObject(*obj);
+  return true;
+}
+
+bool JSStructuredCloneReader::readShapedObject(uint32_t index,
+                                               MutableHandleValue vp) {
+  if (index >= shapeTemplates.length()) {
+    JS_ReportErrorNumberASCII(context(), GetErrorMessage, nullptr,
+                              JSMSG_SC_BAD_SERIALIZED_DATA,
+                              "invalid shape template index");
+    return false;
+  }
+
+  // The object is created with all of its properties, with undefined values
+  // until they are read.
+  NewObjectKind kind =
+      gcHeap == gc::Heap::Tenured ? TenuredObject : GenericObject;
+  Rooted<SharedShape*> shape(context(), shapeTemplates[index]);
+  PlainObject* obj = PlainObject::createWithShape(context(), shape, kind);
+  if (!obj || !objs.append(ObjectValue(*obj)) ||
+      !shapedObjState.emplaceBack(obj, shape)) {
+    return false;
+  }
+
+  vp.setObject(*obj);
+  return true;
+}
+
+static jsid ShapeTemplateKey(SharedShape* shape, uint32_t slot) {
+  for (SharedShapePropertyIter<NoGC> iter(shape); !iter.done(); iter++) {
+    if (iter->slot() == slot) {
+      return iter->key();
+    }
+  }
+  MOZ_CRASH("Shape template slot not found");
+}
+
+// Read the value of the next property of an object written with a shape
+// template. |tag| is the tag of the value, which hasn't been consumed yet.
+bool JSStructuredCloneReader::readShapedObjectField(HandleObject obj,
+                                                    uint32_t tag) {
+  // Nested objects read by startRead() push their own state above this one.
+  size_t stateIdx = shapedObjState.length() - 1;
+  MOZ_ASSERT(shapedObjState[stateIdx].obj == obj);
+
+  Rooted<SharedShape*> shape(context(), shapedObjState[stateIdx].shape);
+  uint32_t slot = shapedObjState[stateIdx].nextSlot;
+  if (slot >= shape->slotSpan()) {
+    JS_ReportErrorNumberASCII(context(), GetErrorMessage, nullptr,
+                              JSMSG_SC_BAD_SERIALIZED_DATA,
+                              "too many property values");
+    return false;
+  }
+  shapedObjState[stateIdx].nextSlot++;
+
+  // The property was deleted while the object was being written.
+  if (tag == SCTAG_SHAPED_OBJECT_HOLE) {
+    uint32_t data;
+    MOZ_ALWAYS_TRUE(in.readPair(&tag, &data));
+    RootedId id(context(), ShapeTemplateKey(shape, slot));
+    ObjectOpResult result;
+    return NativeDeleteProperty(context(), obj.as<NativeObject>(), id, result);
+  }
+
+  RootedValue val(context());
+  if (!startRead(&val)) {
+    return false;
+  }
+
+  // Deleting a property for a hole may have changed the object's shape.
+  if (MOZ_LIKELY(obj->shape() == shape)) {
+    obj->as<PlainObject>().setSlot(slot, val);
+    return true;
+  }
+
+  RootedId id(context(), ShapeTemplateKey(shape, slot));
+  return DefineDataProperty(context(), obj, id, val);
+}
+
 // Perform the whole recursive reading procedure.
 bool JSStructuredCloneReader::read(MutableHandleValue vp, size_t nbytes) {
+  // Don't return until the contents of all ArrayBuffers have been copied.
+  auto finishCopies =
+      mozilla::MakeScopeExit([&] { finishArrayBufferCopies(); });
+
   if (!readHeader()) {
     return false;
   }
@@ -4008,6 +4479,16 @@ bool JSStructuredCloneReader::read(MutableHandleValue vp, size_t nbytes) {
       if (objState.back().first == obj) {
         objState.popBack();
       }
+      if (!shapedObjState.empty() && shapedObjState.back().obj == obj) {
+        shapedObjState.popBack();
+      }
+      continue;
+    }
+
+    if (!shapedObjState.empty() && shapedObjState.back().obj == obj) {
+      if (!readShapedObjectField(obj, tag)) {
+        return false;
+      }
       continue;
     }
 
@@ -4092,6 +4573,7 @@ bool JSStructuredCloneReader::read(MutableHandleValue vp, size_t nbytes) {
     }
   }
 
+  finishArrayBufferCopies();
   allObjs.clear();
 
   // For fuzzing, it is convenient to allow extra data at the end
@@ -1201,6 +1201,35 @@ void Code::printStats() const {
     guard->tier2Stats.print();
   }
 
+  // With lazy tiering, functions are only compiled with Ion once their
+  // hotness counter runs out. Report how many never got that far. The function
+  // states are missing if Code::initialize failed early.
+  if (mode() == CompileMode::LazyTiering && funcStates_) {
+    size_t numFuncDefs = codeMeta_->numFuncDefs();
+    size_t numNotRequested = 0;
+    size_t numRequested = 0;
+    for (size_t i = 0; i < numFuncDefs; i++) {
+      TierUpState state = funcStates_[i].tierUpState;
+      switch (state) {
+        case TierUpState::NotRequested:
+          numNotRequested++;
+          break;
+        case TierUpState::Requested:
+          numRequested++;
+          break;
+        case TierUpState::Finished:
+          break;
+      }
+    }
+    JS_LOG(wasmPerf, Info, "            ------ Lazy tier-up ------");
+    JS_LOG(wasmPerf, Info, "    %7zu functions tiered up",
+           numFuncDefs - numNotRequested - numRequested);
+    JS_LOG(wasmPerf, Info, "    %7zu functions requested but not tiered up",
+           numRequested);
+    JS_LOG(wasmPerf, Info, "    %7zu functions never requested (skipped)",
+           numNotRequested);
+  }
+
   JS_LOG(wasmPerf, Info, ">>>>");
 #endif
 }
@@ -955,11 +955,11 @@ static bool DecodeCodeSection(const CodeMetadata& codeMeta, DecoderT& d,
   return mg.finishFuncDefs();
 }
 
-SharedModule wasm::CompileBuffer(const CompileArgs& args,
-                                 const BytecodeBufferOrSource& bytecode,
-                                 UniqueChars* error,
-                                 UniqueCharsVector* warnings,
-                                 JS::OptimizedEncodingListener* listener) {
+static SharedModule CompileBufferImpl(
+    const CompileArgs& args, CompilerEnvironment& compilerEnv,
+    const BytecodeBufferOrSource& bytecode, const Atomic<bool>* cancelled,
+    UniqueChars* error, UniqueCharsVector* warnings,
+    JS::OptimizedEncodingListener* listener) {
   MutableModuleMetadata moduleMeta = js_new<ModuleMetadata>();
   if (!moduleMeta || !moduleMeta->init(args)) {
     return nullptr;
@@ -973,14 +973,13 @@ SharedModule wasm::CompileBuffer(const CompileArgs& args,
     return nullptr;
   }
 
-  CompilerEnvironment compilerEnv(args);
   compilerEnv.computeParameters(*moduleMeta);
   if (!moduleMeta->prepareForCompile(compilerEnv.mode())) {
     return nullptr;
   }
 
   ModuleGenerator mg(*moduleMeta->codeMeta, compilerEnv,
-                     compilerEnv.initialState(), nullptr, error, warnings);
+                     compilerEnv.initialState(), cancelled, error, warnings);
   if (!mg.initializeCompleteTier()) {
     return nullptr;
   }
@@ -1033,6 +1032,27 @@ SharedModule wasm::CompileBuffer(const CompileArgs& args,
   return mg.finishModule(bytecode, *moduleMeta, listener);
 }
 
+SharedModule wasm::CompileBuffer(const CompileArgs& args,
+                                 const BytecodeBufferOrSource& bytecode,
+                                 UniqueChars* error,
+                                 UniqueCharsVector* warnings,
+                                 JS::OptimizedEncodingListener* listener) {
+  CompilerEnvironment compilerEnv(args);
+  return CompileBufferImpl(args, compilerEnv, bytecode, nullptr, error,
+                           warnings, listener);
+}
+
+SharedModule wasm::CompileForOptimizedEncoding(
+    const CompileArgs& args, const BytecodeBufferOrSource& bytecode,
+    const Atomic<bool>* cancelled, UniqueChars* error,
+    UniqueCharsVector* warnings) {
+  MOZ_ASSERT(args.ionEnabled);
+  CompilerEnvironment compilerEnv(CompileMode::Once, Tier::Serialized,
+                                  DebugEnabled::False);
+  return CompileBufferImpl(args, compilerEnv, bytecode, cancelled, error,
+                           warnings, nullptr);
+}
+
 bool wasm::CompileCompleteTier2(const ShareableBytes* codeSection,
                                 const Module& module, UniqueChars* error,
                                 UniqueCharsVector* warnings,
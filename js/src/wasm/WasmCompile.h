@@ -53,6 +53,17 @@ SharedModule CompileBuffer(const CompileArgs& args,
                            UniqueChars* error, UniqueCharsVector* warnings,
                            JS::OptimizedEncodingListener* listener = nullptr);
 
+// Compile the given WebAssembly bytecode with only the optimizing tier, so
+// that the resulting Module can be serialized. This is used to produce an
+// optimized encoding for a JS::OptimizedEncodingListener when the Module that
+// runs was compiled with lazy tiering, which can't be serialized. Returns null
+// without setting *error if `cancelled` becomes true.
+
+SharedModule CompileForOptimizedEncoding(
+    const CompileArgs& args, const BytecodeBufferOrSource& bytecode,
+    const mozilla::Atomic<bool>* cancelled, UniqueChars* error,
+    UniqueCharsVector* warnings);
+
 // Attempt to compile the second tier of the given wasm::Module.
 
 bool CompileCompleteTier2(const ShareableBytes* codeSection,
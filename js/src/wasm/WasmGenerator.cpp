@@ -1456,6 +1456,15 @@ SharedModule ModuleGenerator::finishModule(
       maybeCompleteTier2Listener->storeOptimizedEncoding(bytes.begin(),
                                                          bytes.length());
     }
+  } else if (mode() == CompileMode::LazyTiering && maybeCompleteTier2Listener) {
+    // Lazy tiering never produces a complete optimized tier to serialize, so
+    // compile one in the background just for the cache. The next load will
+    // deserialize it and skip both tiers.
+    BytecodeBuffer bytecodeBuffer;
+    if (bytecode.getOrCreateBuffer(&bytecodeBuffer)) {
+      module->startOptimizedEncoding(bytecodeBuffer,
+                                     maybeCompleteTier2Listener);
+    }
   }
 
 #ifdef JS_JITSPEW
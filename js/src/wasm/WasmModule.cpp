@@ -152,6 +152,61 @@ class Module::CompleteTier2GeneratorTaskImpl
   }
 };
 
+// Compiles a lazily tiered module again with only the optimizing tier and
+// stores the result with the listener. This shares the complete tier-2
+// generator worklist, so that it is cancelled at shutdown in the same way.
+class Module::OptimizedEncodingTaskImpl : public CompleteTier2GeneratorTask {
+  SharedCompileArgs compileArgs_;
+  BytecodeBuffer bytecode_;
+  CompleteTier2Listener listener_;
+  mozilla::Atomic<bool> cancelled_;
+
+ public:
+  OptimizedEncodingTaskImpl(const CompileArgs& compileArgs,
+                            const BytecodeBuffer& bytecode,
+                            JS::OptimizedEncodingListener* listener)
+      : compileArgs_(&compileArgs),
+        bytecode_(bytecode),
+        listener_(listener),
+        cancelled_(false) {}
+
+  void cancel() override { cancelled_ = true; }
+
+  void runHelperThreadTask(AutoLockHelperThreadState& locked) override {
+    {
+      AutoUnlockHelperThreadState unlock(locked);
+
+      UniqueChars error;
+      UniqueCharsVector warnings;
+      SharedModule module = CompileForOptimizedEncoding(
+          *compileArgs_, BytecodeBufferOrSource(bytecode_), &cancelled_,
+          &error, &warnings);
+      if (module && module->canSerialize()) {
+        Bytes bytes;
+        if (module->serialize(&bytes)) {
+          listener_->storeOptimizedEncoding(bytes.begin(), bytes.length());
+        }
+      }
+      if (!cancelled_) {
+        ReportTier2ResultsOffThread(cancelled_, !!module, mozilla::Nothing(),
+                                    compileArgs_->scriptedCaller, error,
+                                    warnings);
+      }
+    }
+
+    HelperThreadState().incWasmCompleteTier2GeneratorsFinished(locked);
+
+    // The task is finished, release it.
+    js_delete(this);
+  }
+
+  const char* getName() override { return "OptimizedEncodingTask"; }
+
+  ThreadType threadType() override {
+    return ThreadType::THREAD_TYPE_WASM_GENERATOR_COMPLETE_TIER2;
+  }
+};
+
 Module::~Module() {
   // Note: Modules can be destroyed on any thread.
   MOZ_ASSERT(!completeTier2Listener_);
@@ -176,6 +231,21 @@ void Module::startTier2(const ShareableBytes* codeSection,
   StartOffThreadWasmCompleteTier2Generator(std::move(task));
 }
 
+void Module::startOptimizedEncoding(
+    const BytecodeBuffer& bytecode,
+    JS::OptimizedEncodingListener* listener) const {
+  MOZ_ASSERT(code_->mode() == CompileMode::LazyTiering);
+  MOZ_ASSERT(listener);
+
+  auto task = MakeUnique<OptimizedEncodingTaskImpl>(*codeMeta().compileArgs,
+                                                    bytecode, listener);
+  if (!task) {
+    return;
+  }
+
+  StartOffThreadWasmCompleteTier2Generator(std::move(task));
+}
+
 bool Module::finishTier2(UniqueCodeBlock tier2CodeBlock,
                          UniqueLinkData tier2LinkData,
                          const CompileAndLinkStats& tier2Stats) const {
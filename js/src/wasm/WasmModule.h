@@ -139,6 +139,7 @@ class Module : public JS::WasmModule {
                           WasmGlobalObjectVector& globalObjs) const;
 
   class CompleteTier2GeneratorTaskImpl;
+  class OptimizedEncodingTaskImpl;
 
  public:
   class PartialTier2CompileTaskImpl;
@@ -181,6 +182,14 @@ class Module : public JS::WasmModule {
   bool finishTier2(UniqueCodeBlock tier2CodeBlock, UniqueLinkData tier2LinkData,
                    const CompileAndLinkStats& tier2Stats) const;
 
+  // Lazily tiered code can't be serialized. Instead, when the embedding wants
+  // an optimized encoding, the module is compiled again with only the
+  // optimizing tier on a helper thread and that is serialized for `listener`.
+  // The code of this Module is not affected.
+
+  void startOptimizedEncoding(const BytecodeBuffer& bytecode,
+                              JS::OptimizedEncodingListener* listener) const;
+
   void testingBlockOnTier2Complete() const;
   bool testingTier2Active() const { return testingTier2Active_; }
 
@@ -96,8 +96,11 @@ FileDescriptor AutoMemMap::cloneHandle() const { return cloneFileDescriptor(); }
 void AutoMemMap::reset() {
   if (addr && !persistent_) {
     (void)NS_WARN_IF(PR_MemUnmap(addr, size()) != PR_SUCCESS);
-    addr = nullptr;
   }
+  // A persistent mapping is left in place, but is no longer owned by this
+  // instance.
+  addr = nullptr;
+  persistent_ = false;
   if (fileMap) {
     (void)NS_WARN_IF(PR_CloseFileMap(fileMap) != PR_SUCCESS);
     fileMap = nullptr;
@@ -60,7 +60,7 @@ class AutoMemMap {
   FileDescriptor cloneHandle() const;
 
   // Makes this mapping persistent. After calling this, the mapped memory
-  // will remained mapped, even after this instance is destroyed.
+  // will remained mapped, even after this instance is destroyed or reset.
   void setPersistent() { persistent_ = true; }
 
  private:
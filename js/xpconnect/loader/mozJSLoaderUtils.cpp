@@ -14,6 +14,7 @@
 
 #include "mozilla/BasePrincipal.h"
 #include "mozilla/Span.h"
+#include "mozilla/StaticPrefs_javascript.h"
 
 using namespace JS;
 using namespace mozilla::scache;
@@ -41,15 +42,32 @@ nsresult ReadCachedStencil(StartupCache* cache, nsACString& cachePath,
   MOZ_ASSERT(options.borrowBuffer);
   MOZ_ASSERT(!options.usePinnedBytecode);
 
+  // Borrowing the buffer from the mapping of the cache file avoids a copy,
+  // but any I/O error on the file then crashes wherever the bytecode is read.
   const char* buf;
   uint32_t len;
-  nsresult rv =
-      cache->GetBuffer(PromiseFlatCString(cachePath).get(), &buf, &len);
+  bool mapped = false;
+  bool borrow =
+      mozilla::StaticPrefs::javascript_options_startup_cache_pinned_bytecode();
+  nsresult rv = cache->GetBuffer(PromiseFlatCString(cachePath).get(), &buf,
+                                 &len, borrow ? &mapped : nullptr);
   if (NS_FAILED(rv)) {
     return rv;  // don't warn since NOT_AVAILABLE is an ok error
   }
 
   JS::TranscodeRange range(AsBytes(mozilla::Span(buf, len)));
+
+  if (mapped) {
+    // The buffer lives in the mapping of the cache file, which is kept until
+    // the process exits, so the bytecode can be used in place instead of
+    // being copied out of the buffer.
+    JS::DecodeOptions pinnedOptions(options);
+    pinnedOptions.usePinnedBytecode = true;
+    JS::TranscodeResult code =
+        JS::DecodeStencil(cx, pinnedOptions, range, stencilOut);
+    return HandleTranscodeResult(cx, code);
+  }
+
   JS::TranscodeResult code = JS::DecodeStencil(cx, options, range, stencilOut);
   return HandleTranscodeResult(cx, code);
 }
@@ -67,10 +85,17 @@ nsresult WriteCachedStencil(StartupCache* cache, nsACString& cachePath,
     return NS_ERROR_FAILURE;
   }
 
+  // Uncompressed entries only pay off when ReadCachedStencil borrows them
+  // from the mapping, otherwise keep the smaller compressed file.
+  StartupCache::Storage storage =
+      mozilla::StaticPrefs::javascript_options_startup_cache_pinned_bytecode()
+          ? StartupCache::Storage::Mapped
+          : StartupCache::Storage::Compressed;
+
   // Move the vector buffer into a unique pointer buffer.
   mozilla::UniqueFreePtr<char[]> buf(
       reinterpret_cast<char*>(buffer.extractOrCopyRawBuffer()));
   nsresult rv = cache->PutBuffer(PromiseFlatCString(cachePath).get(),
-                                 std::move(buf), size);
+                                 std::move(buf), size, storage);
   return rv;
 }
@@ -1938,6 +1938,16 @@ void ReportJSRuntimeExplicitTreeStats(const JS::RuntimeStats& rtStats,
                 rtStats.runtime.uncompressedSourceCache,
                 "The uncompressed source code cache.");
 
+  RREPORT_BYTES(rtPath + "runtime/regexp-bytecode-cache"_ns, KIND_HEAP,
+                rtStats.runtime.regExpBytecodeCache,
+                "Copies of compiled regular expression bytecode kept for reuse "
+                "by new RegExp objects with the same source and flags.");
+
+  RREPORT_BYTES(rtPath + "runtime/lifo-chunk-cache"_ns, KIND_HEAP,
+                rtStats.runtime.lifoChunkCache,
+                "Freed LifoAlloc chunks kept for reuse by later parses and "
+                "compilations, shared across all JSRuntimes.");
+
   RREPORT_BYTES(rtPath + "runtime/script-data"_ns, KIND_HEAP,
                 rtStats.runtime.scriptData,
                 "The table holding script data shared in the runtime.");
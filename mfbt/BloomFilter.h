@@ -135,6 +135,15 @@ class BitBloomFilter {
   void add(uint32_t aHash);
   bool mightContain(uint32_t aHash) const;
 
+  /*
+   * Raw access to the bit array, e.g. for persisting the filter.  Merging a
+   * saved bit array back in with |unionWith| keeps the guarantee that items
+   * added to either filter are never reported as missing.
+   */
+  static constexpr size_t rawLength() { return kArraySize; }
+  const uint8_t* rawBits() const { return mBits; }
+  void unionWith(const uint8_t* aBits);
+
  private:
   static const size_t kArraySize = (1 << (KeySize - 3));
   static const uint32_t kKeyMask = (1 << KeySize) - 1;
@@ -173,6 +182,13 @@ inline void BitBloomFilter<KeySize, T>::clear() {
   memset(mBits, 0, kArraySize);
 }
 
+template <unsigned KeySize, class T>
+inline void BitBloomFilter<KeySize, T>::unionWith(const uint8_t* aBits) {
+  for (size_t i = 0; i < kArraySize; i++) {
+    mBits[i] |= aBits[i];
+  }
+}
+
 template <unsigned KeySize, class T>
 inline void BitBloomFilter<KeySize, T>::add(uint32_t aHash) {
   setFirstSlot(aHash);
@@ -575,6 +575,109 @@ void TestGauntlet2x16() {
   }
 }
 
+void TestTwoOrBelow8() {
+  const char* test = "0123456789abcdefghijklmnopqrstuvwxyz\"\\\n";
+  const size_t length = 39;
+
+  MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(test, '"', '\\', 0x20, 0) ==
+                     nullptr);
+  MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(test, '"', '\\', 0x20, 36) ==
+                     nullptr);
+  MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(test, '"', '\\', 0x20, length) ==
+                     test + 36);
+  MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(test + 37, '"', '\\', 0x20, 2) ==
+                     test + 37);
+  MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(test + 38, '"', '\\', 0x20, 1) ==
+                     test + 38);
+  MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(test, '"', '\\', '1', length) ==
+                     test);
+
+  // Values above 0x7f are not below the limit.
+  const size_t count = 256;
+  char high[count];
+  for (size_t i = 0; i < count; ++i) {
+    high[i] = static_cast<char>(0x80 + (i % 0x80));
+  }
+  MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(high, '"', '\\', 0x20, count) ==
+                     nullptr);
+
+  for (size_t i = 0; i < count; ++i) {
+    char buffer[count];
+    for (size_t k = 0; k < count; ++k) {
+      buffer[k] = 'a';
+    }
+    for (size_t j = 0; j < 3; ++j) {
+      buffer[i] = "\"\\\x1f"[j];
+      MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(buffer, '"', '\\', 0x20,
+                                               count) == buffer + i);
+      MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow8(buffer, '"', '\\', 0x20, i) ==
+                         nullptr);
+    }
+  }
+}
+
+void TestTwoOrBelow16() {
+  const size_t count = 256;
+  for (size_t i = 0; i < count; ++i) {
+    char16_t buffer[count];
+    for (size_t k = 0; k < count; ++k) {
+      buffer[k] = static_cast<char16_t>(0x100 + k);
+    }
+    for (size_t j = 0; j < 3; ++j) {
+      buffer[i] = u"\"\\\x1f"[j];
+      MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow16(buffer, u'"', u'\\', 0x20,
+                                                count) == buffer + i);
+      MOZ_RELEASE_ASSERT(SIMD::memchr2OrBelow16(buffer, u'"', u'\\', 0x20,
+                                                i) == nullptr);
+    }
+  }
+}
+
+void TestSpaced8() {
+  const char* test = "abcdefghijklmnopqrstuvwxyz0123456789";
+  const size_t length = 36;
+
+  MOZ_RELEASE_ASSERT(SIMD::memchrSpaced8(test, 'a', 'c', 2, 0) == nullptr);
+  MOZ_RELEASE_ASSERT(SIMD::memchrSpaced8(test, 'a', 'c', 2, 1) == test);
+  MOZ_RELEASE_ASSERT(SIMD::memchrSpaced8(test, 'a', 'd', 2, length - 2) ==
+                     nullptr);
+  MOZ_RELEASE_ASSERT(SIMD::memchrSpaced8(test, 'x', '9', 12, length - 12) ==
+                     test + 23);
+  MOZ_RELEASE_ASSERT(SIMD::memchrSpaced8(test, 'x', '9', 12, 23) == nullptr);
+
+  // Every position, with the first character repeated so that it only
+  // matches where the last character matches too.
+  const size_t count = 256;
+  const size_t distance = 20;
+  for (size_t i = 0; i < count; ++i) {
+    char buffer[count + distance];
+    for (size_t k = 0; k < count + distance; ++k) {
+      buffer[k] = 'a';
+    }
+    buffer[i + distance] = 'b';
+    MOZ_RELEASE_ASSERT(SIMD::memchrSpaced8(buffer, 'a', 'b', distance,
+                                           count) == buffer + i);
+    MOZ_RELEASE_ASSERT(SIMD::memchrSpaced8(buffer, 'a', 'b', distance, i) ==
+                       nullptr);
+  }
+}
+
+void TestSpaced16() {
+  const size_t count = 256;
+  const size_t distance = 7;
+  for (size_t i = 0; i < count; ++i) {
+    char16_t buffer[count + distance];
+    for (size_t k = 0; k < count + distance; ++k) {
+      buffer[k] = 0x263a;
+    }
+    buffer[i + distance] = 0x263b;
+    MOZ_RELEASE_ASSERT(SIMD::memchrSpaced16(buffer, 0x263a, 0x263b, distance,
+                                            count) == buffer + i);
+    MOZ_RELEASE_ASSERT(SIMD::memchrSpaced16(buffer, 0x263a, 0x263b, distance,
+                                            i) == nullptr);
+  }
+}
+
 void TestSpecialCases() {
   // The following 4 asserts test the case where we do two overlapping checks,
   // where the first one ends with our first search character, and the second
@@ -620,6 +723,12 @@ int main(void) {
   TestMediumString2x16();
   TestLongString2x16();
 
+  TestTwoOrBelow8();
+  TestTwoOrBelow16();
+
+  TestSpaced8();
+  TestSpaced16();
+
   TestSpecialCases();
 
   // These are too slow to run all the time, but they should be run when making
@@ -6,6 +6,7 @@
 
 #include "mozilla/SIMD.h"
 
+#include <algorithm>
 #include <cstring>
 #include <stdint.h>
 #include <type_traits>
@@ -34,6 +35,33 @@ const TValue* FindInBufferNaive(const TValue* ptr, TValue value,
   return nullptr;
 }
 
+template <typename TValue>
+const TValue* FindTwoOrBelowInBufferNaive(const TValue* ptr, TValue v1,
+                                          TValue v2, TValue limit,
+                                          size_t length) {
+  const TValue* end = ptr + length;
+  while (ptr < end) {
+    if (*ptr == v1 || *ptr == v2 || *ptr < limit) {
+      return ptr;
+    }
+    ptr++;
+  }
+  return nullptr;
+}
+
+template <typename TValue>
+const TValue* FindSpacedInBufferNaive(const TValue* ptr, TValue v1, TValue v2,
+                                      size_t distance, size_t length) {
+  const TValue* end = ptr + length;
+  while (ptr < end) {
+    if (*ptr == v1 && ptr[distance] == v2) {
+      return ptr;
+    }
+    ptr++;
+  }
+  return nullptr;
+}
+
 #ifdef MOZILLA_PRESUME_SSE2
 
 const __m128i* Cast128(uintptr_t ptr) {
@@ -317,6 +345,112 @@ const TValue* FindInBuffer(const TValue* ptr, TValue value, size_t length) {
   return Check4x16Bytes<TValue>(needle, a, b, c, d);
 }
 
+template <typename TValue>
+__m128i Splat128(TValue value) {
+  static_assert(sizeof(TValue) == 1 || sizeof(TValue) == 2);
+  if (sizeof(TValue) == 1) {
+    return _mm_set1_epi8(static_cast<char>(value));
+  }
+  return _mm_set1_epi16(static_cast<short>(value));
+}
+
+template <typename TValue>
+__m128i SubsSaturated128(__m128i a, __m128i b) {
+  static_assert(sizeof(TValue) == 1 || sizeof(TValue) == 2);
+  if (sizeof(TValue) == 1) {
+    return _mm_subs_epu8(a, b);
+  }
+  return _mm_subs_epu16(a, b);
+}
+
+// Return the movemask of the elements of the 16 bytes at `a` which are equal
+// to needle1 or needle2, or which are less than or equal to maxBelow. SSE2 has
+// no unsigned comparison, but an unsigned saturated subtraction yields zero
+// exactly for the elements which are less than or equal to maxBelow.
+template <typename TValue>
+int CheckTwoOrBelow16Bytes(__m128i needle1, __m128i needle2, __m128i maxBelow,
+                           uintptr_t a) {
+  __m128i haystack = _mm_loadu_si128(Cast128(a));
+  __m128i cmp1 = CmpEq128<TValue>(needle1, haystack);
+  __m128i cmp2 = CmpEq128<TValue>(needle2, haystack);
+  __m128i cmpBelow = CmpEq128<TValue>(
+      SubsSaturated128<TValue>(haystack, maxBelow), _mm_setzero_si128());
+  return _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(cmp1, cmp2), cmpBelow));
+}
+
+template <typename TValue>
+const TValue* FindTwoOrBelowInBuffer(const TValue* ptr, TValue v1, TValue v2,
+                                     TValue limit, size_t length) {
+  static_assert(sizeof(TValue) == 1 || sizeof(TValue) == 2);
+  static_assert(std::is_unsigned<TValue>::value);
+  MOZ_ASSERT(limit > 0);
+
+  size_t numBytes = length * sizeof(TValue);
+  if (numBytes < 16) {
+    return FindTwoOrBelowInBufferNaive<TValue>(ptr, v1, v2, limit, length);
+  }
+
+  __m128i needle1 = Splat128<TValue>(v1);
+  __m128i needle2 = Splat128<TValue>(v2);
+  __m128i maxBelow = Splat128<TValue>(limit - 1);
+
+  uintptr_t cur = reinterpret_cast<uintptr_t>(ptr);
+  uintptr_t tailPtr = cur + numBytes - 16;
+
+  // The match is expected to be close to the start of the buffer, e.g. at the
+  // end of a short string literal, thus we check one chunk at a time instead
+  // of aligning and unrolling as FindInBuffer does. The last chunk overlaps
+  // with the previous one, which is fine as we know it had no match.
+  while (true) {
+    int cmpMask = CheckTwoOrBelow16Bytes<TValue>(needle1, needle2, maxBelow,
+                                                 cur);
+    if (cmpMask) {
+      return reinterpret_cast<const TValue*>(cur + __builtin_ctz(cmpMask));
+    }
+    if (cur == tailPtr) {
+      return nullptr;
+    }
+    cur = std::min(cur + 16, tailPtr);
+  }
+}
+
+template <typename TValue>
+const TValue* FindSpacedInBuffer(const TValue* ptr, TValue v1, TValue v2,
+                                 size_t distance, size_t length) {
+  static_assert(sizeof(TValue) == 1 || sizeof(TValue) == 2);
+  static_assert(std::is_unsigned<TValue>::value);
+
+  size_t numBytes = length * sizeof(TValue);
+  if (numBytes < 16) {
+    return FindSpacedInBufferNaive<TValue>(ptr, v1, v2, distance, length);
+  }
+
+  __m128i needle1 = Splat128<TValue>(v1);
+  __m128i needle2 = Splat128<TValue>(v2);
+
+  uintptr_t cur = reinterpret_cast<uintptr_t>(ptr);
+  uintptr_t tailPtr = cur + numBytes - 16;
+  size_t distanceBytes = distance * sizeof(TValue);
+
+  // Compare each chunk against `v1` and the chunk `distance` elements later
+  // against `v2`. As in FindTwoOrBelowInBuffer the last chunk overlaps with
+  // the previous one, which had no match.
+  while (true) {
+    __m128i first = _mm_loadu_si128(Cast128(cur));
+    __m128i last = _mm_loadu_si128(Cast128(cur + distanceBytes));
+    int cmpMask = _mm_movemask_epi8(
+        _mm_and_si128(CmpEq128<TValue>(needle1, first),
+                      CmpEq128<TValue>(needle2, last)));
+    if (cmpMask) {
+      return reinterpret_cast<const TValue*>(cur + __builtin_ctz(cmpMask));
+    }
+    if (cur == tailPtr) {
+      return nullptr;
+    }
+    cur = std::min(cur + 16, tailPtr);
+  }
+}
+
 template <typename TValue>
 const TValue* TwoElementLoop(uintptr_t start, uintptr_t end, TValue v1,
                              TValue v2) {
@@ -510,6 +644,42 @@ const char16_t* SIMD::memchr2x16(const char16_t* ptr, char16_t v1, char16_t v2,
   return FindTwoInBuffer<char16_t>(ptr, v1, v2, length);
 }
 
+const char* SIMD::memchrSpaced8(const char* ptr, char v1, char v2,
+                                size_t distance, size_t length) {
+  const unsigned char* uptr = reinterpret_cast<const unsigned char*>(ptr);
+  const unsigned char* uresult = FindSpacedInBuffer<unsigned char>(
+      uptr, static_cast<unsigned char>(v1), static_cast<unsigned char>(v2),
+      distance, length);
+  return reinterpret_cast<const char*>(uresult);
+}
+
+const char16_t* SIMD::memchrSpaced16(const char16_t* ptr, char16_t v1,
+                                     char16_t v2, size_t distance,
+                                     size_t length) {
+  return FindSpacedInBuffer<char16_t>(ptr, v1, v2, distance, length);
+}
+
+const char* SIMD::memchr2OrBelow8(const char* ptr, char v1, char v2,
+                                  char limit, size_t length) {
+  if (SupportsAVX2()) {
+    return memchr2OrBelow8AVX2(ptr, v1, v2, limit, length);
+  }
+  const unsigned char* uptr = reinterpret_cast<const unsigned char*>(ptr);
+  const unsigned char* uresult = FindTwoOrBelowInBuffer<unsigned char>(
+      uptr, static_cast<unsigned char>(v1), static_cast<unsigned char>(v2),
+      static_cast<unsigned char>(limit), length);
+  return reinterpret_cast<const char*>(uresult);
+}
+
+const char16_t* SIMD::memchr2OrBelow16(const char16_t* ptr, char16_t v1,
+                                       char16_t v2, char16_t limit,
+                                       size_t length) {
+  if (SupportsAVX2()) {
+    return memchr2OrBelow16AVX2(ptr, v1, v2, limit, length);
+  }
+  return FindTwoOrBelowInBuffer<char16_t>(ptr, v1, v2, limit, length);
+}
+
 #else
 
 const char* SIMD::memchr8(const char* ptr, char value, size_t length) {
@@ -573,6 +743,36 @@ const char16_t* SIMD::memchr2x16(const char16_t* ptr, char16_t v1, char16_t v2,
   return nullptr;
 }
 
+const char* SIMD::memchrSpaced8(const char* ptr, char v1, char v2,
+                                size_t distance, size_t length) {
+  const unsigned char* uptr = reinterpret_cast<const unsigned char*>(ptr);
+  const unsigned char* uresult = FindSpacedInBufferNaive<unsigned char>(
+      uptr, static_cast<unsigned char>(v1), static_cast<unsigned char>(v2),
+      distance, length);
+  return reinterpret_cast<const char*>(uresult);
+}
+
+const char16_t* SIMD::memchrSpaced16(const char16_t* ptr, char16_t v1,
+                                     char16_t v2, size_t distance,
+                                     size_t length) {
+  return FindSpacedInBufferNaive<char16_t>(ptr, v1, v2, distance, length);
+}
+
+const char* SIMD::memchr2OrBelow8(const char* ptr, char v1, char v2,
+                                  char limit, size_t length) {
+  const unsigned char* uptr = reinterpret_cast<const unsigned char*>(ptr);
+  const unsigned char* uresult = FindTwoOrBelowInBufferNaive<unsigned char>(
+      uptr, static_cast<unsigned char>(v1), static_cast<unsigned char>(v2),
+      static_cast<unsigned char>(limit), length);
+  return reinterpret_cast<const char*>(uresult);
+}
+
+const char16_t* SIMD::memchr2OrBelow16(const char16_t* ptr, char16_t v1,
+                                       char16_t v2, char16_t limit,
+                                       size_t length) {
+  return FindTwoOrBelowInBufferNaive<char16_t>(ptr, v1, v2, limit, length);
+}
+
 #endif
 
 }  // namespace mozilla
@@ -83,6 +83,54 @@ class SIMD {
   // `v1`.
   static MFBT_API const char16_t* memchr2x16(const char16_t* ptr, char16_t v1,
                                              char16_t v2, size_t length);
+
+  // Search through `ptr[0..length]` for the first occurrence of `v1` which is
+  // followed `distance` elements later by `v2` and return the pointer to the
+  // occurrence of `v1`. Note that unlike memchr2x8, `length` only counts the
+  // possible positions of `v1`: `ptr[0..length + distance]` must be readable.
+  //
+  // Substring search uses this to find candidates whose first and last
+  // characters both match the pattern, which rejects far more false
+  // positives than matching the first two characters.
+  static MFBT_API const char* memchrSpaced8(const char* ptr, char v1, char v2,
+                                            size_t distance, size_t length);
+
+  // Search through `ptr[0..length]` for the first occurrence of `v1` which is
+  // followed `distance` elements later by `v2` and return the pointer to the
+  // occurrence of `v1`. `ptr[0..length + distance]` must be readable.
+  static MFBT_API const char16_t* memchrSpaced16(const char16_t* ptr,
+                                                 char16_t v1, char16_t v2,
+                                                 size_t distance,
+                                                 size_t length);
+
+  // Search through `ptr[0..length]` for the first element which is equal to
+  // `v1` or `v2`, or which is less than `limit` when compared as unsigned, and
+  // return the pointer to it, or nullptr if it cannot be found. `limit` must
+  // not be zero.
+  //
+  // This finds the end of the run of characters which can be copied verbatim
+  // out of a quoted string literal, e.g. with `"`, `\` and 0x20 as arguments.
+  static MFBT_API const char* memchr2OrBelow8(const char* ptr, char v1, char v2,
+                                              char limit, size_t length);
+
+  // This function just restricts our execution to the AVX2 path
+  static MFBT_API const char* memchr2OrBelow8AVX2(const char* ptr, char v1,
+                                                  char v2, char limit,
+                                                  size_t length);
+
+  // Search through `ptr[0..length]` for the first element which is equal to
+  // `v1` or `v2`, or which is less than `limit`, and return the pointer to it,
+  // or nullptr if it cannot be found. `limit` must not be zero.
+  static MFBT_API const char16_t* memchr2OrBelow16(const char16_t* ptr,
+                                                   char16_t v1, char16_t v2,
+                                                   char16_t limit,
+                                                   size_t length);
+
+  // This function just restricts our execution to the AVX2 path
+  static MFBT_API const char16_t* memchr2OrBelow16AVX2(const char16_t* ptr,
+                                                       char16_t v1, char16_t v2,
+                                                       char16_t limit,
+                                                       size_t length);
 };
 
 }  // namespace mozilla
@@ -13,6 +13,7 @@
 // support AVX2, as this should be quite a minority.
 #if defined(MOZILLA_MAY_SUPPORT_AVX2) && defined(__x86_64__)
 
+#  include <algorithm>
 #  include <cstring>
 #  include <immintrin.h>
 #  include <stdint.h>
@@ -254,6 +255,79 @@ const TValue* FindInBufferAVX2(const TValue* ptr, TValue value, size_t length) {
   return Check4x32Bytes<TValue>(needle, a, b, c, d);
 }
 
+template <typename TValue>
+__m256i Splat256(TValue value) {
+  static_assert(sizeof(TValue) == 1 || sizeof(TValue) == 2);
+  if (sizeof(TValue) == 1) {
+    return _mm256_set1_epi8(static_cast<char>(value));
+  }
+  return _mm256_set1_epi16(static_cast<short>(value));
+}
+
+template <typename TValue>
+__m256i SubsSaturated256(__m256i a, __m256i b) {
+  static_assert(sizeof(TValue) == 1 || sizeof(TValue) == 2);
+  if (sizeof(TValue) == 1) {
+    return _mm256_subs_epu8(a, b);
+  }
+  return _mm256_subs_epu16(a, b);
+}
+
+// See CheckTwoOrBelow16Bytes in SIMD.cpp.
+template <typename TValue>
+int CheckTwoOrBelow32Bytes(__m256i needle1, __m256i needle2, __m256i maxBelow,
+                           uintptr_t a) {
+  __m256i haystack = _mm256_loadu_si256(Cast256(a));
+  __m256i cmp1 = CmpEq256<TValue>(needle1, haystack);
+  __m256i cmp2 = CmpEq256<TValue>(needle2, haystack);
+  __m256i cmpBelow = CmpEq256<TValue>(
+      SubsSaturated256<TValue>(haystack, maxBelow), _mm256_setzero_si256());
+  return _mm256_movemask_epi8(
+      _mm256_or_si256(_mm256_or_si256(cmp1, cmp2), cmpBelow));
+}
+
+template <typename TValue>
+const TValue* FindTwoOrBelowInBufferAVX2(const TValue* ptr, TValue v1,
+                                         TValue v2, TValue limit,
+                                         size_t length) {
+  static_assert(sizeof(TValue) == 1 || sizeof(TValue) == 2);
+  static_assert(std::is_unsigned<TValue>::value);
+  MOZ_ASSERT(limit > 0);
+
+  size_t numBytes = length * sizeof(TValue);
+  uintptr_t cur = reinterpret_cast<uintptr_t>(ptr);
+  uintptr_t end = cur + numBytes;
+
+  if (numBytes < 32) {
+    while (cur < end) {
+      TValue value = GetAs<TValue>(cur);
+      if (value == v1 || value == v2 || value < limit) {
+        return reinterpret_cast<const TValue*>(cur);
+      }
+      cur += sizeof(TValue);
+    }
+    return nullptr;
+  }
+
+  __m256i needle1 = Splat256<TValue>(v1);
+  __m256i needle2 = Splat256<TValue>(v2);
+  __m256i maxBelow = Splat256<TValue>(limit - 1);
+
+  // See FindTwoOrBelowInBuffer in SIMD.cpp for why this is not unrolled.
+  uintptr_t tailPtr = end - 32;
+  while (true) {
+    int cmpMask = CheckTwoOrBelow32Bytes<TValue>(needle1, needle2, maxBelow,
+                                                 cur);
+    if (cmpMask) {
+      return reinterpret_cast<const TValue*>(cur + __builtin_ctz(cmpMask));
+    }
+    if (cur == tailPtr) {
+      return nullptr;
+    }
+    cur = std::min(cur + 32, tailPtr);
+  }
+}
+
 const char* SIMD::memchr8AVX2(const char* ptr, char value, size_t length) {
   const unsigned char* uptr = reinterpret_cast<const unsigned char*>(ptr);
   unsigned char uvalue = static_cast<unsigned char>(value);
@@ -277,6 +351,21 @@ const uint64_t* SIMD::memchr64AVX2(const uint64_t* ptr, uint64_t value,
   return FindInBufferAVX2<uint64_t>(ptr, value, length);
 }
 
+const char* SIMD::memchr2OrBelow8AVX2(const char* ptr, char v1, char v2,
+                                      char limit, size_t length) {
+  const unsigned char* uptr = reinterpret_cast<const unsigned char*>(ptr);
+  const unsigned char* uresult = FindTwoOrBelowInBufferAVX2<unsigned char>(
+      uptr, static_cast<unsigned char>(v1), static_cast<unsigned char>(v2),
+      static_cast<unsigned char>(limit), length);
+  return reinterpret_cast<const char*>(uresult);
+}
+
+const char16_t* SIMD::memchr2OrBelow16AVX2(const char16_t* ptr, char16_t v1,
+                                           char16_t v2, char16_t limit,
+                                           size_t length) {
+  return FindTwoOrBelowInBufferAVX2<char16_t>(ptr, v1, v2, limit, length);
+}
+
 }  // namespace mozilla
 
 #else
@@ -302,6 +391,17 @@ const uint64_t* SIMD::memchr64AVX2(const uint64_t* ptr, uint64_t value,
   MOZ_RELEASE_ASSERT(false, "AVX2 not supported in this binary.");
 }
 
+const char* SIMD::memchr2OrBelow8AVX2(const char* ptr, char v1, char v2,
+                                      char limit, size_t length) {
+  MOZ_RELEASE_ASSERT(false, "AVX2 not supported in this binary.");
+}
+
+const char16_t* SIMD::memchr2OrBelow16AVX2(const char16_t* ptr, char16_t v1,
+                                           char16_t v2, char16_t limit,
+                                           size_t length) {
+  MOZ_RELEASE_ASSERT(false, "AVX2 not supported in this binary.");
+}
+
 }  // namespace mozilla
 
 #endif
@@ -81,7 +81,18 @@ StartupCache::CollectReports(nsIHandleReportCallback* aHandleReport,
   return NS_OK;
 }
 
-static const uint8_t MAGIC[] = "startupcache0002";
+static const uint8_t MAGIC[] = "startupcache0003";
+// Alignment of the file offset of entries stored with Storage::Mapped. The
+// mapping itself is page aligned, so this is also the alignment of the data in
+// memory, which JS bytecode requires when used in place.
+static const size_t STARTUP_CACHE_MAPPED_ALIGNMENT = 8;
+// Whether GetBuffer can return mapped entries in place. Windows does not allow
+// replacing a file which is still mapped, so such entries are copied there.
+#ifdef XP_WIN
+static const bool CAN_BORROW_MAPPED_ENTRIES = false;
+#else
+static const bool CAN_BORROW_MAPPED_ENTRIES = true;
+#endif
 // This is a heuristic value for how much to reserve for mTable to avoid
 // rehashing. This is not a hard limit in release builds, but it is in
 // debug builds as it should be stable. If we exceed this number we should
@@ -115,6 +126,17 @@ static nsresult MapLZ4ErrorToNsresult(size_t aError) {
   return NS_ERROR_FAILURE;
 }
 
+// Returns the offset, relative to the start of the entries, at which an entry
+// stored with Storage::Mapped following |aOffset| begins.
+static uint32_t AlignMappedEntryOffset(size_t aEntriesBaseOffset,
+                                       uint32_t aOffset) {
+  size_t fileOffset = aEntriesBaseOffset + aOffset;
+  size_t padding = (STARTUP_CACHE_MAPPED_ALIGNMENT -
+                    fileOffset % STARTUP_CACHE_MAPPED_ALIGNMENT) %
+                   STARTUP_CACHE_MAPPED_ALIGNMENT;
+  return aOffset + padding;
+}
+
 StartupCache* StartupCache::GetSingletonNoInit() {
   return StartupCache::gStartupCache;
 }
@@ -315,10 +337,12 @@ Result<Ok, nsresult> StartupCache::LoadArchive() {
       uint32_t offset = 0;
       uint32_t compressedSize = 0;
       uint32_t uncompressedSize = 0;
+      uint8_t storage = 0;
       nsCString key;
       buf.codeUint32(offset);
       buf.codeUint32(compressedSize);
       buf.codeUint32(uncompressedSize);
+      buf.codeUint8(storage);
       buf.codeString(key);
 
       if (offset + compressedSize > end - data) {
@@ -326,6 +350,19 @@ Result<Ok, nsresult> StartupCache::LoadArchive() {
         return Err(NS_ERROR_UNEXPECTED);
       }
 
+      if (storage > uint8_t(Storage::Mapped)) {
+        return Err(NS_ERROR_UNEXPECTED);
+      }
+      bool mapped = storage == uint8_t(Storage::Mapped);
+      if (mapped) {
+        // Mapped entries are stored as-is, after some padding.
+        if (compressedSize != uncompressedSize) {
+          return Err(NS_ERROR_UNEXPECTED);
+        }
+        currentOffset =
+            AlignMappedEntryOffset(mCacheEntriesBaseOffset, currentOffset);
+      }
+
       // Make sure offsets match what we'd expect based on script ordering and
       // size, as a basic sanity check.
       if (offset != currentOffset) {
@@ -343,7 +380,8 @@ Result<Ok, nsresult> StartupCache::LoadArchive() {
 
       if (!mTable.add(
               p, key,
-              StartupCacheEntry(offset, compressedSize, uncompressedSize))) {
+              StartupCacheEntry(offset, compressedSize, uncompressedSize,
+                                mapped))) {
         return Err(NS_ERROR_UNEXPECTED);
       }
     }
@@ -370,7 +408,7 @@ bool StartupCache::HasEntry(const char* id) {
 }
 
 nsresult StartupCache::GetBuffer(const char* id, const char** outbuf,
-                                 uint32_t* length)
+                                 uint32_t* length, bool* outMapped)
     MOZ_NO_THREAD_SAFETY_ANALYSIS {
   AUTO_PROFILER_LABEL("StartupCache::GetBuffer", OTHER);
 
@@ -388,8 +426,25 @@ nsresult StartupCache::GetBuffer(const char* id, const char** outbuf,
   }
 
   auto& value = p->value();
-  if (value.mData) {
+  // Mapped entries are only borrowed by callers that opt in by asking for
+  // |outMapped|. Reads from the mapping outside of the fault handler below
+  // crash on I/O errors, and such callers accept that risk.
+  bool borrow = outMapped && CAN_BORROW_MAPPED_ENTRIES;
+  if (value.mData || (value.mMappedData && borrow)) {
     label = glean::startup_cache::RequestsLabel::eHitmemory;
+  } else if (value.mMapped && borrow) {
+    if (!mCacheData.initialized()) {
+      return NS_ERROR_NOT_AVAILABLE;
+    }
+
+    // The caller may keep referencing the data for as long as it wants, so
+    // never unmap the file from now on. The cache file is only ever replaced
+    // by renaming a new file over it, see WriteToDisk, so the mapped pages
+    // remain valid.
+    mCacheData.setPersistent();
+    value.mMappedData =
+        mCacheData.get<char>().get() + mCacheEntriesBaseOffset + value.mOffset;
+    label = glean::startup_cache::RequestsLabel::eHitdisk;
   } else {
     if (!mCacheData.initialized()) {
       return NS_ERROR_NOT_AVAILABLE;
@@ -414,6 +469,11 @@ nsresult StartupCache::GetBuffer(const char* id, const char** outbuf,
     MMAP_FAULT_HANDLER_BEGIN_BUFFER(uncompressed.Elements(),
                                     uncompressed.Length())
     bool finished = false;
+    if (value.mMapped) {
+      memcpy(uncompressed.Elements(), compressed.Elements(),
+             uncompressed.Length());
+      finished = true;
+    }
     while (!finished) {
       auto result = mDecompressionContext->Decompress(
           uncompressed.From(totalWritten), compressed.From(totalRead));
@@ -445,13 +505,17 @@ nsresult StartupCache::GetBuffer(const char* id, const char** outbuf,
   // Track that something holds a reference into mTable, so we know to hold
   // onto it in case the cache is invalidated.
   mCurTableReferenced = true;
-  *outbuf = value.mData.get();
+  *outbuf = value.Data();
   *length = value.mUncompressedSize;
+  if (outMapped) {
+    *outMapped = !value.mData && value.mMappedData;
+  }
   return NS_OK;
 }
 
 nsresult StartupCache::PutBuffer(const char* id, UniqueFreePtr<char[]>&& inbuf,
-                                 uint32_t len) MOZ_NO_THREAD_SAFETY_ANALYSIS {
+                                 uint32_t len, Storage storage)
+    MOZ_NO_THREAD_SAFETY_ANALYSIS {
   NS_ASSERTION(NS_IsMainThread(),
                "Startup cache only available on main thread");
   if (StartupCache::gShutdownInitiated) {
@@ -475,8 +539,9 @@ nsresult StartupCache::PutBuffer(const char* id, UniqueFreePtr<char[]>&& inbuf,
   // putNew returns false on alloc failure - in the very unlikely event we hit
   // that and aren't going to crash elsewhere, there's no reason we need to
   // crash here.
-  if (mTable.putNew(nsCString(id), StartupCacheEntry(std::move(inbuf), len,
-                                                     ++mRequestedCount))) {
+  if (mTable.putNew(nsCString(id),
+                    StartupCacheEntry(std::move(inbuf), len, ++mRequestedCount,
+                                      storage == Storage::Mapped))) {
     return ResetStartupWriteTimer();
   }
   MOZ_DIAGNOSTIC_ASSERT(mTable.count() < STARTUP_CACHE_MAX_CAPACITY,
@@ -517,9 +582,24 @@ Result<Ok, nsresult> StartupCache::WriteToDisk() {
     return Err(NS_ERROR_UNEXPECTED);
   }
 
+  // Write to a new file which then replaces the cache file, instead of
+  // truncating the cache file, as mapped entries handed out by GetBuffer keep
+  // referencing the pages of the current file.
+  nsAutoString leafName;
+  MOZ_TRY(mFile->GetLeafName(leafName));
+  nsCOMPtr<nsIFile> newFile;
+  MOZ_TRY(mFile->Clone(getter_AddRefs(newFile)));
+  MOZ_TRY(newFile->SetLeafName(leafName + u"-new"_ns));
+
+  // Don't leave a partially written file behind if anything below fails.
   AutoFDClose raiiFd;
-  MOZ_TRY(mFile->OpenNSPRFileDesc(PR_WRONLY | PR_CREATE_FILE | PR_TRUNCATE,
-                                  0644, getter_Transfers(raiiFd)));
+  auto removeNewFile = MakeScopeExit([&]() {
+    raiiFd = nullptr;
+    (void)newFile->Remove(false);
+  });
+
+  MOZ_TRY(newFile->OpenNSPRFileDesc(PR_WRONLY | PR_CREATE_FILE | PR_TRUNCATE,
+                                    0644, getter_Transfers(raiiFd)));
   const auto fd = raiiFd.get();
 
   nsTArray<StartupCacheEntry::KeyValuePair> entries(mTable.count());
@@ -532,6 +612,9 @@ Result<Ok, nsresult> StartupCache::WriteToDisk() {
   }
 
   if (entries.IsEmpty()) {
+    raiiFd = nullptr;
+    MOZ_TRY(newFile->MoveTo(nullptr, leafName));
+    removeNewFile.release();
     return Ok();
   }
 
@@ -548,6 +631,8 @@ Result<Ok, nsresult> StartupCache::WriteToDisk() {
     buf.codeUint32(0);
     buf.codeUint32(0);
     buf.codeUint32(uncompressedSize);
+    buf.codeUint8(uint8_t(value->mMapped ? Storage::Mapped
+                                         : Storage::Compressed));
     buf.codeString(*key);
   }
 
@@ -573,6 +658,22 @@ Result<Ok, nsresult> StartupCache::WriteToDisk() {
 
   for (auto& e : entries) {
     auto value = e.second;
+
+    if (value->mMapped) {
+      static const char padding[STARTUP_CACHE_MAPPED_ALIGNMENT] = {};
+      uint32_t alignedOffset = AlignMappedEntryOffset(dataStart, offset);
+      if (alignedOffset != offset) {
+        MOZ_TRY(Write(fd, padding, alignedOffset - offset));
+      }
+      value->mOffset = alignedOffset;
+      if (value->mUncompressedSize) {
+        MOZ_TRY(Write(fd, value->Data(), value->mUncompressedSize));
+      }
+      offset = alignedOffset + value->mUncompressedSize;
+      value->mCompressedSize = value->mUncompressedSize;
+      continue;
+    }
+
     value->mOffset = offset;
     Span<const char> result =
         MOZ_TRY(ctx.BeginCompressing(writeSpan).mapErr(MapLZ4ErrorToNsresult));
@@ -581,7 +682,7 @@ Result<Ok, nsresult> StartupCache::WriteToDisk() {
 
     for (size_t i = 0; i < value->mUncompressedSize; i += chunkSize) {
       size_t size = std::min(chunkSize, value->mUncompressedSize - i);
-      char* uncompressed = value->mData.get() + i;
+      const char* uncompressed = value->Data() + i;
       result = MOZ_TRY(ctx.ContinueCompressing(Span(uncompressed, size))
                            .mapErr(MapLZ4ErrorToNsresult));
       MOZ_TRY(Write(fd, result.Elements(), result.Length()));
@@ -605,6 +706,10 @@ Result<Ok, nsresult> StartupCache::WriteToDisk() {
   MOZ_TRY(Seek(fd, headerStart));
   MOZ_TRY(Write(fd, buf.Get(), buf.cursor()));
 
+  raiiFd = nullptr;
+  MOZ_TRY(newFile->MoveTo(nullptr, leafName));
+  removeNewFile.release();
+
   mDirty = false;
   mWrittenOnce = true;
 
@@ -58,6 +58,14 @@
  * ensure any data already read from disk is discarded. The cache will not load
  * data from the disk file until a successful write occurs.
  *
+ * Buffers stored with StartupCache::Storage::Mapped are written uncompressed
+ * and suitably aligned in the cache file. GetBuffer() copies such entries out
+ * of the mapping without decompressing them. Callers that opt in can instead
+ * borrow them directly from the mapping of the file, which is then kept alive
+ * for the rest of the process lifetime. This is used for JS stencils, whose
+ * bytecode can then be used in place, see the
+ * javascript.options.startup_cache.pinned_bytecode pref.
+ *
  * Finally, getDebugObjectOutputStream() allows debug code to wrap an
  * objectstream with a debug objectstream, to check for multiply-referenced
  * objects. These will generally fail to deserialize correctly, unless they are
@@ -86,32 +94,44 @@ namespace scache {
 
 struct StartupCacheEntry {
   UniqueFreePtr<char[]> mData;
+  // For mapped entries which have been borrowed, the location of the data in
+  // the (persistent) mapping of the cache file. If the entry is later copied
+  // for a caller which does not borrow, mData is set too and takes precedence.
+  const char* mMappedData;
   uint32_t mOffset;
   uint32_t mCompressedSize;
   uint32_t mUncompressedSize;
   int32_t mHeaderOffsetInFile;
   int32_t mRequestedOrder;
   bool mRequested;
+  // Whether the entry is stored uncompressed in the cache file.
+  bool mMapped;
 
   MOZ_IMPLICIT StartupCacheEntry(uint32_t aOffset, uint32_t aCompressedSize,
-                                 uint32_t aUncompressedSize)
+                                 uint32_t aUncompressedSize, bool aMapped)
       : mData(nullptr),
+        mMappedData(nullptr),
         mOffset(aOffset),
         mCompressedSize(aCompressedSize),
         mUncompressedSize(aUncompressedSize),
         mHeaderOffsetInFile(0),
         mRequestedOrder(0),
-        mRequested(false) {}
+        mRequested(false),
+        mMapped(aMapped) {}
 
   StartupCacheEntry(UniqueFreePtr<char[]> aData, size_t aLength,
-                    int32_t aRequestedOrder)
+                    int32_t aRequestedOrder, bool aMapped)
       : mData(std::move(aData)),
+        mMappedData(nullptr),
         mOffset(0),
         mCompressedSize(0),
         mUncompressedSize(aLength),
         mHeaderOffsetInFile(0),
         mRequestedOrder(0),
-        mRequested(true) {}
+        mRequested(true),
+        mMapped(aMapped) {}
+
+  const char* Data() const { return mData ? mData.get() : mMappedData; }
 
   // std::pair is not trivially move assignable/constructible, so make our own.
   struct KeyValuePair {
@@ -153,15 +173,34 @@ class StartupCache : public nsIMemoryReporter {
 
   // StartupCache methods. See above comments for a more detailed description.
 
+  // How a buffer is stored in the cache file.
+  enum class Storage : uint8_t {
+    // LZ4 compressed, and decompressed into memory when requested.
+    Compressed,
+    // Uncompressed and aligned, and read in place from the mapping of the
+    // cache file when requested.
+    Mapped,
+  };
+
   // true if the archive has an entry for the buffer or not.
   bool HasEntry(const char* id);
 
-  // Returns a buffer that was previously stored, caller does not take ownership
-  nsresult GetBuffer(const char* id, const char** outbuf, uint32_t* length);
+  // Returns a buffer that was previously stored, caller does not take
+  // ownership.
+  //
+  // By default, entries stored with Storage::Mapped are copied out of the
+  // mapping of the cache file, within a fault handler. Passing a non-null
+  // |outMapped| opts in to borrowing them from the mapping instead, in which
+  // case |outMapped| is set to whether the buffer lives in the mapping, which
+  // then remains alive until the process exits. Borrowed data is read without
+  // any fault handler, so an I/O error on the cache file crashes the process
+  // wherever the data is accessed.
+  nsresult GetBuffer(const char* id, const char** outbuf, uint32_t* length,
+                     bool* outMapped = nullptr);
 
   // Stores a buffer. Caller yields ownership.
   nsresult PutBuffer(const char* id, UniqueFreePtr<char[]>&& inbuf,
-                     uint32_t length);
+                     uint32_t length, Storage storage = Storage::Compressed);
 
   // Removes the cache file.
   void InvalidateCache(bool memoryOnly = false);
@@ -0,0 +1,131 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/* vim: set ts=8 sts=2 et sw=2 tw=80: */
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+
+#include "gtest/gtest.h"
+#include "mozilla/gtest/MozAssertions.h"
+#include "mozilla/MemoryChecking.h"
+#include "mozilla/Printf.h"
+#include "mozilla/scache/StartupCache.h"
+#include "mozilla/UniquePtrExtensions.h"
+#include "nsDirectoryServiceDefs.h"
+#include "nsDirectoryServiceUtils.h"
+#include "nsIFile.h"
+#include "nsString.h"
+#include "prenv.h"
+
+using namespace mozilla;
+using namespace mozilla::scache;
+
+using Storage = StartupCache::Storage;
+
+static const char kMappedData[] = "Entry stored uncompressed and mapped";
+static const char kCompressedData[] = "Entry stored LZ4 compressed";
+
+class TestStartupCacheMapped : public ::testing::Test {
+ protected:
+  TestStartupCacheMapped() {
+    NS_GetSpecialDirectory(NS_OS_TEMP_DIR, getter_AddRefs(mFile));
+    mFile->AppendNative("test-startupcache-mapped.tmp"_ns);
+    nsAutoCString path;
+    mFile->GetNativePath(path);
+    // PR_SetEnv keeps referencing the string, so it is leaked on purpose.
+    char* env = Smprintf("MOZ_STARTUP_CACHE=%s", path.get()).release();
+    PR_SetEnv(env);
+    MOZ_LSAN_INTENTIONALLY_LEAK_OBJECT(env);
+    StartupCache::GetSingleton()->InvalidateCache();
+  }
+
+  ~TestStartupCacheMapped() {
+    PR_SetEnv("MOZ_STARTUP_CACHE=");
+    StartupCache::GetSingleton()->InvalidateCache();
+  }
+
+  static nsresult Put(const char* id, const char* data, Storage storage) {
+    return StartupCache::GetSingleton()->PutBuffer(
+        id, UniqueFreePtr<char[]>(strdup(data)), strlen(data) + 1, storage);
+  }
+
+  // Writes the cache file and loads the entries back from it.
+  static void WriteAndReload() {
+    StartupCache::GetSingleton()->InvalidateCache(/* memoryOnly = */ true);
+  }
+
+  bool TempFileExists() {
+    nsCOMPtr<nsIFile> file;
+    mFile->Clone(getter_AddRefs(file));
+    nsAutoString leafName;
+    file->GetLeafName(leafName);
+    file->SetLeafName(leafName + u"-new"_ns);
+    bool exists = false;
+    file->Exists(&exists);
+    return exists;
+  }
+
+  nsCOMPtr<nsIFile> mFile;
+};
+
+TEST_F(TestStartupCacheMapped, WriteRead) {
+  StartupCache* sc = StartupCache::GetSingleton();
+  EXPECT_NS_SUCCEEDED(Put("borrowed", kMappedData, Storage::Mapped));
+  EXPECT_NS_SUCCEEDED(Put("copied", kMappedData, Storage::Mapped));
+  EXPECT_NS_SUCCEEDED(Put("compressed", kCompressedData, Storage::Compressed));
+
+  WriteAndReload();
+  EXPECT_FALSE(TempFileExists());
+
+  const char* buf;
+  uint32_t len;
+  bool mapped;
+
+  // Opting in borrows the entry from the mapping of the cache file, except on
+  // Windows where mapped entries are always copied.
+  EXPECT_NS_SUCCEEDED(sc->GetBuffer("borrowed", &buf, &len, &mapped));
+  EXPECT_EQ(len, sizeof(kMappedData));
+  EXPECT_STREQ(buf, kMappedData);
+#ifdef XP_WIN
+  EXPECT_FALSE(mapped);
+#else
+  EXPECT_TRUE(mapped);
+  EXPECT_EQ(uintptr_t(buf) % 8, 0u);
+#endif
+
+  // By default mapped entries are copied out of the mapping.
+  EXPECT_NS_SUCCEEDED(sc->GetBuffer("copied", &buf, &len));
+  EXPECT_EQ(len, sizeof(kMappedData));
+  EXPECT_STREQ(buf, kMappedData);
+
+  // Compressed entries are never borrowed.
+  EXPECT_NS_SUCCEEDED(sc->GetBuffer("compressed", &buf, &len, &mapped));
+  EXPECT_FALSE(mapped);
+  EXPECT_EQ(len, sizeof(kCompressedData));
+  EXPECT_STREQ(buf, kCompressedData);
+}
+
+// Rewriting the cache file replaces it instead of truncating it, so borrowed
+// entries stay readable.
+TEST_F(TestStartupCacheMapped, RewriteKeepsBorrowedEntries) {
+  StartupCache* sc = StartupCache::GetSingleton();
+  EXPECT_NS_SUCCEEDED(Put("borrowed", kMappedData, Storage::Mapped));
+  WriteAndReload();
+
+  const char* borrowed;
+  uint32_t len;
+  bool mapped;
+  EXPECT_NS_SUCCEEDED(sc->GetBuffer("borrowed", &borrowed, &len, &mapped));
+  EXPECT_STREQ(borrowed, kMappedData);
+
+  EXPECT_NS_SUCCEEDED(Put("other", kCompressedData, Storage::Compressed));
+  WriteAndReload();
+  EXPECT_FALSE(TempFileExists());
+  EXPECT_STREQ(borrowed, kMappedData);
+
+  const char* buf;
+  EXPECT_NS_SUCCEEDED(sc->GetBuffer("borrowed", &buf, &len, &mapped));
+  EXPECT_EQ(len, sizeof(kMappedData));
+  EXPECT_STREQ(buf, kMappedData);
+}